@@ -528,6 +528,7 @@ namespace polyfem
 		bases.clear();
 		pressure_bases.clear();
 		geom_bases_.clear();
+		element_ordering = nullptr;
 		boundary_nodes.clear();
 		dirichlet_nodes.clear();
 		neumann_nodes.clear();
@@ -540,6 +541,7 @@ namespace polyfem
 		poly_edge_to_data.clear();
 		rhs.resize(0, 0);
 		basis_nodes_to_gbasis_nodes.resize(0, 0);
+		out_geom.clear_vis_mesh_cache();
 
 		if (assembler::MultiModel *mm = dynamic_cast<assembler::MultiModel *>(assembler.get()))
 		{
@@ -1054,6 +1056,14 @@ namespace polyfem
 			logger().info(" took {}s", timer.getElapsedTime());
 		}
 
+		timer.start();
+		element_ordering = std::make_shared<mesh::ElementOrdering>();
+		element_ordering->build(*mesh, bases, args["solver"]["advanced"]["element_ordering"]);
+		// the coloring is only valid for the displacement bases, the pressure cache keeps the input order
+		ass_vals_cache.set_element_ordering(element_ordering);
+		mass_ass_vals_cache.set_element_ordering(element_ordering);
+		logger().debug("Element ordering took {}s", timer.getElapsedTime());
+
 		out_geom.build_grid(*mesh, args["output"]["advanced"]["sol_on_grid"]);
 
 		if ((!problem->is_time_dependent() || args["time"]["quasistatic"]) && boundary_nodes.empty())
@@ -1516,6 +1526,8 @@ namespace polyfem
 		timer.start();
 		logger().info("Assembling mass mat...");
 
+		mass_matrix_assembler->update_material_cache(mesh->is_volume(), bases, geom_bases(), mass_ass_vals_cache, 0);
+
 		if (mixed_assembler != nullptr)
 		{
 			StiffnessMatrix velocity_mass;
@@ -1728,6 +1740,8 @@ namespace polyfem
 				solve_transient_navier_stokes_split(time_steps, dt, sol, pressure);
 			else if (is_homogenization())
 				solve_homogenization(time_steps, t0, dt, sol);
+			else if (is_explicit_time_integration())
+				solve_transient_tensor_explicit(time_steps, t0, dt, sol);
 			else if (is_problem_linear())
 				solve_transient_linear(time_steps, t0, dt, sol, pressure);
 			else if (!assembler->is_linear() && problem->is_scalar())
@@ -1759,10 +1773,16 @@ namespace polyfem
 
 				const std::string state_path = resolve_output_path(args["output"]["data"]["state"]);
 				if (!state_path.empty())
+				{
+					wait_for_hdf5_writes();
 					write_matrix(state_path, "u", sol);
+				}
 			}
 		}
 
+		// wait for the time steps still being written in the background
+		out_geom.flush();
+
 		timer.stop();
 		timings.solving_time = timer.getElapsedTime();
 		logger().info(" took {}s", timings.solving_time);
@@ -17,6 +17,7 @@
 #include <polyfem/assembler/AssemblerUtils.hpp>
 
 #include <polyfem/mesh/Mesh.hpp>
+#include <polyfem/mesh/ElementOrdering.hpp>
 #include <polyfem/mesh/Obstacle.hpp>
 #include <polyfem/mesh/MeshNodes.hpp>
 #include <polyfem/mesh/LocalBoundary.hpp>
@@ -30,6 +31,7 @@
 #include <polyfem/utils/Logger.hpp>
 #include <polyfem/assembler/PeriodicBoundary.hpp>
 
+#include <polyfem/io/Checkpoint.hpp>
 #include <polyfem/io/OutData.hpp>
 
 #include <polysolve/linear/Solver.hpp>
@@ -173,6 +175,8 @@ namespace polyfem
 		std::vector<basis::ElementBases> pressure_bases;
 		/// Geometric mapping bases, if the elements are isoparametric, this list is empty
 		std::vector<basis::ElementBases> geom_bases_;
+		/// order and coloring of the elements used by the assembly loops, rebuilt with the bases
+		std::shared_ptr<mesh::ElementOrdering> element_ordering;
 
 		/// number of bases
 		int n_bases;
@@ -352,6 +356,12 @@ namespace polyfem
 		/// @param[in] dt timestep size
 		/// @param[out] sol solution
 		void solve_transient_tensor_nonlinear(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol);
+		/// solves transient tensor problem with an explicit time integrator and a lumped mass matrix
+		/// @param[in] time_steps number of time steps
+		/// @param[in] t0 initial times
+		/// @param[in] dt timestep size
+		/// @param[out] sol solution
+		void solve_transient_tensor_explicit(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol);
 		/// initialize the nonlinear solver
 		/// @param[out] sol solution
 		/// @param[in] t (optional) initial time
@@ -380,6 +390,9 @@ namespace polyfem
 		/// @param[out] sol solution
 		/// @param[in] t (optional) time step id
 		void solve_tensor_nonlinear(Eigen::MatrixXd &sol, const int t = 0, const bool init_lagging = true);
+		/// extrapolates the previous time step(s) to get the initial guess of the next nonlinear solve
+		/// @param[in,out] sol previous solution, replaced by the predicted one
+		void predict_time_step(Eigen::MatrixXd &sol);
 
 		/// factory to create the nl solver depending on input
 		/// @return nonlinear solver (eg newton or LBFGS)
@@ -409,6 +422,9 @@ namespace polyfem
 		/// @brief Returns whether the system is linear. Collisions and pressure add nonlinearity to the problem.
 		bool is_problem_linear() const { return assembler->is_linear() && !is_contact_enabled() && !is_pressure_enabled(); }
 
+		/// @brief Returns whether the transient problem is integrated explicitly (i.e., without nonlinear solves).
+		bool is_explicit_time_integration() const;
+
 	public:
 		/// @brief utility that builds the stiffness matrix and collects stats, used only for linear problems
 		/// @param[out] stiffness matrix
@@ -624,6 +640,23 @@ namespace polyfem
 		/// @param t current time to restart at
 		void save_restart_json(const double t0, const double dt, const int t) const;
 
+		/// @brief Save the state (time integrator history and solver state) used to restart the simulation at time t.
+		/// Paths with the .ckpt extension are written as checkpoints, otherwise the time integrator saves x, v, and a.
+		/// @param integrator time integrator to save
+		/// @param t current time step
+		void save_state(const time_integrator::ImplicitTimeIntegrator &integrator, const int t);
+
+		/// @brief Wait for the queued output writes if they use HDF5, before writing HDF5 on the calling thread
+		/// (the HDF5 library is not thread safe)
+		void wait_for_hdf5_writes() const;
+
+		/// last checkpoint written by save_state, base of the next delta checkpoint (empty if checkpoint_full_interval <= 1)
+		io::Checkpoint last_checkpoint;
+		/// path of last_checkpoint
+		std::string last_checkpoint_path;
+		/// number of delta checkpoints written since the last full checkpoint
+		int n_delta_checkpoints = 0;
+
 		//-----------PATH management
 		/// Get the root path for the state (e.g., args["root_path"] or ".")
 		/// @return root path
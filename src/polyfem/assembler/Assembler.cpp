@@ -20,6 +20,7 @@ namespace polyfem::assembler
 		public:
 			std::unique_ptr<MatrixCache> cache = nullptr;
 			ElementAssemblyValues vals;
+			ElementAssemblyValues psi_vals; ///< scalar space values for mixed assembly
 			QuadratureVector da;
 
 			LocalThreadMatStorage() = delete;
@@ -34,8 +35,15 @@ namespace polyfem::assembler
 				init(buffer_size, c);
 			}
 
+			LocalThreadMatStorage(SparseMatrixCache &c, const bool use_atomic)
+			{
+				auto shared_cache = std::make_unique<SparseMatrixCache>();
+				shared_cache->init_shared(c, use_atomic);
+				cache = std::move(shared_cache);
+			}
+
 			LocalThreadMatStorage(const LocalThreadMatStorage &other)
-				: cache(other.cache->copy()), vals(other.vals), da(other.da)
+				: cache(other.cache->copy()), vals(other.vals), psi_vals(other.psi_vals), da(other.da)
 			{
 			}
 
@@ -44,6 +52,7 @@ namespace polyfem::assembler
 				assert(other.cache != nullptr);
 				cache = other.cache->copy();
 				vals = other.vals;
+				psi_vals = other.psi_vals;
 				da = other.da;
 				return *this;
 			}
@@ -80,6 +89,22 @@ namespace polyfem::assembler
 			}
 		};
 
+		class LocalThreadScalarVecStorage
+		{
+		public:
+			double val;
+			Eigen::MatrixXd vec;
+			ElementAssemblyValues vals;
+			QuadratureVector da;
+
+			LocalThreadScalarVecStorage(const int size)
+			{
+				val = 0;
+				vec.resize(size, 1);
+				vec.setZero();
+			}
+		};
+
 		class LocalThreadScalarStorage
 		{
 		public:
@@ -92,6 +117,71 @@ namespace polyfem::assembler
 				val = 0;
 			}
 		};
+
+		/// calls assemble_element(e, local_storage) for every element, which adds the local matrix of e to local_storage.cache
+		/// the elements are visited in the order (and with the coloring) of the element ordering of cache, if any
+		/// once mat_cache knows its sparsity pattern, the threads scatter directly into its values without any local matrix:
+		/// one color of independent elements at a time, or with atomic adds if the elements could not be colored;
+		/// otherwise every thread fills its own cache and they are merged serially in mat_cache
+		template <typename AssembleElement>
+		void assemble_elements(const int n_elements, const int buffer_size, const AssemblyValsCache &cache, MatrixCache &mat_cache, AssembleElement &&assemble_element)
+		{
+			igl::Timer timer;
+			timer.start();
+
+			SparseMatrixCache *sparse_cache = dynamic_cast<SparseMatrixCache *>(&mat_cache);
+			if (sparse_cache != nullptr && sparse_cache->has_mapping())
+			{
+				const mesh::ElementOrdering *ordering = cache.element_ordering();
+				const std::vector<std::vector<int>> &colors = (ordering != nullptr && !ordering->colors().empty()) ? ordering->colors() : sparse_cache->element_colors();
+				auto storage = create_thread_storage(LocalThreadMatStorage(*sparse_cache, colors.empty()));
+
+				if (colors.empty())
+				{
+					maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+						LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
+						for (int k = start; k < end; ++k)
+							assemble_element(cache.ordered_element(k), local_storage);
+					});
+				}
+				else
+				{
+					for (const std::vector<int> &color : colors)
+					{
+						maybe_parallel_for(color.size(), [&](int start, int end, int thread_id) {
+							LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
+							for (int k = start; k < end; ++k)
+								assemble_element(color[k], local_storage);
+						});
+					}
+				}
+
+				timer.stop();
+				logger().trace("done shared assembly ({} colors) {}s...", colors.size(), timer.getElapsedTime());
+				return;
+			}
+
+			auto storage = create_thread_storage(LocalThreadMatStorage(buffer_size, mat_cache));
+
+			maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+				LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
+				for (int k = start; k < end; ++k)
+					assemble_element(cache.ordered_element(k), local_storage);
+			});
+
+			timer.stop();
+			logger().trace("done separate assembly {}s...", timer.getElapsedTime());
+
+			timer.start();
+			// Serially merge local storages
+			for (LocalThreadMatStorage &local_storage : storage)
+			{
+				local_storage.cache->prune();
+				mat_cache += *local_storage.cache;
+			}
+			timer.stop();
+			logger().trace("done merge assembly {}s...", timer.getElapsedTime());
+		}
 	} // namespace
 
 	void Assembler::set_materials(const std::vector<int> &body_ids, const json &body_params, const Units &units)
@@ -150,6 +240,21 @@ namespace polyfem::assembler
 		}
 	}
 
+	SparseMatrixCache &AssemblyPatternCache::get(const std::vector<size_t> &key, const int rows, const int cols)
+	{
+		if (mat_cache_ == nullptr || key != key_)
+		{
+			if (mat_cache_ != nullptr)
+				logger().trace("Assembly pattern changed, recomputing it");
+			key_ = key;
+			mat_cache_ = std::make_unique<SparseMatrixCache>();
+		}
+
+		mat_cache_->init(rows, cols);
+		mat_cache_->set_zero();
+		return *mat_cache_;
+	}
+
 	LinearAssembler::LinearAssembler()
 	{
 	}
@@ -174,208 +279,92 @@ namespace polyfem::assembler
 		// logger().trace("buffer_size {}", buffer_size);
 		try
 		{
-			stiffness.resize(n_basis * size(), n_basis * size());
-			stiffness.setZero();
-
-			auto storage = create_thread_storage(LocalThreadMatStorage(buffer_size, stiffness.rows(), stiffness.cols()));
+			// the pattern only depends on the elements and the space, values are written in place when it is reused
+			SparseMatrixCache &mat_cache = pattern_cache_.get(
+				{cache.id(), bases.size(), size_t(n_basis), size_t(size()), size_t(is_mass)},
+				n_basis * size(), n_basis * size());
 
 			const int n_bases = int(bases.size());
-			igl::Timer timer;
-			timer.start();
 			assert(cache.is_mass() == is_mass);
 
 			// (potentially parallel) loop over elements
 			// Note that n_bases is the number of elements since ach ElementBases object stores
 			// all local basis functions on a given element
-			maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
-				LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
+			assemble_elements(n_bases, buffer_size, cache, mat_cache, [&](const int e, LocalThreadMatStorage &local_storage) {
+				// igl::Timer timer; timer.start();
+				// vals.compute(e, is_volume, bases[e], gbases[e]);
 
-				for (int e = start; e < end; ++e)
-				{
-					ElementAssemblyValues &vals = local_storage.vals;
-					// igl::Timer timer; timer.start();
-					// vals.compute(e, is_volume, bases[e], gbases[e]);
+				// compute geometric mapping
+				// evaluate and store basis functions/their gradients at quadrature points
+				const ElementAssemblyValues &vals = cache.get(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
-					// compute geometric mapping
-					// evaluate and store basis functions/their gradients at quadrature points
-					cache.compute(e, is_volume, bases[e], gbases[e], vals);
+				const Quadrature &quadrature = vals.quadrature;
 
-					const Quadrature &quadrature = vals.quadrature;
+				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+				local_storage.da = vals.det.array() * quadrature.weights.array();
+				const int n_loc_bases = int(vals.basis_values.size());
 
-					assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
-					local_storage.da = vals.det.array() * quadrature.weights.array();
-					const int n_loc_bases = int(vals.basis_values.size());
+				for (int i = 0; i < n_loc_bases; ++i)
+				{
+					// const AssemblyValues &values_i = vals.basis_values[i];
+					// const Eigen::MatrixXd &gradi = values_i.grad_t_m;
 
-					for (int i = 0; i < n_loc_bases; ++i)
+					// loop over other bases up to the current one, taking advantage of symmetry
+					for (int j = 0; j <= i; ++j)
 					{
-						// const AssemblyValues &values_i = vals.basis_values[i];
-						// const Eigen::MatrixXd &gradi = values_i.grad_t_m;
-						const auto &global_i = vals.basis_values[i].global;
+						// const AssemblyValues &values_j = vals.basis_values[j];
+						// const Eigen::MatrixXd &gradj = values_j.grad_t_m;
+
+						// compute local entry in stiffness matrix
+						const auto stiffness_val = assemble(LinearAssemblerData(vals, t, i, j, local_storage.da));
+						assert(stiffness_val.size() == size() * size());
 
-						// loop over other bases up to the current one, taking advantage of symmetry
-						for (int j = 0; j <= i; ++j)
+						// igl::Timer t1; t1.start();
+						// loop over dimensions of the problem
+						for (int n = 0; n < size(); ++n)
 						{
-							// const AssemblyValues &values_j = vals.basis_values[j];
-							// const Eigen::MatrixXd &gradj = values_j.grad_t_m;
-							const auto &global_j = vals.basis_values[j].global;
+							for (int m = 0; m < size(); ++m)
+							{
+								const double local_value = stiffness_val(n * size() + m);
 
-							// compute local entry in stiffness matrix
-							const auto stiffness_val = assemble(LinearAssemblerData(vals, t, i, j, local_storage.da));
-							assert(stiffness_val.size() == size() * size());
+								// loop over the global nodes corresponding to local element (useful for non-conforming cases)
+								vals.for_each_global(i, [&](const int index_i, const double wi) {
+									const auto gi = index_i * size() + m;
 
-							// igl::Timer t1; t1.start();
-							// loop over dimensions of the problem
-							for (int n = 0; n < size(); ++n)
-							{
-								for (int m = 0; m < size(); ++m)
-								{
-									const double local_value = stiffness_val(n * size() + m);
+									vals.for_each_global(j, [&](const int index_j, const double wj) {
+										const auto gj = index_j * size() + n;
 
-									// loop over the global nodes corresponding to local element (useful for non-conforming cases)
-									for (size_t ii = 0; ii < global_i.size(); ++ii)
-									{
-										const auto gi = global_i[ii].index * size() + m;
-										const auto wi = global_i[ii].val;
+										// add local value to the global matrix (weighted by corresponding nodes)
+										local_storage.cache->add_value(e, gi, gj, local_value * wi * wj);
+										if (j < i)
+										{
+											local_storage.cache->add_value(e, gj, gi, local_value * wj * wi);
+										}
 
-										for (size_t jj = 0; jj < global_j.size(); ++jj)
+										if (local_storage.cache->entries_size() >= max_triplets_size)
 										{
-											const auto gj = global_j[jj].index * size() + n;
-											const auto wj = global_j[jj].val;
-
-											// add local value to the global matrix (weighted by corresponding nodes)
-											local_storage.cache->add_value(e, gi, gj, local_value * wi * wj);
-											if (j < i)
-											{
-												local_storage.cache->add_value(e, gj, gi, local_value * wj * wi);
-											}
-
-											if (local_storage.cache->entries_size() >= max_triplets_size)
-											{
-												local_storage.cache->prune();
-												logger().trace("cleaning memory. Current storage: {}. mat nnz: {}", local_storage.cache->capacity(), local_storage.cache->non_zeros());
-											}
+											local_storage.cache->prune();
+											logger().trace("cleaning memory. Current storage: {}. mat nnz: {}", local_storage.cache->capacity(), local_storage.cache->non_zeros());
 										}
-									}
-								}
+									});
+								});
 							}
-
-							// t1.stop();
-							// if (!vals.has_parameterization) { std::cout << "-- t1: " << t1.getElapsedTime() << std::endl; }
 						}
-					}
 
-					// timer.stop();
-					// if (!vals.has_parameterization) { std::cout << "-- Timer: " << timer.getElapsedTime() << std::endl; }
+						// t1.stop();
+						// if (!vals.has_parameterization) { std::cout << "-- t1: " << t1.getElapsedTime() << std::endl; }
+					}
 				}
-			});
-
-			timer.stop();
-			logger().trace("done separate assembly {}s...", timer.getElapsedTime());
-
-			// Assemble the stiffness matrix by concatenating the tuples in each local storage
 
-			// Collect thread storages
-			std::vector<LocalThreadMatStorage *> storages(storage.size());
-			long int index = 0;
-			for (auto &local_storage : storage)
-			{
-				storages[index++] = &local_storage;
-			}
-
-			timer.start();
-			maybe_parallel_for(storages.size(), [&](int i) {
-				storages[i]->cache->prune();
+				// timer.stop();
+				// if (!vals.has_parameterization) { std::cout << "-- Timer: " << timer.getElapsedTime() << std::endl; }
 			});
-			timer.stop();
-			logger().trace("done pruning triplets {}s...", timer.getElapsedTime());
-
-			// Prepares for parallel concatenation
-			std::vector<long int> offsets(storage.size());
-
-			index = 0;
-			long int triplet_count = 0;
-			for (auto &local_storage : storage)
-			{
-				offsets[index++] = triplet_count;
-				triplet_count += local_storage.cache->triplet_count();
-			}
-
-			std::vector<Eigen::Triplet<double>> triplets;
-
-			assert(storages.size() >= 1);
-			if (storages[0]->cache->is_dense())
-			{
-				timer.start();
-				// Serially merge local storages
-				Eigen::MatrixXd tmp(stiffness);
-				for (const LocalThreadMatStorage &local_storage : storage)
-					tmp += dynamic_cast<const DenseMatrixCache &>(*local_storage.cache).mat();
-				stiffness = tmp.sparseView();
-				stiffness.makeCompressed();
-				timer.stop();
-
-				logger().trace("Serial assembly time: {}s...", timer.getElapsedTime());
-			}
-			else if (triplet_count >= triplets.max_size())
-			{
-				// Serial fallback version in case the vector of triplets cannot be allocated
-
-				logger().warn("Cannot allocate space for triplets, switching to serial assembly.");
-
-				timer.start();
-				// Serially merge local storages
-				for (LocalThreadMatStorage &local_storage : storage)
-					stiffness += local_storage.cache->get_matrix(false); // will also prune
-				stiffness.makeCompressed();
-				timer.stop();
-
-				logger().trace("Serial assembly time: {}s...", timer.getElapsedTime());
-			}
-			else
-			{
-				timer.start();
-				triplets.resize(triplet_count);
-				timer.stop();
-
-				logger().trace("done allocate triplets {}s...", timer.getElapsedTime());
-				logger().trace("Triplets Count: {}", triplet_count);
-
-				timer.start();
-				// Parallel copy into triplets
-				maybe_parallel_for(storages.size(), [&](int i) {
-					const SparseMatrixCache &cache = dynamic_cast<const SparseMatrixCache &>(*storages[i]->cache);
-					long int offset = offsets[i];
 
-					std::copy(cache.entries().begin(), cache.entries().end(), triplets.begin() + offset);
-					offset += cache.entries().size();
-
-					if (cache.mat().nonZeros() > 0)
-					{
-						long int count = 0;
-						for (int k = 0; k < cache.mat().outerSize(); ++k)
-						{
-							for (Eigen::SparseMatrix<double>::InnerIterator it(cache.mat(), k); it; ++it)
-							{
-								assert(count < cache.mat().nonZeros());
-								triplets[offset + count++] = Eigen::Triplet<double>(it.row(), it.col(), it.value());
-							}
-						}
-					}
-				});
-
-				timer.stop();
-				logger().trace("done concatenate triplets {}s...", timer.getElapsedTime());
-
-				timer.start();
-				// Sort and assemble
-				stiffness.setFromTriplets(triplets.begin(), triplets.end());
-				timer.stop();
-
-				logger().trace("done setFromTriplets assembly {}s...", timer.getElapsedTime());
-			}
+			stiffness = mat_cache.get_matrix();
 		}
 		catch (std::bad_alloc &ba)
 		{
+			pattern_cache_.clear();
 			log_and_throw_error("bad alloc {}", ba.what());
 		}
 
@@ -406,68 +395,59 @@ namespace polyfem::assembler
 		const int buffer_size = std::min(long(max_triplets_size), long(std::max(n_psi_basis, n_phi_basis)) * std::max(rows(), cols()));
 		// logger().debug("buffer_size {}", buffer_size);
 
-		stiffness.resize(n_phi_basis * rows(), n_psi_basis * cols());
-		stiffness.setZero();
-
-		auto storage = create_thread_storage(LocalThreadMatStorage(buffer_size, stiffness.rows(), stiffness.cols()));
+		SparseMatrixCache &mat_cache = pattern_cache_.get(
+			{psi_cache.id(), phi_cache.id(), phi_bases.size(), size_t(n_psi_basis), size_t(n_phi_basis), size_t(rows()), size_t(cols())},
+			n_phi_basis * rows(), n_psi_basis * cols());
 
 		const int n_bases = int(phi_bases.size());
-		igl::Timer timer;
-		timer.start();
 
-		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
-			LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
-			ElementAssemblyValues psi_vals, phi_vals;
+		assemble_elements(n_bases, buffer_size, phi_cache, mat_cache, [&](const int e, LocalThreadMatStorage &local_storage) {
+			// psi_vals.compute(e, is_volume, psi_bases[e], gbases[e]);
+			// phi_vals.compute(e, is_volume, phi_bases[e], gbases[e]);
+			const ElementAssemblyValues &psi_vals = psi_cache.get(e, is_volume, psi_bases[e], gbases[e], local_storage.psi_vals);
+			const ElementAssemblyValues &phi_vals = phi_cache.get(e, is_volume, phi_bases[e], gbases[e], local_storage.vals);
 
-			for (int e = start; e < end; ++e)
-			{
-				// psi_vals.compute(e, is_volume, psi_bases[e], gbases[e]);
-				// phi_vals.compute(e, is_volume, phi_bases[e], gbases[e]);
-				psi_cache.compute(e, is_volume, psi_bases[e], gbases[e], psi_vals);
-				phi_cache.compute(e, is_volume, phi_bases[e], gbases[e], phi_vals);
+			const Quadrature &quadrature = phi_vals.quadrature;
 
-				const Quadrature &quadrature = phi_vals.quadrature;
+			assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+			local_storage.da = phi_vals.det.array() * quadrature.weights.array();
+			const int n_phi_loc_bases = int(phi_vals.basis_values.size());
+			const int n_psi_loc_bases = int(psi_vals.basis_values.size());
 
-				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
-				local_storage.da = phi_vals.det.array() * quadrature.weights.array();
-				const int n_phi_loc_bases = int(phi_vals.basis_values.size());
-				const int n_psi_loc_bases = int(psi_vals.basis_values.size());
+			for (int i = 0; i < n_psi_loc_bases; ++i)
+			{
+				const auto &global_i = psi_vals.basis_values[i].global;
 
-				for (int i = 0; i < n_psi_loc_bases; ++i)
+				for (int j = 0; j < n_phi_loc_bases; ++j)
 				{
-					const auto &global_i = psi_vals.basis_values[i].global;
-
-					for (int j = 0; j < n_phi_loc_bases; ++j)
-					{
-						const auto &global_j = phi_vals.basis_values[j].global;
+					const auto &global_j = phi_vals.basis_values[j].global;
 
-						const auto stiffness_val = assemble(MixedAssemblerData(psi_vals, phi_vals, t, i, j, local_storage.da));
-						assert(stiffness_val.size() == rows() * cols());
+					const auto stiffness_val = assemble(MixedAssemblerData(psi_vals, phi_vals, t, i, j, local_storage.da));
+					assert(stiffness_val.size() == rows() * cols());
 
-						// igl::Timer t1; t1.start();
-						for (int n = 0; n < rows(); ++n)
+					// igl::Timer t1; t1.start();
+					for (int n = 0; n < rows(); ++n)
+					{
+						for (int m = 0; m < cols(); ++m)
 						{
-							for (int m = 0; m < cols(); ++m)
+							const double local_value = stiffness_val(n * cols() + m);
+
+							for (size_t ii = 0; ii < global_i.size(); ++ii)
 							{
-								const double local_value = stiffness_val(n * cols() + m);
+								const auto gi = global_i[ii].index * cols() + m;
+								const auto wi = global_i[ii].val;
 
-								for (size_t ii = 0; ii < global_i.size(); ++ii)
+								for (size_t jj = 0; jj < global_j.size(); ++jj)
 								{
-									const auto gi = global_i[ii].index * cols() + m;
-									const auto wi = global_i[ii].val;
+									const auto gj = global_j[jj].index * rows() + n;
+									const auto wj = global_j[jj].val;
 
-									for (size_t jj = 0; jj < global_j.size(); ++jj)
-									{
-										const auto gj = global_j[jj].index * rows() + n;
-										const auto wj = global_j[jj].val;
-
-										local_storage.cache->add_value(e, gj, gi, local_value * wi * wj);
+									local_storage.cache->add_value(e, gj, gi, local_value * wi * wj);
 
-										if (local_storage.cache->entries_size() >= max_triplets_size)
-										{
-											local_storage.cache->prune();
-											logger().debug("cleaning memory...");
-										}
+									if (local_storage.cache->entries_size() >= max_triplets_size)
+									{
+										local_storage.cache->prune();
+										logger().debug("cleaning memory...");
 									}
 								}
 							}
@@ -477,16 +457,7 @@ namespace polyfem::assembler
 			}
 		});
 
-		timer.stop();
-		logger().trace("done separate assembly {}s...", timer.getElapsedTime());
-
-		timer.start();
-		// Serially merge local storages
-		for (LocalThreadMatStorage &local_storage : storage)
-			stiffness += local_storage.cache->get_matrix(false); // will also prune
-		stiffness.makeCompressed();
-		timer.stop();
-		logger().trace("done merge assembly {}s...", timer.getElapsedTime());
+		stiffness = mat_cache.get_matrix();
 
 		// stiffness.resize(n_basis*size(), n_basis*size());
 		// stiffness.setFromTriplets(entries.begin(), entries.end());
@@ -503,25 +474,38 @@ namespace polyfem::assembler
 		const Eigen::MatrixXd &displacement_prev) const
 	{
 		auto storage = create_thread_storage(LocalThreadScalarStorage());
-		const int n_bases = int(bases.size());
 
-		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
-			LocalThreadScalarStorage &local_storage = get_local_thread_storage(storage, thread_id);
-			ElementAssemblyValues &vals = local_storage.vals;
+		if (use_element_batches_ && cache.is_initialized() && supports_element_batches())
+		{
+			const std::vector<ElementBatch> &batches = element_batches_.get(is_volume, size(), bases, cache);
 
-			for (int e = start; e < end; ++e)
-			{
-				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+			maybe_parallel_for(batches.size(), [&](int start, int end, int thread_id) {
+				LocalThreadScalarStorage &local_storage = get_local_thread_storage(storage, thread_id);
+				for (int b = start; b < end; ++b)
+					local_storage.val += compute_batch_energy(batches[b], t, displacement);
+			});
+		}
+		else
+		{
+			const int n_bases = int(bases.size());
 
-				const Quadrature &quadrature = vals.quadrature;
+			maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+				LocalThreadScalarStorage &local_storage = get_local_thread_storage(storage, thread_id);
+				for (int k = start; k < end; ++k)
+				{
+					const int e = cache.ordered_element(k);
+					const ElementAssemblyValues &vals = cache.get(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
-				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
-				local_storage.da = vals.det.array() * quadrature.weights.array();
+					const Quadrature &quadrature = vals.quadrature;
 
-				const double val = compute_energy(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
-				local_storage.val += val;
-			}
-		});
+					assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+					local_storage.da = vals.det.array() * quadrature.weights.array();
+
+					const double val = compute_energy(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
+					local_storage.val += val;
+				}
+			});
+		}
 
 		double res = 0;
 		// Serially merge local storages
@@ -546,11 +530,10 @@ namespace polyfem::assembler
 
 		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
 			LocalThreadScalarStorage &local_storage = get_local_thread_storage(storage, thread_id);
-			ElementAssemblyValues &vals = local_storage.vals;
-
-			for (int e = start; e < end; ++e)
+			for (int k = start; k < end; ++k)
 			{
-				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+				const int e = cache.ordered_element(k);
+				const ElementAssemblyValues &vals = cache.get(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
 				const Quadrature &quadrature = vals.quadrature;
 
@@ -593,13 +576,13 @@ namespace polyfem::assembler
 		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
 			LocalThreadVecStorage &local_storage = get_local_thread_storage(storage, thread_id);
 
-			for (int e = start; e < end; ++e)
+			for (int k = start; k < end; ++k)
 			{
+				const int e = cache.ordered_element(k);
 				// igl::Timer timer; timer.start();
 
-				ElementAssemblyValues &vals = local_storage.vals;
 				// vals.compute(e, is_volume, bases[e], gbases[e]);
-				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+				const ElementAssemblyValues &vals = cache.get(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
 				const Quadrature &quadrature = vals.quadrature;
 
@@ -612,20 +595,14 @@ namespace polyfem::assembler
 
 				for (int j = 0; j < n_loc_bases; ++j)
 				{
-					const auto &global_j = vals.basis_values[j].global;
-
 					// igl::Timer t1; t1.start();
 					for (int m = 0; m < size(); ++m)
 					{
 						const double local_value = val(j * size() + m);
 
-						for (size_t jj = 0; jj < global_j.size(); ++jj)
-						{
-							const auto gj = global_j[jj].index * size() + m;
-							const auto wj = global_j[jj].val;
-
-							local_storage.vec(gj) += local_value * wj;
-						}
+						vals.for_each_global(j, [&](const int index_j, const double wj) {
+							local_storage.vec(index_j * size() + m) += local_value * wj;
+						});
 					}
 
 					// t1.stop();
@@ -642,6 +619,70 @@ namespace polyfem::assembler
 			rhs += local_storage.vec;
 	}
 
+	double NLAssembler::assemble_energy_gradient(
+		const bool is_volume,
+		const int n_basis,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t,
+		const double dt,
+		const Eigen::MatrixXd &displacement,
+		const Eigen::MatrixXd &displacement_prev,
+		Eigen::MatrixXd &rhs) const
+	{
+		rhs.resize(n_basis * size(), 1);
+		rhs.setZero();
+
+		auto storage = create_thread_storage(LocalThreadScalarVecStorage(rhs.size()));
+
+		const int n_bases = int(bases.size());
+
+		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+			LocalThreadScalarVecStorage &local_storage = get_local_thread_storage(storage, thread_id);
+
+			for (int k = start; k < end; ++k)
+			{
+				const int e = cache.ordered_element(k);
+				const ElementAssemblyValues &vals = cache.get(e, is_volume, bases[e], gbases[e], local_storage.vals);
+
+				const Quadrature &quadrature = vals.quadrature;
+
+				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+				local_storage.da = vals.det.array() * quadrature.weights.array();
+				const int n_loc_bases = int(vals.basis_values.size());
+
+				// the geometric mapping and the basis values are shared by the energy and the gradient
+				const NonLinearAssemblerData data(vals, t, dt, displacement, displacement_prev, local_storage.da);
+				local_storage.val += compute_energy(data);
+
+				const auto val = assemble_gradient(data);
+				assert(val.size() == n_loc_bases * size());
+
+				for (int j = 0; j < n_loc_bases; ++j)
+				{
+					for (int m = 0; m < size(); ++m)
+					{
+						const double local_value = val(j * size() + m);
+
+						vals.for_each_global(j, [&](const int index_j, const double wj) {
+							local_storage.vec(index_j * size() + m) += local_value * wj;
+						});
+					}
+				}
+			}
+		});
+
+		double res = 0;
+		// Serially merge local storages
+		for (const LocalThreadScalarVecStorage &local_storage : storage)
+		{
+			res += local_storage.val;
+			rhs += local_storage.vec;
+		}
+		return res;
+	}
+
 	void NLAssembler::assemble_hessian(
 		const bool is_volume,
 		const int n_basis,
@@ -666,19 +707,106 @@ namespace polyfem::assembler
 		mat_cache.init(n_basis * size());
 		mat_cache.set_zero();
 
-		auto storage = create_thread_storage(LocalThreadMatStorage(buffer_size, mat_cache));
+		const int n_bases = int(bases.size());
+
+		assemble_elements(n_bases, buffer_size, cache, mat_cache, [&](const int e, LocalThreadMatStorage &local_storage) {
+			const ElementAssemblyValues &vals = cache.get(e, is_volume, bases[e], gbases[e], local_storage.vals);
+
+			const Quadrature &quadrature = vals.quadrature;
+
+			assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+			local_storage.da = vals.det.array() * quadrature.weights.array();
+			const int n_loc_bases = int(vals.basis_values.size());
+
+			auto stiffness_val = assemble_hessian(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
+			assert(stiffness_val.rows() == n_loc_bases * size());
+			assert(stiffness_val.cols() == n_loc_bases * size());
+
+			if (project_to_psd)
+				stiffness_val = ipc::project_to_psd(stiffness_val);
+
+			// bool has_nan = false;
+			// for(int k = 0; k < stiffness_val.size(); ++k)
+			// {
+			// 	if(std::isnan(stiffness_val(k)))
+			// 	{
+			// 		has_nan = true;
+			// 		break;
+			// 	}
+			// }
+
+			// if(has_nan)
+			// {
+			// 	local_storage.entries.emplace_back(0, 0, std::nan(""));
+			// 	break;
+			// }
+
+			for (int i = 0; i < n_loc_bases; ++i)
+			{
+				for (int j = 0; j < n_loc_bases; ++j)
+				// for(int j = 0; j <= i; ++j)
+				{
+					for (int n = 0; n < size(); ++n)
+					{
+						for (int m = 0; m < size(); ++m)
+						{
+							const double local_value = stiffness_val(i * size() + m, j * size() + n);
+
+							vals.for_each_global(i, [&](const int index_i, const double wi) {
+								const auto gi = index_i * size() + m;
+
+								vals.for_each_global(j, [&](const int index_j, const double wj) {
+									const auto gj = index_j * size() + n;
+
+									local_storage.cache->add_value(e, gi, gj, local_value * wi * wj);
+									// if (j < i) {
+									// 	local_storage.entries.emplace_back(gj, gi, local_value * wj * wi);
+									// }
+
+									if (local_storage.cache->entries_size() >= max_triplets_size)
+									{
+										local_storage.cache->prune();
+										logger().debug("cleaning memory...");
+									}
+								});
+							});
+						}
+					}
+				}
+			}
+		});
+
+		hess = mat_cache.get_matrix();
+	}
+
+	void NLAssembler::assemble_hessian_vector_product(
+		const bool is_volume,
+		const int n_basis,
+		const bool project_to_psd,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t,
+		const double dt,
+		const Eigen::MatrixXd &displacement,
+		const Eigen::MatrixXd &displacement_prev,
+		const Eigen::VectorXd &v,
+		Eigen::VectorXd &Hv) const
+	{
+		assert(v.size() == n_basis * size());
+
+		auto storage = create_thread_storage(LocalThreadVecStorage(n_basis * size()));
 
 		const int n_bases = int(bases.size());
-		igl::Timer timer;
-		timer.start();
 
 		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
-			LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
+			LocalThreadVecStorage &local_storage = get_local_thread_storage(storage, thread_id);
+			Eigen::VectorXd local_v, local_Hv;
 
-			for (int e = start; e < end; ++e)
+			for (int k = start; k < end; ++k)
 			{
-				ElementAssemblyValues &vals = local_storage.vals;
-				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+				const int e = cache.ordered_element(k);
+				const ElementAssemblyValues &vals = cache.get(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
 				const Quadrature &quadrature = vals.quadrature;
 
@@ -686,88 +814,39 @@ namespace polyfem::assembler
 				local_storage.da = vals.det.array() * quadrature.weights.array();
 				const int n_loc_bases = int(vals.basis_values.size());
 
-				auto stiffness_val = assemble_hessian(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
+				Eigen::MatrixXd stiffness_val = assemble_hessian(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
 				assert(stiffness_val.rows() == n_loc_bases * size());
 				assert(stiffness_val.cols() == n_loc_bases * size());
 
 				if (project_to_psd)
 					stiffness_val = ipc::project_to_psd(stiffness_val);
 
-				// bool has_nan = false;
-				// for(int k = 0; k < stiffness_val.size(); ++k)
-				// {
-				// 	if(std::isnan(stiffness_val(k)))
-				// 	{
-				// 		has_nan = true;
-				// 		break;
-				// 	}
-				// }
-
-				// if(has_nan)
-				// {
-				// 	local_storage.entries.emplace_back(0, 0, std::nan(""));
-				// 	break;
-				// }
-
+				// gather v on the element, apply the element hessian, and scatter the result back
+				local_v.setZero(n_loc_bases * size());
 				for (int i = 0; i < n_loc_bases; ++i)
 				{
-					const auto &global_i = vals.basis_values[i].global;
-
-					for (int j = 0; j < n_loc_bases; ++j)
-					// for(int j = 0; j <= i; ++j)
-					{
-						const auto &global_j = vals.basis_values[j].global;
-
-						for (int n = 0; n < size(); ++n)
-						{
-							for (int m = 0; m < size(); ++m)
-							{
-								const double local_value = stiffness_val(i * size() + m, j * size() + n);
-
-								for (size_t ii = 0; ii < global_i.size(); ++ii)
-								{
-									const auto gi = global_i[ii].index * size() + m;
-									const auto wi = global_i[ii].val;
-
-									for (size_t jj = 0; jj < global_j.size(); ++jj)
-									{
-										const auto gj = global_j[jj].index * size() + n;
-										const auto wj = global_j[jj].val;
+					vals.for_each_global(i, [&](const int index_i, const double wi) {
+						for (int m = 0; m < size(); ++m)
+							local_v(i * size() + m) += wi * v(index_i * size() + m);
+					});
+				}
 
-										local_storage.cache->add_value(e, gi, gj, local_value * wi * wj);
-										// if (j < i) {
-										// 	local_storage.entries.emplace_back(gj, gi, local_value * wj * wi);
-										// }
+				local_Hv.noalias() = stiffness_val * local_v;
 
-										if (local_storage.cache->entries_size() >= max_triplets_size)
-										{
-											local_storage.cache->prune();
-											logger().debug("cleaning memory...");
-										}
-									}
-								}
-							}
-						}
-					}
+				for (int i = 0; i < n_loc_bases; ++i)
+				{
+					vals.for_each_global(i, [&](const int index_i, const double wi) {
+						for (int m = 0; m < size(); ++m)
+							local_storage.vec(index_i * size() + m) += wi * local_Hv(i * size() + m);
+					});
 				}
 			}
 		});
 
-		timer.stop();
-		logger().trace("done separate assembly {}s...", timer.getElapsedTime());
-
-		timer.start();
-
+		Hv.setZero(n_basis * size());
 		// Serially merge local storages
-		for (LocalThreadMatStorage &local_storage : storage)
-		{
-			local_storage.cache->prune();
-			mat_cache += *local_storage.cache;
-		}
-		hess = mat_cache.get_matrix();
-
-		timer.stop();
-		logger().trace("done merge assembly {}s...", timer.getElapsedTime());
+		for (const LocalThreadVecStorage &local_storage : storage)
+			Hv += local_storage.vec;
 	}
 
 } // namespace polyfem::assembler
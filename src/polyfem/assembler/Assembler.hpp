@@ -4,6 +4,7 @@
 
 #include <polyfem/assembler/AssemblerData.hpp>
 #include <polyfem/assembler/AssemblyValsCache.hpp>
+#include <polyfem/assembler/ElementBatch.hpp>
 
 #include <polyfem/utils/MatrixCache.hpp>
 #include <polyfem/utils/ElasticityUtils.hpp>
@@ -14,6 +15,34 @@
 // without adding template instantiation
 namespace polyfem::assembler
 {
+	/// sparsity pattern of an assembled linear operator and the scatter map of every element into it
+	/// the pattern is reused by the next assembly as long as the key (spaces, values cache and sizes) does not change
+	/// copies of the owner start with an empty pattern
+	class AssemblyPatternCache
+	{
+	public:
+		AssemblyPatternCache() = default;
+		AssemblyPatternCache(const AssemblyPatternCache &) {}
+		AssemblyPatternCache &operator=(const AssemblyPatternCache &)
+		{
+			clear();
+			return *this;
+		}
+
+		/// returns the matrix cache to assemble into, zeroed and reset if key differs from the previous assembly
+		utils::SparseMatrixCache &get(const std::vector<size_t> &key, const int rows, const int cols);
+
+		void clear()
+		{
+			key_.clear();
+			mat_cache_ = nullptr;
+		}
+
+	private:
+		std::vector<size_t> key_;
+		std::unique_ptr<utils::SparseMatrixCache> mat_cache_;
+	};
+
 	// mixed formulation assembler
 	class MixedAssembler
 	{
@@ -47,6 +76,9 @@ namespace polyfem::assembler
 		virtual int cols() const = 0;
 
 		virtual Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> assemble(const MixedAssemblerData &data) const = 0;
+
+	private:
+		mutable AssemblyPatternCache pattern_cache_;
 	};
 
 	/// abstract class
@@ -109,6 +141,23 @@ namespace polyfem::assembler
 			const Eigen::MatrixXd &displacement_prev,
 			Eigen::MatrixXd &rhs) const { log_and_throw_error("Assemble grad not implemented by {}!", name()); }
 
+		// assemble energy and its gradient (rhs), the default calls assemble_energy and assemble_gradient
+		virtual double assemble_energy_gradient(
+			const bool is_volume,
+			const int n_basis,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			Eigen::MatrixXd &rhs) const
+		{
+			assemble_gradient(is_volume, n_basis, bases, gbases, cache, t, dt, displacement, displacement_prev, rhs);
+			return assemble_energy(is_volume, bases, gbases, cache, t, dt, displacement, displacement_prev);
+		}
+
 		// assemble hessian of energy (grad)
 		virtual void assemble_hessian(
 			const bool is_volume,
@@ -124,6 +173,21 @@ namespace polyfem::assembler
 			utils::MatrixCache &mat_cache,
 			StiffnessMatrix &grad) const { log_and_throw_error("Assemble hessian not implemented by {}!", name()); }
 
+		// product of the hessian of energy with v, computed element by element without assembling the hessian
+		virtual void assemble_hessian_vector_product(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			const Eigen::VectorXd &v,
+			Eigen::VectorXd &Hv) const { log_and_throw_error("Assemble hessian vector product not implemented by {}!", name()); }
+
 		// plotting (eg von mises), assembler is the name of the formulation
 		virtual void compute_scalar_value(
 			const OutputData &data,
@@ -194,13 +258,26 @@ namespace polyfem::assembler
 			log_and_throw_error("Not implemented!");
 		}
 
+		/// evaluates the material parameters at the quadrature points of all elements at time t,
+		/// the element loops read them back until the next call or until the materials change
+		virtual void update_material_cache(
+			const bool is_volume,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t) const {}
+
 		virtual bool is_linear() const = 0;
 		virtual bool is_solution_displacement() const { return false; }
 		virtual bool is_fluid() const { return false; }
 		virtual bool is_tensor() const { return false; }
 
+		/// lets the energy loops evaluate elements of the same kind in batches when the formulation supports it
+		void set_use_element_batches(const bool use) { use_element_batches_ = use; }
+
 	protected:
 		int size_ = -1;
+		bool use_element_batches_ = true;
 	};
 
 	/// assemble matrix based on the local assembler
@@ -217,6 +294,7 @@ namespace polyfem::assembler
 		/// the subclass (eg Laplacian) defines
 		/// sets stiffness and modifies cache if it has not
 		/// already been computed
+		/// the sparsity pattern is kept and reused by the next call on the same space
 		void assemble(
 			const bool is_volume,
 			const int n_basis,
@@ -232,6 +310,9 @@ namespace polyfem::assembler
 		/// local assembly function that defines the bilinear form (LHS)
 		/// computes and returns a single local stiffness value
 		virtual Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> assemble(const LinearAssemblerData &data) const = 0;
+
+	private:
+		mutable AssemblyPatternCache pattern_cache_;
 	};
 
 	// non-linear assembler (eg neohookean elasticity)
@@ -275,6 +356,19 @@ namespace polyfem::assembler
 			const Eigen::MatrixXd &displacement_prev,
 			Eigen::MatrixXd &rhs) const override;
 
+		// assemble energy and its gradient (rhs) in a single pass over the elements
+		double assemble_energy_gradient(
+			const bool is_volume,
+			const int n_basis,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			Eigen::MatrixXd &rhs) const override;
+
 		// assemble hessian of energy (grad)
 		void assemble_hessian(
 			const bool is_volume,
@@ -290,6 +384,21 @@ namespace polyfem::assembler
 			utils::MatrixCache &mat_cache,
 			StiffnessMatrix &grad) const override;
 
+		// product of the hessian of energy with v, the element hessians are applied without being assembled
+		void assemble_hessian_vector_product(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			const Eigen::VectorXd &v,
+			Eigen::VectorXd &Hv) const override;
+
 		virtual bool is_linear() const override { return false; }
 
 	protected:
@@ -297,6 +406,17 @@ namespace polyfem::assembler
 		virtual double compute_energy(const NonLinearAssemblerData &data) const = 0;
 		virtual Eigen::VectorXd assemble_gradient(const NonLinearAssemblerData &data) const = 0;
 		virtual Eigen::MatrixXd assemble_hessian(const NonLinearAssemblerData &data) const = 0;
+
+		/// true if compute_batch_energy is implemented, for the current parameters of the formulation
+		virtual bool supports_element_batches() const { return false; }
+		/// sum of the energies of the elements of a batch, evaluated on all the lanes at once
+		virtual double compute_batch_energy(const ElementBatch &batch, const double t, const Eigen::MatrixXd &displacement) const
+		{
+			log_and_throw_error("Batched energy not implemented by {}!", name());
+		}
+
+	private:
+		mutable ElementBatches element_batches_;
 	};
 
 	class ElasticityAssembler : virtual public Assembler
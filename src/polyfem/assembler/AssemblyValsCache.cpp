@@ -2,6 +2,8 @@
 
 #include <polyfem/utils/MaybeParallelFor.hpp>
 
+#include <atomic>
+
 namespace polyfem
 {
 	using namespace basis;
@@ -10,6 +12,7 @@ namespace polyfem
 	{
 		void AssemblyValsCache::init(const bool is_volume, const std::vector<ElementBases> &bases, const std::vector<ElementBases> &gbases, const bool is_mass)
 		{
+			id_ = next_id();
 			is_mass_ = is_mass;
 			const int n_bases = bases.size();
 			cache.resize(n_bases);
@@ -26,6 +29,102 @@ namespace polyfem
 					}
 					else
 						cache[e].compute(e, is_volume, bases[e], gbases[e]);
+					cache[e].release_scratch();
+				}
+			});
+
+			pack();
+		}
+
+		size_t AssemblyValsCache::next_id()
+		{
+			static std::atomic<size_t> counter(0);
+			return ++counter;
+		}
+
+		void AssemblyValsCache::pack()
+		{
+			const int n_elements = cache.size();
+
+			// first pass: size of every element segment
+			std::vector<size_t> real_offsets(n_elements + 1, 0);
+			std::vector<size_t> index_offsets(n_elements + 1, 0);
+			for (int e = 0; e < n_elements; ++e)
+			{
+				const ElementAssemblyValues &vals = cache[e];
+				const int n_bases = vals.basis_values.size();
+				const int n_quad = n_bases > 0 ? vals.basis_values[0].val.size() : 0;
+				const int dim = n_bases > 0 ? vals.basis_values[0].grad_t_m.cols() : 0;
+
+				size_t n_globals = 0;
+				for (const auto &v : vals.basis_values)
+					n_globals += v.global.size();
+
+				real_offsets[e + 1] = real_offsets[e] + AlignedBuffer<double>::padded(n_bases * n_quad * (1 + dim) + n_globals);
+				index_offsets[e + 1] = index_offsets[e] + AlignedBuffer<int>::padded(n_bases + 1 + n_globals);
+			}
+
+			packed_reals_.resize(real_offsets.back());
+			packed_indices_.resize(index_offsets.back());
+
+			// second pass: copy the values
+			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+				for (int e = start; e < end; ++e)
+				{
+					ElementAssemblyValues &vals = cache[e];
+					PackedElementValues &packed = vals.packed;
+					packed = PackedElementValues();
+
+					const int n_bases = vals.basis_values.size();
+					if (n_bases == 0)
+						continue;
+
+					const int n_quad = vals.basis_values[0].val.size();
+					const int dim = vals.basis_values[0].grad_t_m.cols();
+
+					double *reals = packed_reals_.data() + real_offsets[e];
+					int *indices = packed_indices_.data() + index_offsets[e];
+
+					double *val = reals;
+					double *grad_t_m = val + n_bases * n_quad;
+					double *global_val = grad_t_m + n_bases * n_quad * dim;
+					int *global_offset = indices;
+					int *global_index = indices + n_bases + 1;
+
+					global_offset[0] = 0;
+					for (int i = 0; i < n_bases; ++i)
+					{
+						AssemblyValues &v = vals.basis_values[i];
+						assert(v.val.size() == n_quad);
+						assert(v.grad_t_m.rows() == n_quad && v.grad_t_m.cols() == dim);
+
+						for (int q = 0; q < n_quad; ++q)
+						{
+							val[i * n_quad + q] = v.val(q);
+							for (int d = 0; d < dim; ++d)
+								grad_t_m[(i * n_quad + q) * dim + d] = v.grad_t_m(q, d);
+						}
+						// the arena is the only copy of the mapped gradients, read them with ElementAssemblyValues::grad_t_m
+						v.grad_t_m.resize(0, 0);
+
+						int k = global_offset[i];
+						for (const auto &g : v.global)
+						{
+							global_index[k] = g.index;
+							global_val[k] = g.val;
+							++k;
+						}
+						global_offset[i + 1] = k;
+					}
+
+					packed.n_bases = n_bases;
+					packed.n_quad = n_quad;
+					packed.dim = dim;
+					packed.val = val;
+					packed.grad_t_m = grad_t_m;
+					packed.global_offset = global_offset;
+					packed.global_index = global_index;
+					packed.global_val = global_val;
 				}
 			});
 		}
@@ -40,6 +139,10 @@ namespace polyfem
 			}
 			else
 				cache[e].compute(e, is_volume, basis, gbasis);
+			// the packed view was reset by compute, consumers fall back to basis_values for this element
+			cache[e].release_scratch();
+			// the quadrature of the element may have changed, data derived from the cache must be rebuilt
+			id_ = next_id();
 		}
 
 		void AssemblyValsCache::compute(const int el_index, const bool is_volume, const ElementBases &basis, const ElementBases &gbasis, ElementAssemblyValues &vals) const
@@ -56,7 +159,28 @@ namespace polyfem
 					vals.compute(el_index, is_volume, basis, gbasis);
 			}
 			else
+			{
 				vals = cache[el_index];
+				// the copy must not outlive the packed arenas, restore the mapped gradients it only holds there
+				const PackedElementValues &packed = vals.packed;
+				if (packed.is_valid())
+				{
+					for (int i = 0; i < packed.n_bases; ++i)
+						vals.basis_values[i].grad_t_m = vals.grad_t_m(i);
+				}
+				vals.packed = PackedElementValues();
+			}
+		}
+
+		const ElementAssemblyValues &AssemblyValsCache::get(const int el_index, const bool is_volume, const ElementBases &basis, const ElementBases &gbasis, ElementAssemblyValues &tmp) const
+		{
+			if (cache.empty())
+			{
+				compute(el_index, is_volume, basis, gbasis, tmp);
+				return tmp;
+			}
+
+			return cache[el_index];
 		}
 	} // namespace assembler
 
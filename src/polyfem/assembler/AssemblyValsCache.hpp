@@ -1,6 +1,9 @@
 #pragma once
 
 #include <polyfem/assembler/ElementAssemblyValues.hpp>
+#include <polyfem/mesh/ElementOrdering.hpp>
+
+#include <memory>
 
 namespace polyfem
 {
@@ -19,20 +22,68 @@ namespace polyfem
 			/// if it doesn't exist, computes and caches it (modifies cache member in the latter case)
 			void compute(const int el_index, const bool is_volume, const basis::ElementBases &basis, const basis::ElementBases &gbasis, ElementAssemblyValues &vals) const;
 
+			/// read-only access to the cached basis evaluation and geometric mapping of the given element
+			/// the cache must be initialized
+			const ElementAssemblyValues &get(const int el_index) const
+			{
+				assert(is_initialized());
+				assert(el_index >= 0 && el_index < cache.size());
+				return cache[el_index];
+			}
+
+			/// returns the cached values for the given element without copying them if the cache is initialized,
+			/// otherwise computes them in tmp and returns a reference to tmp
+			const ElementAssemblyValues &get(const int el_index, const bool is_volume, const basis::ElementBases &basis, const basis::ElementBases &gbasis, ElementAssemblyValues &tmp) const;
+
 			void update(const int el_index, const bool is_volume, const basis::ElementBases &basis, const basis::ElementBases &gbasis);
 
 			void clear()
 			{
+				id_ = next_id();
 				cache.clear();
+				element_ordering_ = nullptr;
+				packed_reals_.resize(0);
+				packed_indices_.resize(0);
 			}
 
 			inline bool is_initialized() const { return !cache.empty(); }
 
 			inline bool is_mass() const { return is_mass_; }
 
+			/// sets the order in which the assembly loops visit the elements
+			/// the ordering must be built from the same bases as the cache, it is dropped by clear
+			void set_element_ordering(const std::shared_ptr<const mesh::ElementOrdering> &ordering) { element_ordering_ = ordering; }
+
+			/// ordering of the elements, nullptr if the elements are visited in their input order
+			const mesh::ElementOrdering *element_ordering() const { return element_ordering_.get(); }
+
+			/// k-th element to visit in the assembly loops
+			inline int ordered_element(const int k) const
+			{
+				if (element_ordering_ == nullptr)
+					return k;
+				assert(k < element_ordering_->n_elements());
+				return element_ordering_->element(k);
+			}
+
+			/// identifies the values the cache holds, changes every time the cache is initialized, updated, or cleared
+			inline size_t id() const { return id_; }
+
 		private:
+			/// copies the basis values and local to global maps of all cached elements into the packed arenas,
+			/// moves the mapped gradients there (basis_values[i].grad_t_m is freed)
+			/// and points ElementAssemblyValues::packed to them
+			void pack();
+
 			std::vector<ElementAssemblyValues> cache; ///< vector of basis values and geometric mapping with one entry per element
-			bool is_mass_;
+			bool is_mass_ = false;
+			size_t id_ = next_id();
+			std::shared_ptr<const mesh::ElementOrdering> element_ordering_;
+
+			static size_t next_id();
+
+			AlignedBuffer<double> packed_reals_;  ///< per element: val, grad_t_m, and local to global weights, each element starts on a cache line
+			AlignedBuffer<int> packed_indices_;   ///< per element: local to global offsets and indices
 		};
 	} // namespace assembler
 } // namespace polyfem
@@ -165,7 +165,8 @@ namespace polyfem
 		{
 			basis_ = &basis;
 			gbasis_ = &gbasis;
-			
+			packed = PackedElementValues();
+
 			element_id = el_index;
 			is_volume_ = is_volume;
 			// const bool poly = !gbasis.has_parameterization;
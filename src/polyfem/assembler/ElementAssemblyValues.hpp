@@ -1,6 +1,7 @@
 #pragma once
 
 #include <polyfem/assembler/AssemblyValues.hpp>
+#include <polyfem/assembler/PackedAssemblyValues.hpp>
 #include <polyfem/basis/ElementBases.hpp>
 
 #include <vector>
@@ -35,6 +36,10 @@ namespace polyfem
 			// only poly elements have no parameterization
 			bool has_parameterization = true;
 
+			// contiguous copy of basis_values owned by AssemblyValsCache,
+			// invalid (and ignored) unless the values come from an initialized cache
+			PackedElementValues packed;
+
 			/// computes the per element values at the local (ref el) points (pts)
 			/// sets basis_values, jac_it, val, and det members
 			void compute(const int el_index, const bool is_volume, const Eigen::MatrixXd &pts, const basis::ElementBases &basis, const basis::ElementBases &gbasis);
@@ -47,6 +52,43 @@ namespace polyfem
 
 			Eigen::VectorXd eval_deformed_jacobian_determinant(const Eigen::VectorXd &disp) const;
 
+			/// strided view of J^{-T}*∇φ_i at the quadrature points (R^{m x dim})
+			using GradTMMap = Eigen::Map<const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+
+			/// mapped gradients of basis i, read from the packed arena when it is valid
+			/// (the cache frees basis_values[i].grad_t_m after packing)
+			GradTMMap grad_t_m(const int i) const
+			{
+				if (packed.is_valid())
+					return GradTMMap(packed.grad_t_m + i * packed.n_quad * packed.dim, packed.n_quad, packed.dim, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(1, packed.dim));
+
+				const Eigen::MatrixXd &g = basis_values[i].grad_t_m;
+				return GradTMMap(g.data(), g.rows(), g.cols(), Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(g.rows(), 1));
+			}
+
+			/// calls f(global_index, weight) for every global node the local basis i contributes to
+			template <typename F>
+			void for_each_global(const int i, F &&f) const
+			{
+				if (packed.is_valid())
+				{
+					for (int k = packed.global_offset[i]; k < packed.global_offset[i + 1]; ++k)
+						f(packed.global_index[k], packed.global_val[k]);
+				}
+				else
+				{
+					for (const auto &g : basis_values[i].global)
+						f(g.index, g.val);
+				}
+			}
+
+			/// frees the geometric basis evaluations only needed while computing the mapping
+			void release_scratch()
+			{
+				g_basis_values_cache_.clear();
+				g_basis_values_cache_.shrink_to_fit();
+			}
+
 		private:
 			const basis::ElementBases *basis_, *gbasis_;
 			std::vector<AssemblyValues> g_basis_values_cache_;
@@ -0,0 +1,146 @@
+#include "ElementBatch.hpp"
+
+#include <polyfem/assembler/AssemblyValsCache.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <map>
+
+namespace polyfem::assembler
+{
+	namespace
+	{
+		void fill_batch(const AssemblyValsCache &cache, const int dim, const std::vector<int> &elements, ElementBatch &batch)
+		{
+			constexpr int W = ElementBatch::BATCH_SIZE;
+			assert(!elements.empty() && elements.size() <= W);
+
+			const ElementAssemblyValues &first = cache.get(elements.front());
+			batch.dim = dim;
+			batch.n_bases = first.basis_values.size();
+			batch.n_quad = first.quadrature.weights.size();
+			batch.n_elements = elements.size();
+
+			batch.da.assign(batch.n_quad, ElementBatch::Lanes::Zero());
+			batch.uv.assign(batch.n_quad * dim, ElementBatch::Lanes::Zero());
+			batch.points.assign(batch.n_quad * dim, ElementBatch::Lanes::Zero());
+
+			for (int l = 0; l < W; ++l)
+			{
+				// unused lanes repeat the last element so that they stay finite, their da is zero
+				const bool used = l < batch.n_elements;
+				const int e = elements[std::min<int>(l, batch.n_elements - 1)];
+				const ElementAssemblyValues &vals = cache.get(e);
+				assert(vals.basis_values.size() == batch.n_bases);
+				assert(vals.quadrature.weights.size() == batch.n_quad);
+
+				batch.elements[l] = e;
+				batch.vals[l] = &vals;
+
+				for (int q = 0; q < batch.n_quad; ++q)
+				{
+					batch.da[q](l) = used ? vals.det(q) * vals.quadrature.weights(q) : 0;
+					for (int j = 0; j < dim; ++j)
+					{
+						batch.uv[q * dim + j](l) = vals.quadrature.points(q, j);
+						batch.points[q * dim + j](l) = vals.val(q, j);
+					}
+				}
+			}
+		}
+	} // namespace
+
+	void ElementBatch::gather(const Eigen::MatrixXd &displacement, std::vector<Lanes> &local_disp) const
+	{
+		local_disp.assign(n_bases * dim, Lanes::Zero());
+
+		for (int l = 0; l < BATCH_SIZE; ++l)
+		{
+			for (int i = 0; i < n_bases; ++i)
+			{
+				vals[l]->for_each_global(i, [&](const int index, const double val) {
+					for (int d = 0; d < dim; ++d)
+						local_disp[i * dim + d](l) += val * displacement(index * dim + d);
+				});
+			}
+		}
+	}
+
+	void ElementBatch::displacement_gradient(const std::vector<Lanes> &local_disp, const int q, std::array<Lanes, 9> &grad_u) const
+	{
+		assert(local_disp.size() == n_bases * dim);
+
+		for (int k = 0; k < dim * dim; ++k)
+			grad_u[k].setZero();
+
+		std::array<Lanes, 3> g;
+		for (int i = 0; i < n_bases; ++i)
+		{
+			// gather J^{-T}*∇φ_i at q from the cache of every lane
+			for (int l = 0; l < BATCH_SIZE; ++l)
+			{
+				const auto grad = vals[l]->grad_t_m(i);
+				for (int j = 0; j < dim; ++j)
+					g[j](l) = grad(q, j);
+			}
+
+			for (int j = 0; j < dim; ++j)
+			{
+				for (int d = 0; d < dim; ++d)
+					grad_u[d + j * dim] += local_disp[i * dim + d] * g[j];
+			}
+		}
+	}
+
+	ElementBatch::Lanes ElementBatch::determinant(const std::array<Lanes, 9> &m, const int dim)
+	{
+		if (dim == 2)
+			return m[0] * m[3] - m[2] * m[1];
+
+		assert(dim == 3);
+		return m[0] * (m[4] * m[8] - m[7] * m[5])
+			   - m[3] * (m[1] * m[8] - m[7] * m[2])
+			   + m[6] * (m[1] * m[5] - m[4] * m[2]);
+	}
+
+	const std::vector<ElementBatch> &ElementBatches::get(
+		const bool is_volume,
+		const int dim,
+		const std::vector<basis::ElementBases> &bases,
+		const AssemblyValsCache &cache)
+	{
+		assert(cache.is_initialized());
+
+		const std::vector<size_t> key = {cache.id(), bases.size(), size_t(dim), size_t(is_volume)};
+		if (key == key_)
+			return batches_;
+
+		key_ = key;
+		batches_.clear();
+
+		// elements of the same kind, in visiting order
+		std::map<std::pair<int, int>, std::vector<int>> groups;
+		for (int k = 0; k < int(bases.size()); ++k)
+		{
+			const int e = cache.ordered_element(k);
+			const ElementAssemblyValues &vals = cache.get(e);
+			std::vector<int> &group = groups[{int(vals.basis_values.size()), int(vals.quadrature.weights.size())}];
+
+			group.push_back(e);
+			if (group.size() == ElementBatch::BATCH_SIZE)
+			{
+				fill_batch(cache, dim, group, batches_.emplace_back());
+				group.clear();
+			}
+		}
+
+		for (const auto &[kind, group] : groups)
+		{
+			if (!group.empty())
+				fill_batch(cache, dim, group, batches_.emplace_back());
+		}
+
+		logger().trace("Grouped {} elements in {} batches of {}", bases.size(), batches_.size(), ElementBatch::BATCH_SIZE);
+
+		return batches_;
+	}
+} // namespace polyfem::assembler
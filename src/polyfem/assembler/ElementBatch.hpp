@@ -0,0 +1,84 @@
+#pragma once
+
+#include <polyfem/assembler/ElementAssemblyValues.hpp>
+#include <polyfem/basis/ElementBases.hpp>
+
+#include <Eigen/Dense>
+
+#include <array>
+#include <vector>
+
+namespace polyfem::assembler
+{
+	class AssemblyValsCache;
+
+	/// up to BATCH_SIZE elements with the same number of bases and quadrature points, stored lane by lane:
+	/// every quantity is an array with one entry per element so that the quadrature point math
+	/// (deformation gradient, energy density) runs on all the elements of the batch at once
+	/// the basis gradients and local to global maps are read from the cache, not copied
+	class ElementBatch
+	{
+	public:
+		static constexpr int BATCH_SIZE = 8;
+		/// one value per element of the batch
+		using Lanes = Eigen::Array<double, BATCH_SIZE, 1>;
+
+		int dim = 0;
+		int n_bases = 0;
+		int n_quad = 0;
+		/// number of used lanes, the unused ones repeat the last element with zero da
+		int n_elements = 0;
+		std::array<int, BATCH_SIZE> elements;
+		/// cached values of the element of every lane, valid as long as the cache id does not change
+		std::array<const ElementAssemblyValues *, BATCH_SIZE> vals;
+
+		/// quadrature weight times the determinant of the geometric mapping, entry q
+		std::vector<Lanes> da;
+		/// reference and physical quadrature points, entry q * dim + j
+		std::vector<Lanes> uv, points;
+
+		/// local displacement of the elements, entry i * dim + d
+		void gather(const Eigen::MatrixXd &displacement, std::vector<Lanes> &local_disp) const;
+
+		/// displacement gradient at quadrature point q, column-major: entry d + j * dim is ∂u_d/∂x_j
+		void displacement_gradient(const std::vector<Lanes> &local_disp, const int q, std::array<Lanes, 9> &grad_u) const;
+
+		/// determinant of the dim x dim column-major matrix m
+		static Lanes determinant(const std::array<Lanes, 9> &m, const int dim);
+
+		/// sum of the used lanes
+		double sum(const Lanes &values) const { return values.head(n_elements).sum(); }
+	};
+
+	/// batches of all the elements of an initialized AssemblyValsCache, elements of the same kind
+	/// are batched in the visiting order of the cache so that the lanes of a batch are close in memory
+	/// the batches are reused as long as the cache and the bases do not change, copies of the owner start empty
+	class ElementBatches
+	{
+	public:
+		ElementBatches() = default;
+		ElementBatches(const ElementBatches &) {}
+		ElementBatches &operator=(const ElementBatches &)
+		{
+			clear();
+			return *this;
+		}
+
+		/// batches of the elements of cache, rebuilt if the cache or the bases changed
+		const std::vector<ElementBatch> &get(
+			const bool is_volume,
+			const int dim,
+			const std::vector<basis::ElementBases> &bases,
+			const AssemblyValsCache &cache);
+
+		void clear()
+		{
+			key_.clear();
+			batches_.clear();
+		}
+
+	private:
+		std::vector<size_t> key_;
+		std::vector<ElementBatch> batches_;
+	};
+} // namespace polyfem::assembler
@@ -309,7 +309,7 @@ namespace polyfem::assembler
 			def_grad.diagonal().array() += 1.0;
 
 			double lambda, mu;
-			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+			params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 			const double val = compute_energy_from_def_grad(def_grad, lambda, mu);
 
@@ -361,7 +361,7 @@ namespace polyfem::assembler
 			def_grad = local_disp.transpose() * delF_delU + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
 
 			double lambda, mu;
-			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+			params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 			Eigen::Matrix<double, dim, dim> gradient_temp = compute_stress_from_def_grad(def_grad, lambda, mu);
 
@@ -416,7 +416,7 @@ namespace polyfem::assembler
 			def_grad = local_disp.transpose() * grad * jac_it + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
 
 			double lambda, mu;
-			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+			params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 			Eigen::Matrix<double, dim * dim, dim * dim> hessian_temp = compute_stiffness_from_def_grad(def_grad, lambda, mu);
 
@@ -43,8 +43,7 @@ namespace polyfem::assembler
 
 		void update_lame_params(const Eigen::MatrixXd &lambdas, const Eigen::MatrixXd &mus) override
 		{
-			params_.lambda_mat_ = lambdas;
-			params_.mu_mat_ = mus;
+			params_.set_lame_mats(lambdas, mus);
 		}
 
 		std::string name() const override { return "FixedCorotational"; }
@@ -91,6 +91,223 @@ namespace polyfem::assembler
 
 	template <typename Derived>
 	Eigen::VectorXd GenericElastic<Derived>::assemble_gradient(const NonLinearAssemblerData &data) const
+	{
+		Eigen::VectorXd gradient;
+
+		if (size() == 2)
+		{
+			switch (data.vals.basis_values.size())
+			{
+			case 3: compute_gradient_from_stress<3, 2>(data, gradient); break;
+			case 4: compute_gradient_from_stress<4, 2>(data, gradient); break;
+			case 6: compute_gradient_from_stress<6, 2>(data, gradient); break;
+			case 10: compute_gradient_from_stress<10, 2>(data, gradient); break;
+			default: compute_gradient_from_stress<Eigen::Dynamic, 2>(data, gradient); break;
+			}
+		}
+		else // if (size() == 3)
+		{
+			assert(size() == 3);
+			switch (data.vals.basis_values.size())
+			{
+			case 4: compute_gradient_from_stress<4, 3>(data, gradient); break;
+			case 8: compute_gradient_from_stress<8, 3>(data, gradient); break;
+			case 10: compute_gradient_from_stress<10, 3>(data, gradient); break;
+			case 20: compute_gradient_from_stress<20, 3>(data, gradient); break;
+			default: compute_gradient_from_stress<Eigen::Dynamic, 3>(data, gradient); break;
+			}
+		}
+
+		return gradient;
+	}
+
+	template <typename Derived>
+	Eigen::MatrixXd GenericElastic<Derived>::assemble_hessian(const NonLinearAssemblerData &data) const
+	{
+		Eigen::MatrixXd hessian;
+
+		if (size() == 2)
+		{
+			switch (data.vals.basis_values.size())
+			{
+			case 3: compute_hessian_from_tangent<3, 2>(data, hessian); break;
+			case 4: compute_hessian_from_tangent<4, 2>(data, hessian); break;
+			case 6: compute_hessian_from_tangent<6, 2>(data, hessian); break;
+			case 10: compute_hessian_from_tangent<10, 2>(data, hessian); break;
+			default: compute_hessian_from_tangent<Eigen::Dynamic, 2>(data, hessian); break;
+			}
+		}
+		else // if (size() == 3)
+		{
+			assert(size() == 3);
+			switch (data.vals.basis_values.size())
+			{
+			case 4: compute_hessian_from_tangent<4, 3>(data, hessian); break;
+			case 8: compute_hessian_from_tangent<8, 3>(data, hessian); break;
+			case 10: compute_hessian_from_tangent<10, 3>(data, hessian); break;
+			case 20: compute_hessian_from_tangent<20, 3>(data, hessian); break;
+			default: compute_hessian_from_tangent<Eigen::Dynamic, 3>(data, hessian); break;
+			}
+		}
+
+		return hessian;
+	}
+
+	namespace
+	{
+		// local displacement of the element, one row per basis
+		template <int n_basis, int dim>
+		Eigen::Matrix<double, n_basis, dim> element_displacement(const NonLinearAssemblerData &data)
+		{
+			assert(data.x.cols() == 1);
+
+			Eigen::Matrix<double, n_basis, dim> local_disp(data.vals.basis_values.size(), dim);
+			local_disp.setZero();
+			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
+			{
+				data.vals.for_each_global(i, [&](const int index, const double val) {
+					for (int d = 0; d < dim; ++d)
+						local_disp(i, d) += val * data.x(index * dim + d);
+				});
+			}
+
+			return local_disp;
+		}
+
+		// gradients of the bases at the quadrature point p, one row per basis
+		template <int n_basis, int dim>
+		void basis_gradients(const ElementAssemblyValues &vals, const int p, Eigen::Matrix<double, n_basis, dim> &grad)
+		{
+			for (size_t i = 0; i < vals.basis_values.size(); ++i)
+				grad.row(i) = vals.grad_t_m(i).row(p);
+		}
+
+		// derivative of F flattened column-wise with respect to the element dofs (basis i, coordinate k at i * dim + k)
+		template <int n_basis, int dim, int N>
+		void deformation_gradient_jacobian(const Eigen::Matrix<double, n_basis, dim> &grad, Eigen::Matrix<double, dim * dim, N> &delF_delU)
+		{
+			delF_delU.setZero();
+			for (int i = 0; i < grad.rows(); ++i)
+				for (int k = 0; k < dim; ++k)
+					for (int j = 0; j < dim; ++j)
+						delF_delU(k + j * dim, i * dim + k) = grad(i, j);
+		}
+	} // namespace
+
+	template <typename Derived>
+	template <int n_basis, int dim>
+	void GenericElastic<Derived>::compute_gradient_from_stress(const NonLinearAssemblerData &data, Eigen::VectorXd &G) const
+	{
+		constexpr int N = (n_basis == Eigen::Dynamic) ? Eigen::Dynamic : n_basis * dim;
+		const int n_bases = data.vals.basis_values.size();
+
+		const Eigen::Matrix<double, n_basis, dim> local_disp = element_displacement<n_basis, dim>(data);
+
+		Eigen::Matrix<double, n_basis, dim> grad(n_bases, dim);
+		Eigen::Matrix<double, dim * dim, N> delF_delU(dim * dim, n_bases * dim);
+		DefGradMatrix<double> def_grad(dim, dim), stress(dim, dim);
+
+		Eigen::Matrix<double, N, 1> gradient(n_bases * dim);
+		gradient.setZero();
+
+		for (int p = 0; p < data.da.size(); ++p)
+		{
+			basis_gradients<n_basis, dim>(data.vals, p, grad);
+
+			// Id + grad d
+			def_grad = local_disp.transpose() * grad + Eigen::Matrix<double, dim, dim>::Identity();
+
+			derived().compute_stress(data.vals.val.row(p), data.t, data.vals.element_id, def_grad, stress);
+
+			deformation_gradient_jacobian<n_basis, dim, N>(grad, delF_delU);
+			gradient += delF_delU.transpose() * (stress.reshaped() * data.da(p));
+		}
+
+		G = gradient;
+	}
+
+	template <typename Derived>
+	template <int n_basis, int dim>
+	void GenericElastic<Derived>::compute_hessian_from_tangent(const NonLinearAssemblerData &data, Eigen::MatrixXd &H) const
+	{
+		constexpr int N = (n_basis == Eigen::Dynamic) ? Eigen::Dynamic : n_basis * dim;
+		const int n_bases = data.vals.basis_values.size();
+
+		const Eigen::Matrix<double, n_basis, dim> local_disp = element_displacement<n_basis, dim>(data);
+
+		Eigen::Matrix<double, n_basis, dim> grad(n_bases, dim);
+		Eigen::Matrix<double, dim * dim, N> delF_delU(dim * dim, n_bases * dim);
+		DefGradMatrix<double> def_grad(dim, dim), stress(dim, dim);
+		Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 9, 9> tangent(dim * dim, dim * dim);
+
+		Eigen::Matrix<double, N, N> hessian(n_bases * dim, n_bases * dim);
+		hessian.setZero();
+
+		for (int p = 0; p < data.da.size(); ++p)
+		{
+			basis_gradients<n_basis, dim>(data.vals, p, grad);
+
+			// Id + grad d
+			def_grad = local_disp.transpose() * grad + Eigen::Matrix<double, dim, dim>::Identity();
+
+			derived().compute_stress_tangent(data.vals.val.row(p), data.t, data.vals.element_id, def_grad, stress, tangent);
+
+			deformation_gradient_jacobian<n_basis, dim, N>(grad, delF_delU);
+			const Eigen::Matrix<double, dim * dim, dim * dim> weighted_tangent = tangent * data.da(p);
+			hessian += delF_delU.transpose() * weighted_tangent * delF_delU;
+		}
+
+		H = hessian;
+	}
+
+	template <typename Derived>
+	void GenericElastic<Derived>::compute_stress(
+		const RowVectorNd &p,
+		const double t,
+		const int el_id,
+		const DefGradMatrix<double> &def_grad,
+		DefGradMatrix<double> &stress) const
+	{
+		typedef DScalar1<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1>> Diff;
+
+		const int dim = def_grad.rows();
+		DiffScalarBase::setVariableCount(dim * dim);
+
+		DefGradMatrix<Diff> F(dim, dim);
+		for (int i = 0; i < dim; ++i)
+			for (int j = 0; j < dim; ++j)
+				F(i, j) = Diff(i + j * dim, def_grad(i, j));
+
+		const Diff energy = derived().elastic_energy(p, t, el_id, F);
+		stress = energy.getGradient().reshaped(dim, dim);
+	}
+
+	template <typename Derived>
+	void GenericElastic<Derived>::compute_stress_tangent(
+		const RowVectorNd &p,
+		const double t,
+		const int el_id,
+		const DefGradMatrix<double> &def_grad,
+		DefGradMatrix<double> &stress,
+		Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 9, 9> &tangent) const
+	{
+		typedef DScalar2<double, Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1>, Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 9, 9>> Diff;
+
+		const int dim = def_grad.rows();
+		DiffScalarBase::setVariableCount(dim * dim);
+
+		DefGradMatrix<Diff> F(dim, dim);
+		for (int i = 0; i < dim; ++i)
+			for (int j = 0; j < dim; ++j)
+				F(i, j) = Diff(i + j * dim, def_grad(i, j));
+
+		const Diff energy = derived().elastic_energy(p, t, el_id, F);
+		stress = energy.getGradient().reshaped(dim, dim);
+		tangent = energy.getHessian();
+	}
+
+	template <typename Derived>
+	Eigen::VectorXd GenericElastic<Derived>::assemble_gradient_autodiff(const NonLinearAssemblerData &data) const
 	{
 		const int n_bases = data.vals.basis_values.size();
 		return polyfem::gradient_from_energy(
@@ -109,7 +326,7 @@ namespace polyfem::assembler
 	}
 
 	template <typename Derived>
-	Eigen::MatrixXd GenericElastic<Derived>::assemble_hessian(const NonLinearAssemblerData &data) const
+	Eigen::MatrixXd GenericElastic<Derived>::assemble_hessian_autodiff(const NonLinearAssemblerData &data) const
 	{
 		const int n_bases = data.vals.basis_values.size();
 		return polyfem::hessian_from_energy(
@@ -25,6 +25,30 @@ namespace polyfem::assembler
 		Eigen::MatrixXd assemble_hessian(const NonLinearAssemblerData &data) const override;
 		Eigen::VectorXd assemble_gradient(const NonLinearAssemblerData &data) const override;
 
+		/// gradient and hessian obtained by differentiating the element energy with respect to all the element dofs,
+		/// much slower than assemble_gradient and assemble_hessian, used for verification
+		Eigen::VectorXd assemble_gradient_autodiff(const NonLinearAssemblerData &data) const;
+		Eigen::MatrixXd assemble_hessian_autodiff(const NonLinearAssemblerData &data) const;
+
+		/// first Piola-Kirchhoff stress P = dW/dF at a point
+		/// the default differentiates the energy with respect to F, derived classes can hide it with a closed form
+		void compute_stress(
+			const RowVectorNd &p,
+			const double t,
+			const int el_id,
+			const DefGradMatrix<double> &def_grad,
+			DefGradMatrix<double> &stress) const;
+
+		/// first Piola-Kirchhoff stress P = dW/dF and tangent dP/dF at a point, F and P are flattened column-wise in the tangent
+		/// the default differentiates the energy with respect to F, derived classes can hide it with a closed form
+		void compute_stress_tangent(
+			const RowVectorNd &p,
+			const double t,
+			const int el_id,
+			const DefGradMatrix<double> &def_grad,
+			DefGradMatrix<double> &stress,
+			Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 9, 9> &tangent) const;
+
 		void assign_stress_tensor(const OutputData &data,
 								  const int all_size,
 								  const ElasticityTensorType &type,
@@ -56,6 +80,13 @@ namespace polyfem::assembler
 		bool allow_inversion() const override { return true; }
 
 	private:
+		// element gradient and hessian from the stress and the tangent at the quadrature points,
+		// the gradient is sum B^T P and the hessian sum B^T C B with B = dF/du
+		template <int n_basis, int dim>
+		void compute_gradient_from_stress(const NonLinearAssemblerData &data, Eigen::VectorXd &G) const;
+		template <int n_basis, int dim>
+		void compute_hessian_from_tangent(const NonLinearAssemblerData &data, Eigen::MatrixXd &H) const;
+
 		// utility function that computes energy, the template is used for double, DScalar1, and DScalar2 in energy, gradient and hessian
 		template <typename T>
 		T compute_energy_aux(const NonLinearAssemblerData &data) const
@@ -23,8 +23,8 @@ namespace polyfem::assembler
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> res(size() * size());
 		res.setZero();
 
-		const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad_t_m;
-		const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad_t_m;
+		const auto gradi = data.vals.grad_t_m(data.i);
+		const auto gradj = data.vals.grad_t_m(data.j);
 
 		Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3> epsi(size(), size());
 		Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3> epsj(size(), size());
@@ -33,7 +33,7 @@ namespace polyfem::assembler
 		{
 
 			double lambda, mu;
-			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+			params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 			for (int di = 0; di < size(); ++di)
 			{
@@ -153,7 +153,7 @@ namespace polyfem::assembler
 		res.setZero();
 
 		const Eigen::MatrixXd &psii = data.psi_vals.basis_values[data.i].val;
-		const Eigen::MatrixXd &gradphij = data.phi_vals.basis_values[data.j].grad_t_m;
+		const auto gradphij = data.phi_vals.grad_t_m(data.j);
 		assert(psii.size() == gradphij.rows());
 		assert(gradphij.cols() == rows());
 
@@ -185,7 +185,7 @@ namespace polyfem::assembler
 		for (long p = 0; p < data.da.size(); ++p)
 		{
 			double lambda, mu;
-			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+			params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 			res += -phii(p) * phij(p) * data.da(p) / lambda;
 		}
@@ -12,8 +12,8 @@ namespace polyfem::assembler
 
 	Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> Laplacian::assemble(const LinearAssemblerData &data) const
 	{
-		const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad_t_m;
-		const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad_t_m;
+		const auto gradi = data.vals.grad_t_m(data.i);
+		const auto gradj = data.vals.grad_t_m(data.j);
 		// return ((gradi.array() * gradj.array()).rowwise().sum().array() * da.array()).colwise().sum();
 		double res = 0;
 		assert(gradi.rows() == data.da.size());
@@ -31,8 +31,8 @@ namespace polyfem
 		LinearElasticity::assemble(const LinearAssemblerData &data) const
 		{
 			// mu ((gradi' gradj) Id + ((gradi gradj')') + lambda gradi *gradj';
-			const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad_t_m;
-			const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad_t_m;
+			const auto gradi = data.vals.grad_t_m(data.i);
+			const auto gradj = data.vals.grad_t_m(data.j);
 
 			Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> res(size() * size());
 			res.setZero();
@@ -45,7 +45,7 @@ namespace polyfem
 				const double dot = gradi.row(k).dot(gradj.row(k));
 
 				double lambda, mu;
-				params_.lambda_mu(data.vals.quadrature.points.row(k), data.vals.val.row(k), data.t, data.vals.element_id, lambda, mu);
+				params_.lambda_mu(data.vals, k, data.t, lambda, mu);
 
 				for (int ii = 0; ii < size(); ++ii)
 				{
@@ -102,6 +102,42 @@ namespace polyfem
 				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::VectorXd, Eigen::MatrixXd>>(data); });
 		}
 
+		double LinearElasticity::compute_batch_energy(const ElementBatch &batch, const double t, const Eigen::MatrixXd &displacement) const
+		{
+			typedef ElementBatch::Lanes Lanes;
+			assert(batch.dim == size());
+
+			std::vector<Lanes> local_disp;
+			batch.gather(displacement, local_disp);
+
+			std::array<Lanes, 9> disp_grad;
+			Lanes lambda, mu;
+			Lanes energy = Lanes::Zero();
+
+			for (int p = 0; p < batch.n_quad; ++p)
+			{
+				batch.displacement_gradient(local_disp, p, disp_grad);
+
+				// eps : eps and tr(eps)
+				Lanes strain_sq = Lanes::Zero();
+				Lanes trace = Lanes::Zero();
+				for (int i = 0; i < size(); ++i)
+				{
+					trace += disp_grad[i + i * size()];
+					for (int j = 0; j < size(); ++j)
+					{
+						const Lanes strain = (disp_grad[i + j * size()] + disp_grad[j + i * size()]) / 2;
+						strain_sq += strain.square();
+					}
+				}
+
+				params_.lambda_mu(batch, p, t, lambda, mu);
+				energy += (mu * strain_sq + lambda / 2 * trace.square()) * batch.da[p];
+			}
+
+			return batch.sum(energy);
+		}
+
 		// Compute \int mu eps : eps + lambda/2 tr(eps)^2 = \int mu tr(eps^2) + lambda/2 tr(eps)^2
 		template <typename T>
 		T LinearElasticity::compute_energy_aux(const NonLinearAssemblerData &data) const
@@ -124,7 +160,7 @@ namespace polyfem
 				const AutoDiffGradMat strain = (disp_grad + disp_grad.transpose()) / T(2);
 
 				double lambda, mu;
-				params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+				params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 				const T val = mu * (strain.transpose() * strain).trace() + lambda / 2 * strain.trace() * strain.trace();
 
@@ -65,8 +65,17 @@ namespace polyfem::assembler
 
 		void update_lame_params(const Eigen::MatrixXd &lambdas, const Eigen::MatrixXd &mus) override
 		{
-			params_.lambda_mat_ = lambdas;
-			params_.mu_mat_ = mus;
+			params_.set_lame_mats(lambdas, mus);
+		}
+
+		void update_material_cache(
+			const bool is_volume,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t) const override
+		{
+			params_.update_quadrature_table(is_volume, bases, gbases, cache, t);
 		}
 
 		virtual bool is_linear() const override { return true; }
@@ -81,6 +90,10 @@ namespace polyfem::assembler
 								  Eigen::MatrixXd &all,
 								  const std::function<Eigen::MatrixXd(const Eigen::MatrixXd &)> &fun) const override;
 
+	protected:
+		bool supports_element_batches() const override { return true; }
+		double compute_batch_energy(const ElementBatch &batch, const double t, const Eigen::MatrixXd &displacement) const override;
+
 	private:
 		// class that stores and compute lame parameters per point
 		LameParameters params_;
@@ -28,6 +28,16 @@ namespace polyfem::assembler
 		/// class that stores and compute density per point
 		const Density &density() const { return density_; }
 
+		void update_material_cache(
+			const bool is_volume,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t) const override
+		{
+			density_.update_quadrature_table(is_volume, bases, gbases, cache, t);
+		}
+
 		std::string name() const override { return "Mass"; }
 		virtual std::map<std::string, ParamFunc> parameters() const override;
 
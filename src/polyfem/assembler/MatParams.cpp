@@ -1,6 +1,11 @@
 #include "MatParams.hpp"
 
+#include <polyfem/assembler/AssemblyValsCache.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+
+#include <algorithm>
+#include <limits>
 
 namespace polyfem::assembler
 {
@@ -20,6 +25,79 @@ namespace polyfem::assembler
 		}
 	} // namespace
 
+	void QuadratureParamTable::build(
+		const bool is_volume,
+		const std::vector<basis::ElementBases> &bases,
+		const std::vector<basis::ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t,
+		const int n_values,
+		const std::function<void(const RowVectorNd &uv, const RowVectorNd &p, double t, int e, double *values)> &eval)
+	{
+		const int n_elements = bases.size();
+
+		t_ = t;
+		n_values_ = n_values;
+
+		// quadrature sizes first, to lay out the table
+		offsets_.resize(n_elements + 1);
+		offsets_[0] = 0;
+		ElementAssemblyValues tmp;
+		for (int e = 0; e < n_elements; ++e)
+		{
+			const int n_quad = cache.is_initialized()
+								   ? cache.get(e).quadrature.points.rows()
+								   : cache.get(e, is_volume, bases[e], gbases[e], tmp).quadrature.points.rows();
+			offsets_[e + 1] = offsets_[e] + n_quad;
+		}
+
+		const int dim = is_volume ? 3 : 2;
+		points_.resize(offsets_.back(), 2 * dim);
+		values_.resize(size_t(offsets_.back()) * n_values_);
+
+		auto storage = utils::create_thread_storage(ElementAssemblyValues());
+		utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+			ElementAssemblyValues &local_vals = utils::get_local_thread_storage(storage, thread_id);
+
+			for (int e = start; e < end; ++e)
+			{
+				const ElementAssemblyValues &vals = cache.get(e, is_volume, bases[e], gbases[e], local_vals);
+				for (int q = 0; q < vals.quadrature.points.rows(); ++q)
+				{
+					const int k = offsets_[e] + q;
+					points_.row(k) << vals.quadrature.points.row(q), vals.val.row(q);
+					eval(vals.quadrature.points.row(q), vals.val.row(q), t, e, values_.data() + size_t(k) * n_values_);
+				}
+			}
+		});
+	}
+
+	void QuadratureParamTable::clear()
+	{
+		offsets_.clear();
+		points_.resize(0, 0);
+		values_.clear();
+	}
+
+	const double *QuadratureParamTable::find(const ElementAssemblyValues &vals, const int q, const double t) const
+	{
+		const int e = vals.element_id;
+		if (t != t_ || e < 0 || e + 1 >= offsets_.size())
+			return nullptr;
+
+		if (offsets_[e + 1] - offsets_[e] != vals.quadrature.points.rows())
+			return nullptr;
+
+		const int k = offsets_[e] + q;
+		const int dim = vals.quadrature.points.cols();
+		if (points_.cols() != 2 * dim
+			|| points_.row(k).head(dim) != vals.quadrature.points.row(q)
+			|| points_.row(k).tail(dim) != vals.val.row(q))
+			return nullptr;
+
+		return values_.data() + size_t(k) * n_values_;
+	}
+
 	GenericMatParam::GenericMatParam(const std::string &param_name)
 		: param_name_(param_name)
 	{
@@ -319,6 +397,9 @@ namespace polyfem::assembler
 		mu_or_nu_.back().init(1.0);
 		size_ = -1;
 		is_lambda_mu_ = true;
+
+		constant_lambda_.push_back(1.0);
+		constant_mu_.push_back(1.0);
 	}
 
 	void LameParameters::lambda_mu(double px, double py, double pz, double x, double y, double z, double t, int el_id, double &lambda, double &mu) const
@@ -327,27 +408,34 @@ namespace polyfem::assembler
 		assert(mu_or_nu_.size() == 1 || el_id < mu_or_nu_.size());
 		assert(size_ == 2 || size_ == 3);
 
-		const auto &tmp1 = lambda_or_E_.size() == 1 ? lambda_or_E_[0] : lambda_or_E_[el_id];
-		const auto &tmp2 = mu_or_nu_.size() == 1 ? mu_or_nu_[0] : mu_or_nu_[el_id];
-
-		double llambda = tmp1(x, y, z, t, el_id);
-		double mmu = tmp2(x, y, z, t, el_id);
-
-		if (!is_lambda_mu_)
+		if (lambda_mat_.size() > el_id && mu_mat_.size() > el_id)
 		{
-			lambda = convert_to_lambda(size_ == 3, llambda, mmu);
-			mu = convert_to_mu(llambda, mmu);
+			lambda = lambda_mat_(el_id);
+			mu = mu_mat_(el_id);
 		}
-		else
+		else if (const int index = constant_lambda_.size() == 1 ? 0 : el_id; !std::isnan(constant_lambda_[index]))
 		{
-			lambda = llambda;
-			mu = mmu;
+			lambda = constant_lambda_[index];
+			mu = constant_mu_[index];
 		}
-
-		if (lambda_mat_.size() > el_id && mu_mat_.size() > el_id)
+		else
 		{
-			lambda = lambda_mat_(el_id);
-			mu = mu_mat_(el_id);
+			const auto &tmp1 = lambda_or_E_.size() == 1 ? lambda_or_E_[0] : lambda_or_E_[el_id];
+			const auto &tmp2 = mu_or_nu_.size() == 1 ? mu_or_nu_[0] : mu_or_nu_[el_id];
+
+			double llambda = tmp1(x, y, z, t, el_id);
+			double mmu = tmp2(x, y, z, t, el_id);
+
+			if (!is_lambda_mu_)
+			{
+				lambda = convert_to_lambda(size_ == 3, llambda, mmu);
+				mu = convert_to_mu(llambda, mmu);
+			}
+			else
+			{
+				lambda = llambda;
+				mu = mmu;
+			}
 		}
 
 		assert(!std::isnan(lambda));
@@ -368,6 +456,8 @@ namespace polyfem::assembler
 			mu_or_nu_.emplace_back();
 		}
 
+		const bool was_lambda_mu = is_lambda_mu_;
+
 		if (params.count("young"))
 		{
 			set_e_nu(index, params["young"], params["nu"], stress_unit);
@@ -385,6 +475,90 @@ namespace polyfem::assembler
 			mu_or_nu_[index].set_unit_type(stress_unit);
 			is_lambda_mu_ = true;
 		}
+
+		// the conversion from E and nu applies to all the materials
+		const int first = was_lambda_mu == is_lambda_mu_ ? constant_lambda_.size() : 0;
+		constant_lambda_.resize(lambda_or_E_.size());
+		constant_mu_.resize(mu_or_nu_.size());
+		for (int i = first; i < lambda_or_E_.size(); ++i)
+			update_constant(i);
+		update_constant(index);
+
+		table_.clear();
+	}
+
+	void LameParameters::lambda_mu(const ElementAssemblyValues &vals, const int q, double t, double &lambda, double &mu) const
+	{
+		if (const double *values = table_.find(vals, q, t))
+		{
+			lambda = values[0];
+			mu = values[1];
+			return;
+		}
+
+		const auto uv = vals.quadrature.points.row(q);
+		const auto p = vals.val.row(q);
+		lambda_mu(
+			uv(0), uv(1), uv.size() == 3 ? uv(2) : 0.0,
+			p(0), p(1), p.size() == 3 ? p(2) : 0.0,
+			t, vals.element_id, lambda, mu);
+	}
+
+	void LameParameters::lambda_mu(const ElementBatch &batch, const int q, double t, ElementBatch::Lanes &lambda, ElementBatch::Lanes &mu) const
+	{
+		// every lane goes through the quadrature table like the per element path
+		for (int l = 0; l < ElementBatch::BATCH_SIZE; ++l)
+			lambda_mu(*batch.vals[l], q, t, lambda(l), mu(l));
+	}
+
+	void LameParameters::update_quadrature_table(
+		const bool is_volume,
+		const std::vector<basis::ElementBases> &bases,
+		const std::vector<basis::ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t) const
+	{
+		table_.clear();
+
+		// constant and per element parameters are already a single load
+		const bool all_constant = std::none_of(constant_lambda_.begin(), constant_lambda_.end(), [](const double v) { return std::isnan(v); });
+		if (all_constant || lambda_mat_.size() > 0)
+			return;
+
+		table_.build(is_volume, bases, gbases, cache, t, 2, [this](const RowVectorNd &uv, const RowVectorNd &p, double t, int e, double *values) {
+			lambda_mu(uv, p, t, e, values[0], values[1]);
+		});
+	}
+
+	void LameParameters::set_lame_mats(const Eigen::MatrixXd &lambdas, const Eigen::MatrixXd &mus)
+	{
+		lambda_mat_ = lambdas;
+		mu_mat_ = mus;
+		table_.clear();
+	}
+
+	void LameParameters::update_constant(const int index)
+	{
+		if (!lambda_or_E_[index].is_constant() || !mu_or_nu_[index].is_constant())
+		{
+			constant_lambda_[index] = std::numeric_limits<double>::quiet_NaN();
+			constant_mu_[index] = std::numeric_limits<double>::quiet_NaN();
+			return;
+		}
+
+		const double llambda = lambda_or_E_[index].constant_value();
+		const double mmu = mu_or_nu_[index].constant_value();
+
+		if (!is_lambda_mu_)
+		{
+			constant_lambda_[index] = convert_to_lambda(size_ == 3, llambda, mmu);
+			constant_mu_[index] = convert_to_mu(llambda, mmu);
+		}
+		else
+		{
+			constant_lambda_[index] = llambda;
+			constant_mu_[index] = mmu;
+		}
 	}
 
 	void LameParameters::set_e_nu(const int index, const json &E, const json &nu, const std::string &stress_unit)
@@ -403,24 +577,60 @@ namespace polyfem::assembler
 	{
 		rho_.emplace_back();
 		rho_.back().init(1.0);
+		constant_rho_.push_back(1.0);
 	}
 
 	double Density::operator()(double px, double py, double pz, double x, double y, double z, double t, int el_id) const
 	{
 		assert(rho_.size() == 1 || el_id < rho_.size());
 
-		const auto &tmp = rho_.size() == 1 ? rho_[0] : rho_[el_id];
-		const double res = tmp(x, y, z, t, el_id);
+		const int index = rho_.size() == 1 ? 0 : el_id;
+		if (!std::isnan(constant_rho_[index]))
+			return constant_rho_[index];
+
+		const double res = rho_[index](x, y, z, t, el_id);
 		assert(!std::isnan(res));
 		assert(!std::isinf(res));
 		return res;
 	}
 
+	double Density::operator()(const ElementAssemblyValues &vals, const int q, double t) const
+	{
+		if (const double *values = table_.find(vals, q, t))
+			return values[0];
+
+		const auto uv = vals.quadrature.points.row(q);
+		const auto p = vals.val.row(q);
+		return (*this)(
+			uv(0), uv(1), uv.size() == 3 ? uv(2) : 0.0,
+			p(0), p(1), p.size() == 3 ? p(2) : 0.0,
+			t, vals.element_id);
+	}
+
+	void Density::update_quadrature_table(
+		const bool is_volume,
+		const std::vector<basis::ElementBases> &bases,
+		const std::vector<basis::ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t) const
+	{
+		table_.clear();
+
+		const bool all_constant = std::none_of(constant_rho_.begin(), constant_rho_.end(), [](const double v) { return std::isnan(v); });
+		if (all_constant)
+			return;
+
+		table_.build(is_volume, bases, gbases, cache, t, 1, [this](const RowVectorNd &uv, const RowVectorNd &p, double t, int e, double *values) {
+			values[0] = (*this)(uv, p, t, e);
+		});
+	}
+
 	void Density::add_multimaterial(const int index, const json &params, const std::string &density_unit)
 	{
 		for (int i = rho_.size(); i <= index; ++i)
 		{
 			rho_.emplace_back();
+			constant_rho_.push_back(0);
 		}
 
 		if (params.count("rho"))
@@ -433,6 +643,14 @@ namespace polyfem::assembler
 		}
 
 		rho_[index].set_unit_type(density_unit);
+
+		update_constant(index);
+		table_.clear();
+	}
+
+	void Density::update_constant(const int index)
+	{
+		constant_rho_[index] = rho_[index].is_constant() ? rho_[index].constant_value() : std::numeric_limits<double>::quiet_NaN();
 	}
 
 	// template instantiation
@@ -3,9 +3,45 @@
 #include <polyfem/Common.hpp>
 #include <polyfem/utils/Types.hpp>
 #include <polyfem/utils/ExpressionValue.hpp>
+#include <polyfem/basis/ElementBases.hpp>
+#include <polyfem/assembler/ElementBatch.hpp>
+
+#include <functional>
 
 namespace polyfem::assembler
 {
+	class ElementAssemblyValues;
+	class AssemblyValsCache;
+
+	/// material parameters evaluated at the quadrature points of every element at a given time
+	class QuadratureParamTable
+	{
+	public:
+		/// evaluates n_values parameters at every quadrature point of the elements
+		/// @param[in] eval function filling the n_values parameters at reference point uv, physical point p, time t, and element e
+		void build(
+			const bool is_volume,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const int n_values,
+			const std::function<void(const RowVectorNd &uv, const RowVectorNd &p, double t, int e, double *values)> &eval);
+
+		void clear();
+		bool empty() const { return offsets_.empty(); }
+
+		/// parameters at the q-th quadrature point of vals at time t, nullptr if they are not in the table
+		const double *find(const ElementAssemblyValues &vals, const int q, const double t) const;
+
+	private:
+		double t_ = 0;
+		int n_values_ = 0;
+		std::vector<int> offsets_;   ///< first quadrature point of every element, size n_elements + 1
+		Eigen::MatrixXd points_;     ///< reference and physical quadrature points, used to validate the lookups
+		std::vector<double> values_; ///< n_values_ entries per quadrature point
+	};
+
 	class GenericMatParam
 	{
 	public:
@@ -83,14 +119,37 @@ namespace polyfem::assembler
 				el_id, lambda, mu);
 		}
 
+		/// lambda and mu at the q-th quadrature point of vals, read from the quadrature table when possible
+		void lambda_mu(const ElementAssemblyValues &vals, const int q, double t, double &lambda, double &mu) const;
+
+		/// lambda and mu at the q-th quadrature point of every lane of batch
+		void lambda_mu(const ElementBatch &batch, const int q, double t, ElementBatch::Lanes &lambda, ElementBatch::Lanes &mu) const;
+
+		/// evaluates lambda and mu at the quadrature points of all elements at time t
+		/// nothing is stored if all the parameters are constant
+		void update_quadrature_table(
+			const bool is_volume,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t) const;
+
+		/// sets per element lambda and mu, overriding the material
+		void set_lame_mats(const Eigen::MatrixXd &lambdas, const Eigen::MatrixXd &mus);
+
 		Eigen::MatrixXd lambda_mat_, mu_mat_;
 
 	private:
 		void set_e_nu(const int index, const json &E, const json &nu, const std::string &stress_unit);
+		void update_constant(const int index);
 
 		int size_;
 		std::vector<utils::ExpressionValue> lambda_or_E_, mu_or_nu_;
 		bool is_lambda_mu_;
+
+		/// lambda and mu of every material with constant parameters, NaN otherwise
+		std::vector<double> constant_lambda_, constant_mu_;
+		mutable QuadratureParamTable table_;
 	};
 
 	class Density
@@ -111,10 +170,27 @@ namespace polyfem::assembler
 						   t, el_id);
 		}
 
+		/// density at the q-th quadrature point of vals, read from the quadrature table when possible
+		double operator()(const ElementAssemblyValues &vals, const int q, double t) const;
+
+		/// evaluates the density at the quadrature points of all elements at time t
+		/// nothing is stored if the density is constant
+		void update_quadrature_table(
+			const bool is_volume,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t) const;
+
 	private:
 		void set_rho(const json &rho);
+		void update_constant(const int index);
 
 		std::vector<utils::ExpressionValue> rho_;
+
+		/// density of every material with constant density, NaN otherwise
+		std::vector<double> constant_rho_;
+		mutable QuadratureParamTable table_;
 	};
 
 	class NoDensity : public Density
@@ -305,6 +305,39 @@ namespace polyfem::assembler
 		return compute_energy_aux<double>(data);
 	}
 
+	double NeoHookeanElasticity::compute_batch_energy(const ElementBatch &batch, const double t, const Eigen::MatrixXd &displacement) const
+	{
+		typedef ElementBatch::Lanes Lanes;
+		assert(batch.dim == size());
+
+		std::vector<Lanes> local_disp;
+		batch.gather(displacement, local_disp);
+
+		std::array<Lanes, 9> def_grad;
+		Lanes lambda, mu;
+		Lanes energy = Lanes::Zero();
+
+		for (int p = 0; p < batch.n_quad; ++p)
+		{
+			batch.displacement_gradient(local_disp, p, def_grad);
+
+			// Id + grad d
+			for (int d = 0; d < size(); ++d)
+				def_grad[d + d * size()] += 1;
+
+			Lanes tr_FtF = Lanes::Zero();
+			for (int k = 0; k < size() * size(); ++k)
+				tr_FtF += def_grad[k].square();
+
+			const Lanes log_det_j = ElementBatch::determinant(def_grad, size()).log();
+
+			params_.lambda_mu(batch, p, t, lambda, mu);
+			energy += (mu / 2 * (tr_FtF - size() - 2 * log_det_j) + lambda / 2 * log_det_j.square()) * batch.da[p];
+		}
+
+		return batch.sum(energy);
+	}
+
 	// Compute ∫ ½μ (tr(FᵀF) - 3 - 2ln(J)) + ½λ ln²(J) du
 	template <typename T>
 	T NeoHookeanElasticity::compute_energy_aux(const NonLinearAssemblerData &data) const
@@ -345,7 +378,7 @@ namespace polyfem::assembler
 				// Id + grad d
 				def_grad = local_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
 				double lambda, mu;
-				params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+				params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 				const T J = use_robust_jacobian ? jacs(p) * jac_it.determinant() : def_grad.determinant();
 				const T log_det_j = log(J);
 				const T val = mu / 2 * ((def_grad.transpose() * def_grad).trace() - size() - 2 * log_det_j) + 
@@ -376,7 +409,7 @@ namespace polyfem::assembler
 					def_grad(d, d) += T(1);
 
 				double lambda, mu;
-				params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+				params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 				const T log_det_j = log(polyfem::utils::determinant(def_grad));
 				const T val = mu / 2 * ((def_grad.transpose() * def_grad).trace() - size() - 2 * log_det_j) + lambda / 2 * log_det_j * log_det_j;
@@ -494,7 +527,7 @@ namespace polyfem::assembler
 			}
 
 			double lambda, mu;
-			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+			params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 			Eigen::Matrix<double, n_basis, dim> delF_delU = grad * jac_it;
 
@@ -598,7 +631,7 @@ namespace polyfem::assembler
 			}
 
 			double lambda, mu;
-			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
+			params_.lambda_mu(data.vals, p, data.t, lambda, mu);
 
 			Eigen::Matrix<double, dim * dim, dim * dim> id = Eigen::Matrix<double, dim * dim, dim * dim>::Identity(size() * size(), size() * size());
 
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace polyfem
+{
+	namespace assembler
+	{
+		/// heap buffer aligned to a cache line, shared so that copies of the owner stay valid
+		template <typename T>
+		class AlignedBuffer
+		{
+		public:
+			static constexpr std::size_t ALIGNMENT = 64;
+
+			void resize(const std::size_t size)
+			{
+				size_ = size;
+				if (size == 0)
+				{
+					data_.reset();
+					return;
+				}
+
+				T *ptr = static_cast<T *>(::operator new[](size * sizeof(T), std::align_val_t(ALIGNMENT)));
+				data_ = std::shared_ptr<T>(ptr, [](T *p) { ::operator delete[](p, std::align_val_t(ALIGNMENT)); });
+			}
+
+			std::size_t size() const { return size_; }
+
+			T *data() { return data_.get(); }
+			const T *data() const { return data_.get(); }
+
+			/// rounds n up so that consecutive chunks of n entries start on a cache line
+			static std::size_t padded(const std::size_t n)
+			{
+				constexpr std::size_t per_line = ALIGNMENT / sizeof(T);
+				return ((n + per_line - 1) / per_line) * per_line;
+			}
+
+		private:
+			std::shared_ptr<T> data_;
+			std::size_t size_ = 0;
+		};
+
+		/// read-only view of the packed basis data of one element
+		/// the memory is owned by AssemblyValsCache, all bases of the element are stored contiguously:
+		/// val is [basis][quad], grad_t_m is [basis][quad][dim],
+		/// the local to global map of basis i is global_index/global_val[global_offset[i], global_offset[i+1])
+		class PackedElementValues
+		{
+		public:
+			int n_bases = 0;
+			int n_quad = 0;
+			int dim = 0;
+
+			const double *val = nullptr;
+			const double *grad_t_m = nullptr;
+
+			const int *global_offset = nullptr;
+			const int *global_index = nullptr;
+			const double *global_val = nullptr;
+
+			bool is_valid() const { return val != nullptr; }
+
+			/// value of basis i at quadrature point q
+			double val_at(const int i, const int q) const
+			{
+				assert(i < n_bases && q < n_quad);
+				return val[i * n_quad + q];
+			}
+
+			/// pointer to the dim entries of J^{-T}*∇φ_i at quadrature point q
+			const double *grad_t_m_at(const int i, const int q) const
+			{
+				assert(i < n_bases && q < n_quad);
+				return grad_t_m + (i * n_quad + q) * dim;
+			}
+		};
+	} // namespace assembler
+} // namespace polyfem
@@ -116,6 +116,7 @@ namespace polyfem::utils
         for (int i = 0; i < old_size; i++)
             for (int d = 0; d < problem_dim_; d++)
                 full_to_periodic_map_(i * problem_dim_ + d) = index_map(i) * problem_dim_ + d;
+        n_periodic_dof_ = full_to_periodic_map_.size() > 0 ? full_to_periodic_map_.maxCoeff() + 1 : 0;
     }
 
     int PeriodicBoundary::full_to_periodic(StiffnessMatrix &A) const
@@ -37,7 +37,14 @@ namespace polyfem::utils
 		Eigen::MatrixXd full_to_periodic(const Eigen::MatrixXd &b, bool accumulate) const;
 		std::vector<int> full_to_periodic(const std::vector<int> &boundary_nodes) const;
 
-        inline int n_periodic_dof() const { return full_to_periodic_map_.maxCoeff() + 1; }
+        inline int n_periodic_dof() const { return n_periodic_dof_; }
+        /// periodic index of a full dof, dofs past the map (e.g., pressure) are shifted after the periodic ones
+        inline int full_to_periodic_index(const int id) const
+        {
+            if (id < full_to_periodic_map_.size())
+                return full_to_periodic_map_(id);
+            return id + n_periodic_dof_ - full_to_periodic_map_.size();
+        }
         inline bool is_periodic_dof(const int idx) const { return periodic_mask_[idx]; }
 
 		Eigen::MatrixXd periodic_to_full(const int ndofs, const Eigen::MatrixXd &x_periodic) const;
@@ -50,6 +57,7 @@ namespace polyfem::utils
     private:
         int problem_dim_;
         Eigen::VectorXi full_to_periodic_map_;
+        int n_periodic_dof_ = 0; ///< number of independent dofs, max of full_to_periodic_map_ plus one
         Eigen::VectorXi periodic_mask_;
 
         Eigen::MatrixXd affine_matrix_; // each column is one periodic direction
@@ -67,14 +67,15 @@ namespace polyfem
 				Eigen::MatrixXd rhs_fun;
 
 				const int n_elements = int(bases_.size());
-				ElementAssemblyValues vals;
-				for (int e = 0; e < n_elements; ++e)
+				ElementAssemblyValues tmp_vals;
+				for (int k = 0; k < n_elements; ++k)
 				{
+					const int e = ass_vals_cache_.ordered_element(k);
 					// vals.compute(e, mesh_.is_volume(), bases_[e], gbases_[e]);
 
 					// compute geometric mapping
 					// evaluate and store basis functions/their gradients at quadrature points
-					ass_vals_cache_.compute(e, mesh_.is_volume(), bases_[e], gbases_[e], vals);
+					const ElementAssemblyValues &vals = ass_vals_cache_.get(e, mesh_.is_volume(), bases_[e], gbases_[e], tmp_vals);
 
 					const Quadrature &quadrature = vals.quadrature;
 
@@ -141,7 +142,7 @@ namespace polyfem
 			Eigen::MatrixXd loc_sol;
 
 			const int n_elements = int(bases_.size());
-			ElementAssemblyValues vals;
+			ElementAssemblyValues tmp_vals;
 			Eigen::MatrixXi ids;
 
 			if (bc_method_ == "sample")
@@ -149,8 +150,6 @@ namespace polyfem
 				for (int e = 0; e < n_elements; ++e)
 				{
 					const basis::ElementBases &bs = bases_[e];
-					// vals.compute(e, mesh_.is_volume(), bases_[e], gbases_[e]);
-					ass_vals_cache_.compute(e, mesh_.is_volume(), bases_[e], gbases_[e], vals);
 					ids.resize(1, 1);
 					ids.setConstant(e);
 
@@ -174,10 +173,11 @@ namespace polyfem
 			else
 			{
 
-				for (int e = 0; e < n_elements; ++e)
+				for (int k = 0; k < n_elements; ++k)
 				{
+					const int e = ass_vals_cache_.ordered_element(k);
 					// vals.compute(e, mesh_.is_volume(), bases_[e], gbases_[e]);
-					ass_vals_cache_.compute(e, mesh_.is_volume(), bases_[e], gbases_[e], vals);
+					const ElementAssemblyValues &vals = ass_vals_cache_.get(e, mesh_.is_volume(), bases_[e], gbases_[e], tmp_vals);
 					ids.resize(vals.val.rows(), 1);
 					ids.setConstant(e);
 
@@ -666,11 +666,11 @@ namespace polyfem
 					VectorNd local_displacement(size_);
 					Eigen::MatrixXd forces;
 
-					for (int e = start; e < end; ++e)
+					for (int k = start; k < end; ++k)
 					{
-						ElementAssemblyValues &vals = local_storage.vals;
+						const int e = ass_vals_cache_.ordered_element(k);
 						// vals.compute(e, mesh_.is_volume(), bases_[e], gbases_[e]);
-						ass_vals_cache_.compute(e, mesh_.is_volume(), bases_[e], gbases_[e], vals);
+						const ElementAssemblyValues &vals = ass_vals_cache_.get(e, mesh_.is_volume(), bases_[e], gbases_[e], local_storage.vals);
 
 						const Quadrature &quadrature = vals.quadrature;
 						const Eigen::VectorXd da = vals.det.array() * quadrature.weights.array();
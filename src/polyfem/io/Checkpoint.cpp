@@ -0,0 +1,406 @@
+#include "Checkpoint.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+namespace polyfem::io
+{
+	namespace
+	{
+		constexpr char MAGIC[8] = {'P', 'F', 'C', 'K', 'P', 'T', '\0', '\1'};
+		constexpr uint32_t VERSION = 1;
+
+		/// 64-bit FNV-1a hash computed on 8-byte words
+		uint64_t checksum(const void *data, const size_t n_bytes)
+		{
+			constexpr uint64_t prime = 0x100000001b3ULL;
+			uint64_t hash = 0xcbf29ce484222325ULL;
+
+			const unsigned char *bytes = static_cast<const unsigned char *>(data);
+			size_t i = 0;
+			for (; i + sizeof(uint64_t) <= n_bytes; i += sizeof(uint64_t))
+			{
+				uint64_t word;
+				std::memcpy(&word, bytes + i, sizeof(uint64_t));
+				hash = (hash ^ word) * prime;
+			}
+			for (; i < n_bytes; ++i)
+				hash = (hash ^ bytes[i]) * prime;
+
+			return hash;
+		}
+
+		template <typename T>
+		void append(std::string &buffer, const T &value)
+		{
+			buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+		}
+
+		void append(std::string &buffer, const std::string &value)
+		{
+			append(buffer, uint32_t(value.size()));
+			buffer.append(value);
+		}
+
+		/// reads a value from the stream and appends its bytes to buffer (to compute the header checksum)
+		template <typename T>
+		T read_value(std::istream &in, std::string &buffer)
+		{
+			T value;
+			if (!in.read(reinterpret_cast<char *>(&value), sizeof(T)))
+				log_and_throw_error("Truncated checkpoint header");
+			append(buffer, value);
+			return value;
+		}
+
+		/// the size is read from the file before the checksum can be verified, it is bounded by the bytes left in the file
+		std::string read_string(std::istream &in, const uint64_t file_size, std::string &buffer)
+		{
+			const uint32_t size = read_value<uint32_t>(in, buffer);
+			const std::streamoff position = in.tellg();
+			if (position < 0 || size > file_size - uint64_t(position))
+				log_and_throw_error("Truncated checkpoint header");
+			std::string value(size, '\0');
+			if (!in.read(value.data(), size))
+				log_and_throw_error("Truncated checkpoint header");
+			buffer.append(value);
+			return value;
+		}
+	} // namespace
+
+	size_t Checkpoint::Entry::n_bytes() const
+	{
+		return size_t(rows) * size_t(cols) * (type == Type::Double ? sizeof(double) : sizeof(int));
+	}
+
+	void Checkpoint::set(const std::string &name, const Eigen::MatrixXd &mat)
+	{
+		Entry entry;
+		entry.type = Type::Double;
+		entry.rows = mat.rows();
+		entry.cols = mat.cols();
+		entry.double_data = mat;
+		entry.in_memory = true;
+		entry.checksum = checksum(mat.data(), entry.n_bytes());
+		entries_[name] = std::move(entry);
+	}
+
+	void Checkpoint::set(const std::string &name, const Eigen::MatrixXi &mat)
+	{
+		Entry entry;
+		entry.type = Type::Int;
+		entry.rows = mat.rows();
+		entry.cols = mat.cols();
+		entry.int_data = mat;
+		entry.in_memory = true;
+		entry.checksum = checksum(mat.data(), entry.n_bytes());
+		entries_[name] = std::move(entry);
+	}
+
+	void Checkpoint::set(const std::string &name, const double value)
+	{
+		set(name, Eigen::MatrixXd(Eigen::MatrixXd::Constant(1, 1, value)));
+	}
+
+	void Checkpoint::set_columns(const std::string &name, const Eigen::MatrixXd &mat)
+	{
+		set(name, Eigen::MatrixXi(Eigen::RowVector2i(mat.rows(), mat.cols())));
+		for (int i = 0; i < mat.cols(); ++i)
+			set(name + "/" + std::to_string(i), Eigen::MatrixXd(mat.col(i)));
+	}
+
+	const Checkpoint::Entry *Checkpoint::find(const std::string &name, const Type type) const
+	{
+		const auto it = entries_.find(name);
+		if (it == entries_.end() || it->second.type != type)
+			return nullptr;
+		return &it->second;
+	}
+
+	bool Checkpoint::get(const std::string &name, Eigen::MatrixXd &mat) const
+	{
+		const Entry *entry = find(name, Type::Double);
+		return entry != nullptr && read(*entry, mat);
+	}
+
+	bool Checkpoint::get(const std::string &name, Eigen::MatrixXi &mat) const
+	{
+		const Entry *entry = find(name, Type::Int);
+		return entry != nullptr && read(*entry, mat);
+	}
+
+	bool Checkpoint::get(const std::string &name, double &value) const
+	{
+		Eigen::MatrixXd mat;
+		if (!get(name, mat) || mat.size() != 1)
+			return false;
+		value = mat(0);
+		return true;
+	}
+
+	bool Checkpoint::get_columns(const std::string &name, Eigen::MatrixXd &mat) const
+	{
+		Eigen::MatrixXi size;
+		if (!get(name, size) || size.size() != 2)
+			return false;
+
+		mat.resize(size(0), size(1));
+		Eigen::MatrixXd col;
+		for (int i = 0; i < mat.cols(); ++i)
+		{
+			if (!get(name + "/" + std::to_string(i), col) || col.size() != mat.rows())
+				return false;
+			mat.col(i) = col;
+		}
+		return true;
+	}
+
+	std::vector<std::string> Checkpoint::names() const
+	{
+		std::vector<std::string> names;
+		names.reserve(entries_.size());
+		for (const auto &[name, _] : entries_)
+			names.push_back(name);
+		return names;
+	}
+
+	template <typename Mat>
+	bool Checkpoint::read(const Entry &entry, Mat &mat) const
+	{
+		if (entry.in_memory)
+		{
+			if constexpr (std::is_same_v<typename Mat::Scalar, double>)
+				mat = entry.double_data;
+			else
+				mat = entry.int_data;
+			return true;
+		}
+
+		std::ifstream in(entry.file, std::ios::in | std::ios::binary);
+		if (!in.good())
+		{
+			logger().error("Unable to open checkpoint {}", entry.file);
+			return false;
+		}
+
+		mat.resize(entry.rows, entry.cols);
+		in.seekg(entry.offset);
+		if (!in.read(reinterpret_cast<char *>(mat.data()), entry.n_bytes()))
+			log_and_throw_error("Truncated checkpoint {}", entry.file);
+
+		if (checksum(mat.data(), entry.n_bytes()) != entry.checksum)
+			log_and_throw_error("Corrupted checkpoint {}, checksum mismatch", entry.file);
+
+		return true;
+	}
+
+	template <typename Mat>
+	bool Checkpoint::same_data(const Entry &entry, const Mat &mat) const
+	{
+		Mat data;
+		return read(entry, data) && data == mat;
+	}
+
+	void Checkpoint::save(const std::string &path, const Checkpoint *base, const std::string &base_path) const
+	{
+		assert(base == nullptr || !base_path.empty());
+
+		// Index the base entries by content to find the unchanged data
+		std::unordered_multimap<uint64_t, const std::pair<const std::string, Entry> *> base_index;
+		if (base != nullptr)
+		{
+			for (const auto &base_entry : base->entries_)
+				base_index.emplace(base_entry.second.checksum, &base_entry);
+		}
+
+		std::string header;
+		header.append(MAGIC, sizeof(MAGIC));
+		append(header, VERSION);
+		append(header, base == nullptr ? std::string() : std::filesystem::proximate(base_path, std::filesystem::path(path).parent_path()).string());
+		append(header, uint64_t(entries_.size()));
+
+		std::vector<const Entry *> data_entries;
+		uint64_t offset = 0;
+		for (const auto &[name, entry] : entries_)
+		{
+			const std::string *ref = nullptr;
+			const auto range = base_index.equal_range(entry.checksum);
+			for (auto it = range.first; it != range.second && ref == nullptr; ++it)
+			{
+				const Entry &other = it->second->second;
+				if (other.type != entry.type || other.rows != entry.rows || other.cols != entry.cols)
+					continue;
+
+				Eigen::MatrixXd double_data;
+				Eigen::MatrixXi int_data;
+				if (entry.type == Type::Double && read(entry, double_data) && base->same_data(other, double_data))
+					ref = &it->second->first;
+				else if (entry.type == Type::Int && read(entry, int_data) && base->same_data(other, int_data))
+					ref = &it->second->first;
+			}
+
+			append(header, name);
+			append(header, uint8_t(entry.type));
+			append(header, uint8_t(ref != nullptr));
+			append(header, entry.rows);
+			append(header, entry.cols);
+			append(header, entry.checksum);
+			if (ref != nullptr)
+			{
+				append(header, *ref);
+			}
+			else
+			{
+				append(header, offset);
+				offset += entry.n_bytes();
+				data_entries.push_back(&entry);
+			}
+		}
+		append(header, checksum(header.data(), header.size()));
+
+		// Write to a temporary file first so an interrupted save does not destroy the previous checkpoint
+		const std::string tmp_path = path + ".tmp";
+		{
+			std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!out.good())
+				log_and_throw_error("Unable to write checkpoint {}", path);
+
+			out.write(header.data(), header.size());
+			for (const Entry *entry : data_entries)
+			{
+				if (entry->type == Type::Double)
+				{
+					Eigen::MatrixXd data;
+					read(*entry, data);
+					out.write(reinterpret_cast<const char *>(data.data()), entry->n_bytes());
+				}
+				else
+				{
+					Eigen::MatrixXi data;
+					read(*entry, data);
+					out.write(reinterpret_cast<const char *>(data.data()), entry->n_bytes());
+				}
+			}
+
+			if (!out.good())
+				log_and_throw_error("Unable to write checkpoint {}", path);
+		}
+		std::filesystem::rename(tmp_path, path);
+
+		saved_bytes_ = offset;
+		logger().debug("Saved checkpoint {} ({} entries, {} bytes of data, {} references)",
+					   path, entries_.size(), offset, entries_.size() - data_entries.size());
+	}
+
+	void Checkpoint::load(const std::string &path)
+	{
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in.good())
+			log_and_throw_error("Unable to open checkpoint {}", path);
+		const uint64_t file_size = std::filesystem::file_size(path);
+
+		std::string header;
+		char magic[sizeof(MAGIC)];
+		if (!in.read(magic, sizeof(MAGIC)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+			log_and_throw_error("{} is not a checkpoint", path);
+		header.append(magic, sizeof(MAGIC));
+
+		const uint32_t version = read_value<uint32_t>(in, header);
+		if (version != VERSION)
+			log_and_throw_error("Unsupported checkpoint version {} in {}", version, path);
+
+		const std::string base_path = read_string(in, file_size, header);
+		const uint64_t n_entries = read_value<uint64_t>(in, header);
+
+		std::map<std::string, Entry> entries;
+		std::map<std::string, std::string> refs;
+		for (uint64_t i = 0; i < n_entries; ++i)
+		{
+			const std::string name = read_string(in, file_size, header);
+
+			Entry entry;
+			const uint8_t type = read_value<uint8_t>(in, header);
+			if (type != uint8_t(Type::Double) && type != uint8_t(Type::Int))
+				log_and_throw_error("Invalid entry type in checkpoint {}", path);
+			entry.type = Type(type);
+			const bool is_ref = read_value<uint8_t>(in, header);
+			entry.rows = read_value<int64_t>(in, header);
+			entry.cols = read_value<int64_t>(in, header);
+			if (entry.rows < 0 || entry.cols < 0 || (entry.cols > 0 && uint64_t(entry.rows) > file_size / uint64_t(entry.cols)))
+				log_and_throw_error("Invalid entry size in checkpoint {}", path);
+			entry.checksum = read_value<uint64_t>(in, header);
+
+			if (is_ref)
+				refs[name] = read_string(in, file_size, header);
+			else
+			{
+				entry.file = path;
+				entry.offset = read_value<uint64_t>(in, header);
+			}
+
+			entries[name] = std::move(entry);
+		}
+
+		const uint64_t header_checksum = checksum(header.data(), header.size());
+		if (read_value<uint64_t>(in, header) != header_checksum)
+			log_and_throw_error("Corrupted checkpoint {}, header checksum mismatch", path);
+
+		const uint64_t data_start = in.tellg();
+		for (auto &[name, entry] : entries)
+		{
+			if (refs.find(name) != refs.end())
+				continue;
+			// the data is read (and allocated) later, make sure it lies in the file
+			if (entry.offset > file_size - data_start || entry.n_bytes() > file_size - data_start - entry.offset)
+				log_and_throw_error("Truncated checkpoint {}", path);
+			entry.offset += data_start;
+		}
+
+		if (!refs.empty())
+		{
+			if (base_path.empty())
+				log_and_throw_error("Checkpoint {} has references but no base checkpoint", path);
+
+			std::filesystem::path resolved_base_path(base_path);
+			if (resolved_base_path.is_relative())
+				resolved_base_path = std::filesystem::path(path).parent_path() / resolved_base_path;
+
+			Checkpoint base;
+			base.load(resolved_base_path.string());
+
+			for (const auto &[name, ref] : refs)
+			{
+				const auto it = base.entries_.find(ref);
+				if (it == base.entries_.end())
+					log_and_throw_error("Missing entry {} in base checkpoint {}", ref, resolved_base_path.string());
+
+				Entry &entry = entries.at(name);
+				const Entry &base_entry = it->second;
+				if (base_entry.type != entry.type || base_entry.rows != entry.rows
+					|| base_entry.cols != entry.cols || base_entry.checksum != entry.checksum)
+					log_and_throw_error("Entry {} of base checkpoint {} does not match {}", ref, resolved_base_path.string(), name);
+
+				entry = base_entry;
+			}
+		}
+
+		entries_ = std::move(entries);
+	}
+
+	bool Checkpoint::is_checkpoint(const std::string &path)
+	{
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		char magic[sizeof(MAGIC)];
+		return in.good() && in.read(magic, sizeof(MAGIC)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+	}
+
+	bool Checkpoint::has_checkpoint_extension(const std::string &path)
+	{
+		return std::filesystem::path(path).extension() == ".ckpt";
+	}
+} // namespace polyfem::io
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace polyfem::io
+{
+	/// Single-file binary checkpoint of named dense arrays (double or int), used to restart simulations.
+	///
+	/// The file starts with a header listing every entry (name, type, size, checksum, and data offset)
+	/// followed by the raw column-major data. The header and every entry are checksummed and verified on read.
+	/// Loading only reads the header: the data of an entry is read when it is requested.
+	///
+	/// A delta checkpoint is written relative to a base checkpoint: entries whose data already exists in the
+	/// base (under any name) are stored as references to it, so they are neither rewritten nor duplicated.
+	class Checkpoint
+	{
+	public:
+		/// @brief add (or replace) an entry
+		/// @param[in] name entry name
+		/// @param[in] mat entry value
+		void set(const std::string &name, const Eigen::MatrixXd &mat);
+		void set(const std::string &name, const Eigen::MatrixXi &mat);
+		void set(const std::string &name, const double value);
+
+		/// @brief add the columns of mat as separate entries name/0, name/1, ... so that delta checkpoints
+		/// can share them (e.g., the history of a time integrator shifts by one column every step)
+		/// @param[in] name entry name
+		/// @param[in] mat entry value
+		void set_columns(const std::string &name, const Eigen::MatrixXd &mat);
+
+		/// @brief check if an entry exists
+		/// @param[in] name entry name
+		bool has(const std::string &name) const { return entries_.find(name) != entries_.end(); }
+
+		/// @brief get the value of an entry, reading it from the file if needed
+		/// @param[in] name entry name
+		/// @param[out] mat entry value
+		/// @return false if the entry does not exist or has a different type
+		bool get(const std::string &name, Eigen::MatrixXd &mat) const;
+		bool get(const std::string &name, Eigen::MatrixXi &mat) const;
+		bool get(const std::string &name, double &value) const;
+
+		/// @brief get the columns stored with set_columns
+		/// @param[in] name entry name
+		/// @param[out] mat entry value
+		/// @return false if the entry does not exist
+		bool get_columns(const std::string &name, Eigen::MatrixXd &mat) const;
+
+		/// @brief names of all the entries
+		std::vector<std::string> names() const;
+
+		/// @brief write the checkpoint to a file
+		/// @param[in] path output path
+		/// @param[in] base checkpoint already saved at base_path, if not null writes a delta checkpoint
+		/// @param[in] base_path path of the base checkpoint
+		void save(const std::string &path, const Checkpoint *base = nullptr, const std::string &base_path = "") const;
+
+		/// @brief read the header of a checkpoint (and of its base checkpoints), throws if the file is invalid
+		/// @param[in] path checkpoint path
+		void load(const std::string &path);
+
+		/// @brief number of bytes of data written by the last save (i.e., excluding references)
+		size_t saved_bytes() const { return saved_bytes_; }
+
+		/// @brief check if a file is a checkpoint
+		/// @param[in] path file path
+		static bool is_checkpoint(const std::string &path);
+
+		/// @brief check if a path has the checkpoint file extension (.ckpt)
+		/// @param[in] path file path
+		static bool has_checkpoint_extension(const std::string &path);
+
+	private:
+		enum class Type : uint8_t
+		{
+			Double = 0,
+			Int = 1
+		};
+
+		struct Entry
+		{
+			Type type = Type::Double;
+			int64_t rows = 0;
+			int64_t cols = 0;
+			uint64_t checksum = 0;
+
+			/// in-memory data
+			Eigen::MatrixXd double_data;
+			Eigen::MatrixXi int_data;
+			bool in_memory = false;
+
+			/// location of the data when loaded from a file
+			std::string file;
+			uint64_t offset = 0;
+
+			size_t n_bytes() const;
+		};
+
+		const Entry *find(const std::string &name, const Type type) const;
+		template <typename Mat>
+		bool read(const Entry &entry, Mat &mat) const;
+		template <typename Mat>
+		bool same_data(const Entry &entry, const Mat &mat) const;
+
+		std::map<std::string, Entry> entries_;
+		mutable size_t saved_bytes_ = 0;
+	};
+} // namespace polyfem::io
@@ -15,6 +15,7 @@
 #include <polyfem/autogen/auto_q_bases.hpp>
 
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <igl/AABB.h>
 #include <igl/per_face_normals.h>
@@ -52,6 +53,121 @@ namespace polyfem::io
 				logger().error("Invalid tensor dimensions.");
 			}
 		}
+
+		/// samples the local visualization points of every element, elements that are not exported get no points
+		/// this is done serially since the polygon samplers are not thread safe
+		/// @param[out] local_pts points in the reference element for every element
+		/// @param[out] offsets index of the first point of every element, the last entry is the total number of points
+		void sample_local_points(
+			const Mesh &mesh,
+			const int n_elements,
+			const Eigen::VectorXi &disc_orders,
+			const std::map<int, Eigen::MatrixXd> &polys,
+			const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d,
+			const utils::RefElementSampler &sampler,
+			const bool use_sampler,
+			const bool boundary_only,
+			std::vector<Eigen::MatrixXd> &local_pts,
+			std::vector<int> &offsets)
+		{
+			local_pts.assign(n_elements, Eigen::MatrixXd());
+			offsets.assign(n_elements + 1, 0);
+
+			Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
+
+			for (int i = 0; i < n_elements; ++i)
+			{
+				offsets[i + 1] = offsets[i];
+
+				if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
+					continue;
+
+				if (use_sampler)
+				{
+					if (mesh.is_simplex(i))
+						local_pts[i] = sampler.simplex_points();
+					else if (mesh.is_cube(i))
+						local_pts[i] = sampler.cube_points();
+					else
+					{
+						if (mesh.is_volume())
+							sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts[i], vis_faces_poly, vis_edges_poly);
+						else
+							sampler.sample_polygon(polys.at(i), local_pts[i], vis_faces_poly, vis_edges_poly);
+					}
+				}
+				else
+				{
+					if (mesh.is_volume())
+					{
+						if (mesh.is_simplex(i))
+							autogen::p_nodes_3d(disc_orders(i), local_pts[i]);
+						else if (mesh.is_cube(i))
+							autogen::q_nodes_3d(disc_orders(i), local_pts[i]);
+						else
+							continue;
+					}
+					else
+					{
+						if (mesh.is_simplex(i))
+							autogen::p_nodes_2d(disc_orders(i), local_pts[i]);
+						else if (mesh.is_cube(i))
+							autogen::q_nodes_2d(disc_orders(i), local_pts[i]);
+						else
+							continue;
+					}
+				}
+
+				offsets[i + 1] += local_pts[i].rows();
+			}
+		}
+
+		/// evaluates a per-point quantity on every element in parallel and merges the results in element order
+		/// @param[in] offsets index of the first point of every element, from sample_local_points
+		/// @param[in] n_points number of rows of the output
+		/// @param[in] eval evaluates the quantities of an element
+		/// @param[out] result merged quantities
+		void evaluate_and_merge(
+			const std::vector<int> &offsets,
+			const int n_points,
+			const std::function<void(int, std::vector<assembler::Assembler::NamedMatrix> &)> &eval,
+			std::vector<assembler::Assembler::NamedMatrix> &result)
+		{
+			const int n_elements = offsets.size() - 1;
+			std::vector<std::vector<assembler::Assembler::NamedMatrix>> local_results(n_elements);
+
+			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+				for (int i = start; i < end; ++i)
+				{
+					if (offsets[i + 1] > offsets[i])
+						eval(i, local_results[i]);
+				}
+			});
+
+			result.clear();
+			for (int i = 0; i < n_elements; ++i)
+			{
+				if (offsets[i + 1] == offsets[i])
+					continue;
+
+				const auto &local = local_results[i];
+				if (result.empty())
+				{
+					result.resize(local.size());
+					for (int k = 0; k < local.size(); ++k)
+					{
+						result[k].first = local[k].first;
+						result[k].second.resize(n_points, local[k].second.cols());
+					}
+				}
+
+				for (int k = 0; k < local.size(); ++k)
+				{
+					assert(offsets[i + 1] - offsets[i] == local[k].second.rows());
+					result[k].second.block(offsets[i], 0, local[k].second.rows(), local[k].second.cols()) = local[k].second;
+				}
+			}
+		}
 	} // namespace
 
 	void Evaluator::interpolate_boundary_function(
@@ -185,50 +301,64 @@ namespace polyfem::io
 
 		assert(!is_problem_scalar);
 		const int actual_dim = mesh.dimension();
+		const int n_elements = bases.size();
 
-		std::vector<Eigen::MatrixXd> avg_scalar;
-
-		Eigen::MatrixXd areas(n_bases, 1);
-		areas.setZero();
-
-		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_s;
-		Eigen::MatrixXd local_val;
+		// evaluate the elements in parallel, the averages are accumulated serially in element order
+		std::vector<double> element_areas(n_elements, 0);
+		std::vector<std::vector<assembler::Assembler::NamedMatrix>> element_scalars(n_elements);
 
-		ElementAssemblyValues vals;
-		for (int i = 0; i < int(bases.size()); ++i)
-		{
-			const ElementBases &bs = bases[i];
-			const ElementBases &gbs = gbases[i];
+		auto storage = utils::create_thread_storage(ElementAssemblyValues());
+		utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
+			ElementAssemblyValues &vals = utils::get_local_thread_storage(storage, thread_id);
 			Eigen::MatrixXd local_pts;
 
-			if (mesh.is_simplex(i))
+			for (int i = start; i < end; ++i)
 			{
-				if (mesh.dimension() == 3)
-					autogen::p_nodes_3d(disc_orders(i), local_pts);
-				else
-					autogen::p_nodes_2d(disc_orders(i), local_pts);
-			}
-			else if (mesh.is_cube(i))
-			{
-				if (mesh.dimension() == 3)
-					autogen::q_nodes_3d(disc_orders(i), local_pts);
+				if (mesh.is_simplex(i))
+				{
+					if (mesh.dimension() == 3)
+						autogen::p_nodes_3d(disc_orders(i), local_pts);
+					else
+						autogen::p_nodes_2d(disc_orders(i), local_pts);
+				}
+				else if (mesh.is_cube(i))
+				{
+					if (mesh.dimension() == 3)
+						autogen::q_nodes_3d(disc_orders(i), local_pts);
+					else
+						autogen::q_nodes_2d(disc_orders(i), local_pts);
+				}
 				else
-					autogen::q_nodes_2d(disc_orders(i), local_pts);
-			}
-			else
-			{
-				// not supported for polys
-				continue;
+				{
+					// not supported for polys
+					continue;
+				}
+
+				vals.compute(i, actual_dim == 3, bases[i], gbases[i]);
+				const quadrature::Quadrature &quadrature = vals.quadrature;
+				element_areas[i] = (vals.det.array() * quadrature.weights.array()).sum();
+
+				assembler.compute_scalar_value(OutputData(t, i, bases[i], gbases[i], local_pts, fun), element_scalars[i]);
+
+				// assembler.compute_tensor_value(i, bs, gbs, local_pts, fun, local_val);
+				// MatrixXd avg_tensor(n_points * actual_dim*actual_dim, 1);
 			}
+		});
 
-			vals.compute(i, actual_dim == 3, bases[i], gbases[i]);
-			const quadrature::Quadrature &quadrature = vals.quadrature;
-			const double area = (vals.det.array() * quadrature.weights.array()).sum();
+		std::vector<Eigen::MatrixXd> avg_scalar;
+		std::vector<std::string> names;
 
-			assembler.compute_scalar_value(OutputData(t, i, bs, gbs, local_pts, fun), tmp_s);
+		Eigen::MatrixXd areas(n_bases, 1);
+		areas.setZero();
 
-			// assembler.compute_tensor_value(i, bs, gbs, local_pts, fun, local_val);
-			// MatrixXd avg_tensor(n_points * actual_dim*actual_dim, 1);
+		for (int i = 0; i < n_elements; ++i)
+		{
+			const ElementBases &bs = bases[i];
+			const std::vector<assembler::Assembler::NamedMatrix> &tmp_s = element_scalars[i];
+			const double area = element_areas[i];
+
+			if (tmp_s.empty())
+				continue;
 
 			for (size_t j = 0; j < bs.bases.size(); ++j)
 			{
@@ -248,11 +378,14 @@ namespace polyfem::io
 					m.resize(n_bases, 1);
 					m.setZero();
 				}
+
+				for (const auto &s : tmp_s)
+					names.push_back(s.first);
 			}
 
 			for (int k = 0; k < tmp_s.size(); ++k)
 			{
-				local_val = tmp_s[k].second;
+				const Eigen::MatrixXd &local_val = tmp_s[k].second;
 
 				for (size_t j = 0; j < bs.bases.size(); ++j)
 				{
@@ -271,10 +404,10 @@ namespace polyfem::io
 			m.array() /= areas.array();
 		}
 
-		result_scalar.resize(tmp_s.size());
-		for (int k = 0; k < tmp_s.size(); ++k)
+		result_scalar.resize(names.size());
+		for (int k = 0; k < names.size(); ++k)
 		{
-			result_scalar[k].first = tmp_s[k].first;
+			result_scalar[k].first = names[k];
 			interpolate_function(mesh, 1, bases, disc_orders, polys, polys_3d, sampler, n_points,
 								 avg_scalar[k], result_scalar[k].second, use_sampler, boundary_only);
 		}
@@ -498,74 +631,99 @@ namespace polyfem::io
 			return;
 		}
 
-		std::vector<AssemblyValues> tmp;
+		std::vector<Eigen::MatrixXd> local_pts;
+		std::vector<int> offsets;
+		sample_local_points(mesh, basis.size(), disc_orders, polys, polys_3d, sampler,
+							use_sampler, boundary_only, local_pts, offsets);
+		assert(offsets.back() <= n_points);
 
 		result.resize(n_points, actual_dim);
 
-		int index = 0;
-
-		Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
+		auto storage = utils::create_thread_storage(std::vector<AssemblyValues>());
+		utils::maybe_parallel_for(basis.size(), [&](int start, int end, int thread_id) {
+			std::vector<AssemblyValues> &tmp = utils::get_local_thread_storage(storage, thread_id);
 
-		for (int i = 0; i < int(basis.size()); ++i)
-		{
-			const ElementBases &bs = basis[i];
-			Eigen::MatrixXd local_pts;
+			for (int i = start; i < end; ++i)
+			{
+				if (local_pts[i].rows() == 0)
+					continue;
 
-			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
-				continue;
+				const ElementBases &bs = basis[i];
 
-			if (use_sampler)
-			{
-				if (mesh.is_simplex(i))
-					local_pts = sampler.simplex_points();
-				else if (mesh.is_cube(i))
-					local_pts = sampler.cube_points();
-				else
-				{
-					if (mesh.is_volume())
-						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
-					else
-						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
-				}
-			}
-			else
-			{
-				if (mesh.is_volume())
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_3d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_3d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-				else
+				Eigen::MatrixXd local_res = Eigen::MatrixXd::Zero(local_pts[i].rows(), actual_dim);
+				bs.evaluate_bases(local_pts[i], tmp);
+				for (size_t j = 0; j < bs.bases.size(); ++j)
 				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_2d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_2d(disc_orders(i), local_pts);
-					else
-						continue;
+					const Basis &b = bs.bases[j];
+
+					for (int d = 0; d < actual_dim; ++d)
+					{
+						for (size_t ii = 0; ii < b.global().size(); ++ii)
+							local_res.col(d) += b.global()[ii].val * tmp[j].val * fun(b.global()[ii].index * actual_dim + d);
+					}
 				}
+
+				result.block(offsets[i], 0, local_res.rows(), actual_dim) = local_res;
 			}
+		});
+	}
 
-			Eigen::MatrixXd local_res = Eigen::MatrixXd::Zero(local_pts.rows(), actual_dim);
-			bs.evaluate_bases(local_pts, tmp);
-			for (size_t j = 0; j < bs.bases.size(); ++j)
+	void Evaluator::interpolation_matrix(
+		const mesh::Mesh &mesh,
+		const std::vector<basis::ElementBases> &basis,
+		const Eigen::VectorXi &disc_orders,
+		const std::map<int, Eigen::MatrixXd> &polys,
+		const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d,
+		const utils::RefElementSampler &sampler,
+		const int n_points,
+		const int n_bases,
+		StiffnessMatrix &result,
+		const bool use_sampler,
+		const bool boundary_only)
+	{
+		std::vector<Eigen::MatrixXd> local_pts;
+		std::vector<int> offsets;
+		sample_local_points(mesh, basis.size(), disc_orders, polys, polys_3d, sampler,
+							use_sampler, boundary_only, local_pts, offsets);
+		assert(offsets.back() == n_points);
+
+		// the entries of an element are all generated by the same thread, so duplicates are summed in a fixed order
+		struct LocalThreadStorage
+		{
+			std::vector<AssemblyValues> tmp;
+			std::vector<Eigen::Triplet<double>> entries;
+		};
+
+		auto storage = utils::create_thread_storage(LocalThreadStorage());
+		utils::maybe_parallel_for(basis.size(), [&](int start, int end, int thread_id) {
+			LocalThreadStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+
+			for (int i = start; i < end; ++i)
 			{
-				const Basis &b = bs.bases[j];
+				if (local_pts[i].rows() == 0)
+					continue;
 
-				for (int d = 0; d < actual_dim; ++d)
+				const ElementBases &bs = basis[i];
+				bs.evaluate_bases(local_pts[i], local_storage.tmp);
+				for (size_t j = 0; j < bs.bases.size(); ++j)
 				{
+					const Basis &b = bs.bases[j];
+
 					for (size_t ii = 0; ii < b.global().size(); ++ii)
-						local_res.col(d) += b.global()[ii].val * tmp[j].val * fun(b.global()[ii].index * actual_dim + d);
+					{
+						for (int k = 0; k < local_pts[i].rows(); ++k)
+							local_storage.entries.emplace_back(offsets[i] + k, b.global()[ii].index, b.global()[ii].val * local_storage.tmp[j].val(k));
+					}
 				}
 			}
+		});
 
-			result.block(index, 0, local_res.rows(), actual_dim) = local_res;
-			index += local_res.rows();
-		}
+		std::vector<Eigen::Triplet<double>> entries;
+		for (const LocalThreadStorage &local_storage : storage)
+			entries.insert(entries.end(), local_storage.entries.begin(), local_storage.entries.end());
+
+		result.resize(n_points, n_bases);
+		result.setFromTriplets(entries.begin(), entries.end());
 	}
 
 	void Evaluator::interpolate_at_local_vals(
@@ -656,13 +814,14 @@ namespace polyfem::io
 		for (int i = 0; i < n_loc_bases; ++i)
 		{
 			const auto &val = vals.basis_values[i];
+			const auto grad_t_m = vals.grad_t_m(i);
 
 			for (size_t ii = 0; ii < val.global.size(); ++ii)
 			{
 				for (int d = 0; d < actual_dim; ++d)
 				{
 					result.col(d) += val.global[ii].val * fun(val.global[ii].index * actual_dim + d) * val.val;
-					result_grad.block(0, d * val.grad_t_m.cols(), result_grad.rows(), val.grad_t_m.cols()) += val.global[ii].val * fun(val.global[ii].index * actual_dim + d) * val.grad_t_m;
+					result_grad.block(0, d * grad_t_m.cols(), result_grad.rows(), grad_t_m.cols()) += val.global[ii].val * fun(val.global[ii].index * actual_dim + d) * grad_t_m;
 				}
 			}
 		}
@@ -777,75 +936,18 @@ namespace polyfem::io
 
 		assert(!is_problem_scalar);
 
-		int index = 0;
-
-		Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
-		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_s;
-
-		for (int i = 0; i < int(bases.size()); ++i)
-		{
-			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
-				continue;
-
-			const ElementBases &bs = bases[i];
-			const ElementBases &gbs = gbases[i];
-			Eigen::MatrixXd local_pts;
-
-			if (use_sampler)
-			{
-				if (mesh.is_simplex(i))
-					local_pts = sampler.simplex_points();
-				else if (mesh.is_cube(i))
-					local_pts = sampler.cube_points();
-				else
-				{
-					if (mesh.is_volume())
-						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
-					else
-						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
-				}
-			}
-			else
-			{
-				if (mesh.is_volume())
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_3d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_3d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-				else
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_2d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_2d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-			}
-
-			assembler.compute_scalar_value(OutputData(t, i, bs, gbs, local_pts, fun), tmp_s);
-
-			if (result.empty())
-			{
-				result.resize(tmp_s.size());
-				for (int k = 0; k < tmp_s.size(); ++k)
-				{
-					result[k].first = tmp_s[k].first;
-					result[k].second.resize(n_points, 1);
-				}
-			}
-
-			for (int k = 0; k < tmp_s.size(); ++k)
-			{
-				assert(local_pts.rows() == tmp_s[k].second.rows());
-				result[k].second.block(index, 0, tmp_s[k].second.rows(), 1) = tmp_s[k].second;
-			}
-			index += local_pts.rows();
-		}
+		std::vector<Eigen::MatrixXd> local_pts;
+		std::vector<int> offsets;
+		sample_local_points(mesh, bases.size(), disc_orders, polys, polys_3d, sampler,
+							use_sampler, boundary_only, local_pts, offsets);
+		assert(offsets.back() <= n_points);
+
+		evaluate_and_merge(
+			offsets, n_points,
+			[&](int i, std::vector<assembler::Assembler::NamedMatrix> &tmp_s) {
+				assembler.compute_scalar_value(OutputData(t, i, bases[i], gbases[i], local_pts[i], fun), tmp_s);
+			},
+			result);
 	}
 
 	void Evaluator::compute_tensor_value(
@@ -873,78 +975,20 @@ namespace polyfem::io
 
 		result.clear();
 
-		const int actual_dim = mesh.dimension();
 		assert(!is_problem_scalar);
 
-		int index = 0;
-
-		Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
-		std::vector<std::pair<std::string, Eigen::MatrixXd>> tmp_t;
-
-		for (int i = 0; i < int(bases.size()); ++i)
-		{
-			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
-				continue;
-
-			const ElementBases &bs = bases[i];
-			const ElementBases &gbs = gbases[i];
-			Eigen::MatrixXd local_pts;
-
-			if (use_sampler)
-			{
-				if (mesh.is_simplex(i))
-					local_pts = sampler.simplex_points();
-				else if (mesh.is_cube(i))
-					local_pts = sampler.cube_points();
-				else
-				{
-					if (mesh.is_volume())
-						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
-					else
-						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
-				}
-			}
-			else
-			{
-				if (mesh.is_volume())
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_3d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_3d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-				else
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_2d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_2d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-			}
-
-			assembler.compute_tensor_value(OutputData(t, i, bs, gbs, local_pts, fun), tmp_t);
-
-			if (result.empty())
-			{
-				result.resize(tmp_t.size());
-				for (int k = 0; k < tmp_t.size(); ++k)
-				{
-					result[k].first = tmp_t[k].first;
-					result[k].second.resize(n_points, actual_dim * actual_dim);
-				}
-			}
-
-			for (int k = 0; k < tmp_t.size(); ++k)
-			{
-				assert(local_pts.rows() == tmp_t[k].second.rows());
-				result[k].second.block(index, 0, tmp_t[k].second.rows(), tmp_t[k].second.cols()) = tmp_t[k].second;
-			}
-			index += local_pts.rows();
-		}
+		std::vector<Eigen::MatrixXd> local_pts;
+		std::vector<int> offsets;
+		sample_local_points(mesh, bases.size(), disc_orders, polys, polys_3d, sampler,
+							use_sampler, boundary_only, local_pts, offsets);
+		assert(offsets.back() <= n_points);
+
+		evaluate_and_merge(
+			offsets, n_points,
+			[&](int i, std::vector<assembler::Assembler::NamedMatrix> &tmp_t) {
+				assembler.compute_tensor_value(OutputData(t, i, bases[i], gbases[i], local_pts[i], fun), tmp_t);
+			},
+			result);
 	}
 
 	Eigen::MatrixXd Evaluator::get_bases_position(
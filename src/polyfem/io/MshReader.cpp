@@ -1,13 +1,18 @@
 #include "MshReader.hpp"
 
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 #include <polyfem/utils/StringUtils.hpp>
 
 #include <mshio/mshio.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <string>
 #include <iostream>
+#include <unordered_map>
 #include <vector>
 
 #include <filesystem> // filesystem
@@ -26,15 +31,415 @@ namespace polyfem::io
 		}
 	}
 
+	namespace
+	{
+		/// number of columns of cells for the supported element types, -1 for the other types
+		int cell_columns(const int type)
+		{
+			if (type == 2 || type == 9 || type == 21 || type == 23 || type == 25) // tri
+				return 3;
+			if (type == 3 || type == 10) // quad
+				return 4;
+			if (type == 4 || type == 11 || type == 29 || type == 30 || type == 31) // tet
+				return 4;
+			if (type == 5 || type == 12) // hex
+				return 8;
+			return -1;
+		}
+
+		/// number of nodes or elements converted at once, bounds the size of the read buffers
+		constexpr size_t CHUNK_SIZE = size_t(1) << 16;
+
+		template <typename T>
+		bool read_binary(std::istream &in, T *data, const size_t n)
+		{
+			return bool(in.read(reinterpret_cast<char *>(data), n * sizeof(T)));
+		}
+
+		template <typename T>
+		bool read_binary(std::istream &in, T &value)
+		{
+			return read_binary(in, &value, 1);
+		}
+
+		/// checks that n items of item_size bytes fit in the rest of the stream, before sizing buffers with a count read from the file
+		bool fits_in_stream(std::istream &in, const size_t n, const size_t item_size)
+		{
+			const std::streamoff position = in.tellg();
+			if (position < 0 || !in.seekg(0, std::ios::end))
+				return false;
+			const std::streamoff end = in.tellg();
+			if (!in.seekg(position) || end < position)
+				return false;
+			return n <= size_t(end - position) / item_size;
+		}
+
+		/// reads the next non-empty line, empty at the end of the file
+		std::string read_line(std::istream &in)
+		{
+			std::string line;
+			while (std::getline(in, line))
+			{
+				line = utils::StringUtils::trim(line);
+				if (!line.empty())
+					return line;
+			}
+			return "";
+		}
+
+		/// reads the $Entities section and maps the tag of every entity to its first physical tag (0 if none), per dimension
+		bool read_entities(std::istream &in, std::array<std::unordered_map<int, int>, 4> &entity_tag_to_physical_tag)
+		{
+			size_t n_entities[4];
+			if (!read_binary(in, n_entities, 4))
+				return false;
+			// the smallest entity is a point: its tag, coordinates, and number of physical tags
+			for (int dim = 0; dim < 4; ++dim)
+			{
+				if (!fits_in_stream(in, n_entities[dim], sizeof(int) + 3 * sizeof(double) + sizeof(size_t)))
+					return false;
+			}
+
+			std::vector<int> physical_tags;
+			for (int dim = 0; dim < 4; ++dim)
+			{
+				for (size_t i = 0; i < n_entities[dim]; ++i)
+				{
+					int tag;
+					// a point has its coordinates, the other entities their bounding box
+					double box[6];
+					size_t n_physical_tags;
+					if (!read_binary(in, tag) || !read_binary(in, box, dim == 0 ? 3 : 6) || !read_binary(in, n_physical_tags)
+						|| !fits_in_stream(in, n_physical_tags, sizeof(int)))
+						return false;
+
+					physical_tags.resize(n_physical_tags);
+					if (!read_binary(in, physical_tags.data(), n_physical_tags))
+						return false;
+					entity_tag_to_physical_tag[dim][tag] = n_physical_tags > 0 ? physical_tags.front() : 0;
+
+					if (dim > 0)
+					{
+						size_t n_bounding_entities;
+						// seeking past the end of a file does not fail
+						if (!read_binary(in, n_bounding_entities) || !fits_in_stream(in, n_bounding_entities, sizeof(int))
+							|| !in.seekg(n_bounding_entities * sizeof(int), std::ios::cur))
+							return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		/// reads the $Nodes section, the coordinates of each block are converted in parallel chunks
+		bool read_nodes(std::istream &in, Eigen::MatrixXd &vertices, std::vector<int> &tag_to_index)
+		{
+			size_t n_blocks, n_vertices, min_tag, max_tag;
+			if (!read_binary(in, n_blocks) || !read_binary(in, n_vertices) || !read_binary(in, min_tag) || !read_binary(in, max_tag))
+				return false;
+			// every node has a tag and three coordinates
+			if (!fits_in_stream(in, n_vertices, sizeof(size_t) + 3 * sizeof(double))
+				|| !fits_in_stream(in, n_blocks, 3 * sizeof(int) + sizeof(size_t)))
+				return false;
+
+			// the dimension is known only once the elements are read, 2D meshes drop the last column
+			vertices.resize(n_vertices, 3);
+			tag_to_index.assign(max_tag + 1, -1);
+			const bool condense = n_vertices != max_tag;
+			if (condense)
+				logger().warn("MSH file contains more node tags than nodes, condensing nodes which will break input node ordering.");
+
+			std::vector<size_t> tags;
+			std::vector<double> coords;
+			std::atomic<bool> valid = true;
+			size_t index = 0;
+			for (size_t b = 0; b < n_blocks; ++b)
+			{
+				int entity_dim, entity_tag, parametric;
+				size_t n_nodes;
+				if (!read_binary(in, entity_dim) || !read_binary(in, entity_tag) || !read_binary(in, parametric) || !read_binary(in, n_nodes))
+					return false;
+
+				// all the tags of the block are followed by all the coordinates (x, y, z, and the parametric ones)
+				const size_t stride = 3 + (parametric ? entity_dim : 0);
+				const std::streamoff tags_start = in.tellg();
+				const std::streamoff coords_start = tags_start + std::streamoff(n_nodes * sizeof(size_t));
+
+				for (size_t start = 0; start < n_nodes; start += CHUNK_SIZE)
+				{
+					const size_t n = std::min(CHUNK_SIZE, n_nodes - start);
+					tags.resize(n);
+					coords.resize(n * stride);
+					if (!in.seekg(tags_start + std::streamoff(start * sizeof(size_t))) || !read_binary(in, tags.data(), n)
+						|| !in.seekg(coords_start + std::streamoff(start * stride * sizeof(double))) || !read_binary(in, coords.data(), n * stride))
+						return false;
+
+					utils::maybe_parallel_for(n, [&](int s, int e, int thread_id) {
+						for (int i = s; i < e; ++i)
+						{
+							const size_t tag = tags[i];
+							const size_t node_id = condense ? (index + start + i) : (tag - 1);
+							if (tag == 0 || tag > max_tag || node_id >= n_vertices)
+							{
+								valid = false;
+								continue;
+							}
+
+							vertices.row(node_id) << coords[i * stride], coords[i * stride + 1], coords[i * stride + 2];
+							tag_to_index[tag] = node_id;
+						}
+					});
+				}
+
+				index += n_nodes;
+				if (!in.seekg(coords_start + std::streamoff(n_nodes * stride * sizeof(double))))
+					return false;
+			}
+
+			return valid && index == n_vertices;
+		}
+
+		/// reads the $Elements section, the blocks of the mesh dimension are converted in parallel chunks
+		bool read_elements(
+			std::istream &in,
+			const std::vector<int> &tag_to_index,
+			const std::array<std::unordered_map<int, int>, 4> &entity_tag_to_physical_tag,
+			Eigen::MatrixXd &vertices,
+			Eigen::MatrixXi &cells,
+			std::vector<std::vector<int>> &elements,
+			std::vector<std::vector<double>> &weights,
+			std::vector<int> &body_ids)
+		{
+			struct Block
+			{
+				int entity_dim;
+				int entity_tag;
+				int type;
+				size_t n_elements;
+				std::streamoff start;
+			};
+
+			size_t n_blocks, n_elements, min_tag, max_tag;
+			if (!read_binary(in, n_blocks) || !read_binary(in, n_elements) || !read_binary(in, min_tag) || !read_binary(in, max_tag))
+				return false;
+			if (!fits_in_stream(in, n_blocks, 3 * sizeof(int) + sizeof(size_t)))
+				return false;
+
+			// First pass on the block headers (skipping the data) to size the outputs
+			std::vector<Block> blocks(n_blocks);
+			int dim = -1;
+			for (Block &block : blocks)
+			{
+				if (!read_binary(in, block.entity_dim) || !read_binary(in, block.entity_tag) || !read_binary(in, block.type) || !read_binary(in, block.n_elements))
+					return false;
+				block.start = in.tellg();
+				dim = std::max(dim, block.entity_dim);
+
+				const size_t n_nodes = mshio::nodes_per_element(block.type);
+				if (!fits_in_stream(in, block.n_elements, (n_nodes + 1) * sizeof(size_t))
+					|| !in.seekg(std::streamoff(block.n_elements * (n_nodes + 1) * sizeof(size_t)), std::ios::cur))
+					return false;
+			}
+			const std::streamoff end = in.tellg();
+
+			if (dim != 2 && dim != 3)
+				return false;
+
+			int cells_cols = -1;
+			int num_els = 0;
+			for (const Block &block : blocks)
+			{
+				const int cols = cell_columns(block.type);
+				if (block.entity_dim != dim || cols < 0)
+					continue;
+				if (cells_cols != -1 && cells_cols != cols)
+					return false;
+				cells_cols = cols;
+				num_els += block.n_elements;
+			}
+			if (cells_cols < 0)
+				return false;
+
+			if (dim == 2)
+				vertices.conservativeResize(Eigen::NoChange, 2);
+
+			// only the file reads are chunked, elements still holds one node list per element
+			cells.resize(num_els, cells_cols);
+			elements.assign(num_els, {});
+			weights.assign(num_els, {});
+			body_ids.resize(num_els);
+
+			// Second pass on the data of the blocks of the mesh dimension
+			std::vector<size_t> data;
+			std::atomic<bool> valid = true;
+			int cell_index = 0;
+			for (const Block &block : blocks)
+			{
+				if (block.entity_dim != dim || cell_columns(block.type) < 0)
+					continue;
+
+				const auto it = entity_tag_to_physical_tag[dim].find(block.entity_tag);
+				const int body_id = it != entity_tag_to_physical_tag[dim].end() ? it->second : 0;
+
+				// every element is its tag followed by its node tags
+				const size_t n_nodes = mshio::nodes_per_element(block.type);
+				const size_t stride = n_nodes + 1;
+
+				if (!in.seekg(block.start))
+					return false;
+				for (size_t start = 0; start < block.n_elements; start += CHUNK_SIZE)
+				{
+					const size_t n = std::min(CHUNK_SIZE, block.n_elements - start);
+					data.resize(n * stride);
+					if (!read_binary(in, data.data(), n * stride))
+						return false;
+
+					utils::maybe_parallel_for(n, [&](int s, int e, int thread_id) {
+						for (int i = s; i < e; ++i)
+						{
+							const size_t *node_tags = data.data() + i * stride + 1;
+							std::vector<int> &element = elements[cell_index + i];
+							element.resize(n_nodes);
+							for (size_t j = 0; j < n_nodes; ++j)
+							{
+								const int v_index = node_tags[j] < tag_to_index.size() ? tag_to_index[node_tags[j]] : -1;
+								if (v_index < 0)
+								{
+									valid = false;
+									break;
+								}
+								element[j] = v_index;
+								if (int(j) < cells_cols)
+									cells(cell_index + i, j) = v_index;
+							}
+
+							body_ids[cell_index + i] = body_id;
+						}
+					});
+
+					cell_index += n;
+				}
+			}
+
+			return valid && in.seekg(end);
+		}
+
+		bool load_binary_msh41_sections(
+			std::istream &in,
+			const bool read_node_data,
+			Eigen::MatrixXd &vertices,
+			Eigen::MatrixXi &cells,
+			std::vector<std::vector<int>> &elements,
+			std::vector<std::vector<double>> &weights,
+			std::vector<int> &body_ids)
+		{
+			if (read_line(in) != "$MeshFormat" || read_line(in) != "4.1 1 8")
+				return false;
+			int one;
+			// written as 1 to detect the endianness
+			if (!read_binary(in, one) || one != 1 || read_line(in) != "$EndMeshFormat")
+				return false;
+
+			std::array<std::unordered_map<int, int>, 4> entity_tag_to_physical_tag;
+			std::vector<int> tag_to_index;
+			bool has_nodes = false;
+			bool has_elements = false;
+
+			for (std::string section = read_line(in); !section.empty(); section = read_line(in))
+			{
+				if (section == "$PhysicalNames")
+				{
+					// ASCII even in binary files
+					std::string line;
+					while (!(line = read_line(in)).empty() && line != "$EndPhysicalNames")
+						;
+					continue;
+				}
+				else if (section == "$Entities")
+				{
+					if (!read_entities(in, entity_tag_to_physical_tag))
+						return false;
+				}
+				else if (section == "$Nodes")
+				{
+					if (!read_nodes(in, vertices, tag_to_index))
+						return false;
+					has_nodes = true;
+				}
+				else if (section == "$Elements" && has_nodes)
+				{
+					if (!read_elements(in, tag_to_index, entity_tag_to_physical_tag, vertices, cells, elements, weights, body_ids))
+						return false;
+					has_elements = true;
+					// the remaining sections only contain data
+					if (!read_node_data)
+						break;
+				}
+				else
+				{
+					logger().debug("Unsupported section {} in binary MSH file", section);
+					return false;
+				}
+
+				if (read_line(in) != "$End" + section.substr(1))
+					return false;
+			}
+
+			return has_elements;
+		}
+	} // namespace
+
 	bool MshReader::load(const std::string &path, Eigen::MatrixXd &vertices, Eigen::MatrixXi &cells, std::vector<std::vector<int>> &elements, std::vector<std::vector<double>> &weights, std::vector<int> &body_ids)
 	{
+		if (load_binary_msh41(path, /*read_node_data=*/false, vertices, cells, elements, weights, body_ids))
+			return true;
+
 		std::vector<std::string> node_data_name;
 		std::vector<std::vector<double>> node_data;
 
-		return load(path, vertices, cells, elements, weights, body_ids, node_data_name, node_data);
+		return load_with_mshio(path, vertices, cells, elements, weights, body_ids, node_data_name, node_data);
 	}
 
 	bool MshReader::load(const std::string &path, Eigen::MatrixXd &vertices, Eigen::MatrixXi &cells, std::vector<std::vector<int>> &elements, std::vector<std::vector<double>> &weights, std::vector<int> &body_ids, std::vector<std::string> &node_data_name, std::vector<std::vector<double>> &node_data)
+	{
+		if (load_binary_msh41(path, /*read_node_data=*/true, vertices, cells, elements, weights, body_ids))
+			return true;
+
+		return load_with_mshio(path, vertices, cells, elements, weights, body_ids, node_data_name, node_data);
+	}
+
+	bool MshReader::load_binary_msh41(const std::string &path, const bool read_node_data, Eigen::MatrixXd &vertices, Eigen::MatrixXi &cells, std::vector<std::vector<int>> &elements, std::vector<std::vector<double>> &weights, std::vector<int> &body_ids)
+	{
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in.good())
+			return false;
+
+		bool loaded;
+		try
+		{
+			loaded = load_binary_msh41_sections(in, read_node_data, vertices, cells, elements, weights, body_ids);
+		}
+		catch (const std::exception &err)
+		{
+			// e.g., unknown element type
+			logger().debug("{}", err.what());
+			loaded = false;
+		}
+
+		if (!loaded)
+		{
+			vertices.resize(0, 0);
+			cells.resize(0, 0);
+			elements.clear();
+			weights.clear();
+			body_ids.clear();
+		}
+
+		return loaded;
+	}
+
+	bool MshReader::load_with_mshio(const std::string &path, Eigen::MatrixXd &vertices, Eigen::MatrixXi &cells, std::vector<std::vector<int>> &elements, std::vector<std::vector<double>> &weights, std::vector<int> &body_ids, std::vector<std::string> &node_data_name, std::vector<std::vector<double>> &node_data)
 	{
 		if (!std::filesystem::exists(path))
 		{
@@ -99,32 +504,13 @@ namespace polyfem::io
 		{
 			if (e.entity_dim != dim)
 				continue;
-			const int type = e.element_type;
+			const int cols = cell_columns(e.element_type);
+			if (cols < 0)
+				continue;
 
-			if (type == 2 || type == 9 || type == 21 || type == 23 || type == 25) // tri
-			{
-				assert(cells_cols == -1 || cells_cols == 3);
-				cells_cols = 3;
-				num_els += e.num_elements_in_block;
-			}
-			else if (type == 3 || type == 10) // quad
-			{
-				assert(cells_cols == -1 || cells_cols == 4);
-				cells_cols = 4;
-				num_els += e.num_elements_in_block;
-			}
-			else if (type == 4 || type == 11 || type == 29 || type == 30 || type == 31) // tet
-			{
-				assert(cells_cols == -1 || cells_cols == 4);
-				cells_cols = 4;
-				num_els += e.num_elements_in_block;
-			}
-			else if (type == 5 || type == 12) // hex
-			{
-				assert(cells_cols == -1 || cells_cols == 8);
-				cells_cols = 8;
-				num_els += e.num_elements_in_block;
-			}
+			assert(cells_cols == -1 || cells_cols == cols);
+			cells_cols = cols;
+			num_els += e.num_elements_in_block;
 		}
 		assert(cells_cols > 0);
 
@@ -144,7 +530,7 @@ namespace polyfem::io
 			if (e.entity_dim != dim)
 				continue;
 			const int type = e.element_type;
-			if (type == 2 || type == 9 || type == 21 || type == 23 || type == 25 || type == 3 || type == 10 || type == 4 || type == 11 || type == 29 || type == 30 || type == 31 || type == 5 || type == 12)
+			if (cell_columns(type) > 0)
 			{
 				const size_t n_nodes = mshio::nodes_per_element(type);
 				for (int i = 0; i < e.data.size(); i += (n_nodes + 1))
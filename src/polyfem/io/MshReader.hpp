@@ -26,5 +26,30 @@ namespace polyfem::io
 			std::vector<int> &body_ids,
 			std::vector<std::string> &node_data_name,
 			std::vector<std::vector<double>> &node_data);
+
+		/// Loads a binary MSH 4.1 file by streaming the node and element blocks directly into the output arrays.
+		/// @note load() falls back to mshio when this fails, call it directly to know which reader was used
+		/// @param read_node_data if true, the sections after $Elements are read, node data is not supported so such files are rejected
+		/// @return false if the file is not a binary MSH 4.1 file or uses a section that is not supported, in which case the outputs are cleared
+		static bool load_binary_msh41(
+			const std::string &path,
+			const bool read_node_data,
+			Eigen::MatrixXd &vertices,
+			Eigen::MatrixXi &cells,
+			std::vector<std::vector<int>> &elements,
+			std::vector<std::vector<double>> &weights,
+			std::vector<int> &body_ids);
+
+	private:
+
+		static bool load_with_mshio(
+			const std::string &path,
+			Eigen::MatrixXd &vertices,
+			Eigen::MatrixXi &cells,
+			std::vector<std::vector<int>> &elements,
+			std::vector<std::vector<double>> &weights,
+			std::vector<int> &body_ids,
+			std::vector<std::string> &node_data_name,
+			std::vector<std::vector<double>> &node_data);
 	};
 } // namespace polyfem::io
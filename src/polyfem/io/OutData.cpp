@@ -59,6 +59,14 @@ namespace polyfem::io
 {
 	namespace
 	{
+		/// interpolates the nodal function fun (flattened, with actual_dim values per node) with the
+		/// interpolation matrix, the trailing obstacle dofs are ignored
+		void interpolate(const StiffnessMatrix &interpolation, const int actual_dim, const Eigen::VectorXd &fun, Eigen::MatrixXd &result)
+		{
+			assert(fun.size() >= interpolation.cols() * actual_dim);
+			result = interpolation * utils::unflatten(fun.head(interpolation.cols() * actual_dim), actual_dim);
+		}
+
 		void compute_traction_forces(const State &state, const Eigen::MatrixXd &solution, const double t, Eigen::MatrixXd &traction_forces, bool skip_dirichlet = true)
 		{
 			int actual_dim = 1;
@@ -1191,7 +1199,7 @@ namespace polyfem::io
 			vtm.add_dataset("Wireframe", "data", path_stem + "_wire" + opts.file_extension());
 		if (opts.points)
 			vtm.add_dataset("Points", "data", path_stem + "_points" + opts.file_extension());
-		vtm.save(base_path + ".vtm");
+		write([vtm = std::move(vtm), vtm_path = base_path + ".vtm"]() mutable { vtm.save(vtm_path); });
 	}
 
 	void OutGeometryData::save_volume(
@@ -1217,19 +1225,12 @@ namespace polyfem::io
 		const mesh::Obstacle &obstacle = state.obstacle;
 		const assembler::Problem &problem = *state.problem;
 
-		Eigen::MatrixXd points;
-		Eigen::MatrixXi tets;
-		Eigen::MatrixXi el_id;
-		Eigen::MatrixXd discr;
-		std::vector<std::vector<int>> elements;
-
-		if (opts.use_sampler)
-			build_vis_mesh(mesh, disc_orders, gbases,
-						   state.polys, state.polys_3d, opts.boundary_only,
-						   points, tets, el_id, discr);
-		else
-			build_high_order_vis_mesh(mesh, disc_orders, bases,
-									  points, elements, el_id, discr);
+		const VisMeshCache &vis = vis_mesh(state, opts);
+		Eigen::MatrixXd points = vis.points;
+		Eigen::MatrixXi tets = vis.tets;
+		const Eigen::MatrixXi &el_id = vis.el_id;
+		Eigen::MatrixXd discr = vis.discr;
+		std::vector<std::vector<int>> elements = vis.elements;
 
 		Eigen::MatrixXd fun, exact_fun, err, node_fun;
 
@@ -1301,19 +1302,9 @@ namespace polyfem::io
 				state.polys, state.polys_3d, ref_element_sampler,
 				points.rows(), sol, validity, opts.use_sampler, opts.boundary_only);
 
-		Evaluator::interpolate_function(
-			mesh, problem.is_scalar(), bases, state.disc_orders,
-			state.polys, state.polys_3d, ref_element_sampler,
-			points.rows(), sol, fun, opts.use_sampler, opts.boundary_only);
-
-		{
-			Eigen::MatrixXd tmp = Eigen::VectorXd::LinSpaced(sol.size(), 0, sol.size() - 1);
-
-			Evaluator::interpolate_function(
-				mesh, problem.is_scalar(), bases, state.disc_orders,
-				state.polys, state.polys_3d, ref_element_sampler,
-				points.rows(), tmp, node_fun, opts.use_sampler, opts.boundary_only);
-		}
+		const int actual_dim = problem.is_scalar() ? 1 : mesh.dimension();
+		interpolate(vis.interpolation, actual_dim, sol, fun);
+		interpolate(vis.interpolation, actual_dim, Eigen::VectorXd::LinSpaced(sol.size(), 0, sol.size() - 1), node_fun);
 
 		if (obstacle.n_vertices() > 0)
 		{
@@ -1537,28 +1528,28 @@ namespace polyfem::io
 				param_val[p] = Eigen::MatrixXd(points.rows(), 1);
 			Eigen::MatrixXd rhos(points.rows(), 1);
 
-			Eigen::MatrixXd local_pts;
+			// sample serially since the polygon samplers are not thread safe
+			std::vector<Eigen::MatrixXd> local_pts(bases.size());
+			std::vector<int> offsets(bases.size() + 1, 0);
 			Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
 
-			int index = 0;
 			const auto &sampler = ref_element_sampler;
 			for (int e = 0; e < int(bases.size()); ++e)
 			{
-				const basis::ElementBases &gbs = gbases[e];
-				const basis::ElementBases &bs = bases[e];
+				offsets[e + 1] = offsets[e];
 
 				if (opts.use_sampler)
 				{
 					if (mesh.is_simplex(e))
-						local_pts = sampler.simplex_points();
+						local_pts[e] = sampler.simplex_points();
 					else if (mesh.is_cube(e))
-						local_pts = sampler.cube_points();
+						local_pts[e] = sampler.cube_points();
 					else
 					{
 						if (mesh.is_volume())
-							sampler.sample_polyhedron(polys_3d.at(e).first, polys_3d.at(e).second, local_pts, vis_faces_poly, vis_edges_poly);
+							sampler.sample_polyhedron(polys_3d.at(e).first, polys_3d.at(e).second, local_pts[e], vis_faces_poly, vis_edges_poly);
 						else
-							sampler.sample_polygon(polys.at(e), local_pts, vis_faces_poly, vis_edges_poly);
+							sampler.sample_polygon(polys.at(e), local_pts[e], vis_faces_poly, vis_edges_poly);
 					}
 				}
 				else
@@ -1566,47 +1557,58 @@ namespace polyfem::io
 					if (mesh.is_volume())
 					{
 						if (mesh.is_simplex(e))
-							autogen::p_nodes_3d(disc_orders(e), local_pts);
+							autogen::p_nodes_3d(disc_orders(e), local_pts[e]);
 						else if (mesh.is_cube(e))
-							autogen::q_nodes_3d(disc_orders(e), local_pts);
+							autogen::q_nodes_3d(disc_orders(e), local_pts[e]);
 						else
 							continue;
 					}
 					else
 					{
 						if (mesh.is_simplex(e))
-							autogen::p_nodes_2d(disc_orders(e), local_pts);
+							autogen::p_nodes_2d(disc_orders(e), local_pts[e]);
 						else if (mesh.is_cube(e))
-							autogen::q_nodes_2d(disc_orders(e), local_pts);
+							autogen::q_nodes_2d(disc_orders(e), local_pts[e]);
 						else
 						{
 							const auto &mesh2d = static_cast<const mesh::Mesh2D &>(mesh);
 							const int n_v = mesh2d.n_face_vertices(e);
-							local_pts.resize(n_v, 2);
+							local_pts[e].resize(n_v, 2);
 
 							for (int j = 0; j < n_v; ++j)
 							{
-								local_pts.row(j) = mesh2d.point(mesh2d.face_vertex(e, j));
+								local_pts[e].row(j) = mesh2d.point(mesh2d.face_vertex(e, j));
 							}
 						}
 					}
 				}
 
-				assembler::ElementAssemblyValues vals;
-				vals.compute(e, mesh.is_volume(), local_pts, bs, gbs);
+				offsets[e + 1] += local_pts[e].rows();
+			}
+
+			assert(offsets.back() == points.rows());
 
-				for (int j = 0; j < vals.val.rows(); ++j)
+			auto storage = utils::create_thread_storage(assembler::ElementAssemblyValues());
+			utils::maybe_parallel_for(bases.size(), [&](int start, int end, int thread_id) {
+				assembler::ElementAssemblyValues &vals = utils::get_local_thread_storage(storage, thread_id);
+
+				for (int e = start; e < end; ++e)
 				{
-					for (const auto &[p, func] : params)
-						param_val.at(p)(index) = func(local_pts.row(j), vals.val.row(j), t, e);
+					if (local_pts[e].rows() == 0)
+						continue;
 
-					rhos(index) = density(local_pts.row(j), vals.val.row(j), t, e);
+					vals.compute(e, mesh.is_volume(), local_pts[e], bases[e], gbases[e]);
 
-					++index;
-				}
-			}
+					for (int j = 0; j < vals.val.rows(); ++j)
+					{
+						const int index = offsets[e] + j;
+						for (const auto &[p, func] : params)
+							param_val.at(p)(index) = func(local_pts[e].row(j), vals.val.row(j), t, e);
 
-			assert(index == points.rows());
+						rhos(index) = density(local_pts[e].row(j), vals.val.row(j), t, e);
+					}
+				}
+			});
 
 			if (obstacle.n_vertices() > 0)
 			{
@@ -1735,10 +1737,13 @@ namespace polyfem::io
 				}
 			}
 
-			if (elements.empty())
-				writer.write_mesh(path, points, tets);
-			else
-				writer.write_mesh(path, points, elements, true, disc_orders.maxCoeff() == 1);
+			const bool is_linear = disc_orders.maxCoeff() == 1;
+			write([tmpw, path, points = std::move(points), tets = std::move(tets), elements = std::move(elements), is_linear]() {
+				if (elements.empty())
+					tmpw->write_mesh(path, points, tets);
+				else
+					tmpw->write_mesh(path, points, elements, true, is_linear);
+			});
 		}
 		else
 		{
@@ -1748,6 +1753,41 @@ namespace polyfem::io
 		}
 	}
 
+	const OutGeometryData::VisMeshCache &OutGeometryData::vis_mesh(const State &state, const ExportOptions &opts) const
+	{
+		const mesh::Mesh &mesh = *state.mesh;
+		if (vis_mesh_cache.mesh == &mesh
+			&& vis_mesh_cache.n_bases == state.n_bases
+			&& vis_mesh_cache.use_sampler == opts.use_sampler
+			&& vis_mesh_cache.boundary_only == opts.boundary_only)
+			return vis_mesh_cache;
+
+		POLYFEM_SCOPED_TIMER("Building vis mesh");
+
+		VisMeshCache cache;
+		cache.mesh = &mesh;
+		cache.n_bases = state.n_bases;
+		cache.use_sampler = opts.use_sampler;
+		cache.boundary_only = opts.boundary_only;
+
+		if (opts.use_sampler)
+			build_vis_mesh(mesh, state.disc_orders, state.geom_bases(),
+						   state.polys, state.polys_3d, opts.boundary_only,
+						   cache.points, cache.tets, cache.el_id, cache.discr);
+		else
+			build_high_order_vis_mesh(mesh, state.disc_orders, state.bases,
+									  cache.points, cache.elements, cache.el_id, cache.discr);
+
+		Evaluator::interpolation_matrix(
+			mesh, state.bases, state.disc_orders,
+			state.polys, state.polys_3d, ref_element_sampler,
+			cache.points.rows(), state.n_bases, cache.interpolation,
+			opts.use_sampler, opts.boundary_only);
+
+		vis_mesh_cache = std::move(cache);
+		return vis_mesh_cache;
+	}
+
 	void OutGeometryData::save_volume_vector_field(
 		const State &state,
 		const Eigen::MatrixXd &points,
@@ -1756,11 +1796,11 @@ namespace polyfem::io
 		const Eigen::VectorXd &field,
 		paraviewo::ParaviewWriter &writer) const
 	{
+		const VisMeshCache &vis = vis_mesh(state, opts);
+		assert(vis.interpolation.rows() == points.rows());
+
 		Eigen::MatrixXd inerpolated_field;
-		Evaluator::interpolate_function(
-			*state.mesh, state.problem->is_scalar(), state.bases, state.disc_orders,
-			state.polys, state.polys_3d, ref_element_sampler,
-			points.rows(), field, inerpolated_field, opts.use_sampler, opts.boundary_only);
+		interpolate(vis.interpolation, state.problem->is_scalar() ? 1 : state.mesh->dimension(), field, inerpolated_field);
 
 		if (state.obstacle.n_vertices() > 0)
 		{
@@ -1967,7 +2007,9 @@ namespace polyfem::io
 			solution_frames.back().solution = fun;
 
 		if (opts.solve_export_to_file)
-			writer.write_mesh(export_surface, boundary_vis_vertices, boundary_vis_elements);
+			write([tmpw, export_surface, boundary_vis_vertices, boundary_vis_elements]() {
+				tmpw->write_mesh(export_surface, boundary_vis_vertices, boundary_vis_elements);
+			});
 		else
 		{
 			solution_frames.back().name = export_surface;
@@ -2063,10 +2105,12 @@ namespace polyfem::io
 			// Write the solution last so it is the default for warp-by-vector
 			writer.add_field("solution", surface_displacements);
 
-			writer.write_mesh(
-				export_surface.substr(0, export_surface.length() - 4) + "_contact.vtu",
-				collision_mesh.rest_positions(),
-				problem_dim == 3 ? collision_mesh.faces() : collision_mesh.edges());
+			write([tmpw,
+				   contact_path = export_surface.substr(0, export_surface.length() - 4) + "_contact.vtu",
+				   rest_positions = Eigen::MatrixXd(collision_mesh.rest_positions()),
+				   cells = Eigen::MatrixXi(problem_dim == 3 ? collision_mesh.faces() : collision_mesh.edges())]() {
+				tmpw->write_mesh(contact_path, rest_positions, cells);
+			});
 		}
 	}
 
@@ -2255,7 +2299,9 @@ namespace polyfem::io
 		// Write the solution last so it is the default for warp-by-vector
 		writer.add_field("solution", fun);
 
-		writer.write_mesh(name, points, edges);
+		write([tmpw, name, points = std::move(points), edges = std::move(edges)]() {
+			tmpw->write_mesh(name, points, edges);
+		});
 	}
 
 	void OutGeometryData::save_points(
@@ -2310,7 +2356,9 @@ namespace polyfem::io
 			writer.add_field("sidesets", b_sidesets);
 			// Write the solution last so it is the default for warp-by-vector
 			writer.add_field("solution", fun);
-			writer.write_mesh(path, points, cells, false, false);
+			write([tmpw, path, points = std::move(points), cells = std::move(cells)]() {
+				tmpw->write_mesh(path, points, cells, false, false);
+			});
 		}
 	}
 
@@ -2322,8 +2370,23 @@ namespace polyfem::io
 		paraviewo::PVDWriter::save_pvd(name, vtu_names, time_steps, t0, dt, skip_frame);
 	}
 
+	void OutGeometryData::flush() const
+	{
+		if (output_queue)
+			output_queue->flush();
+	}
+
+	void OutGeometryData::write(std::function<void()> job) const
+	{
+		if (output_queue)
+			output_queue->push(std::move(job));
+		else
+			job();
+	}
+
 	void OutGeometryData::init_sampler(const polyfem::mesh::Mesh &mesh, const double vismesh_rel_area)
 	{
+		clear_vis_mesh_cache();
 		ref_element_sampler.init(mesh.is_volume(), mesh.n_elements(), vismesh_rel_area);
 	}
 
@@ -2958,7 +3021,7 @@ namespace polyfem::io
 	RuntimeStatsCSVWriter::RuntimeStatsCSVWriter(const std::string &path, const State &state, const double t0, const double dt)
 		: file(path), state(state), t0(t0), dt(dt)
 	{
-		file << "step,time,forward,remeshing,global_relaxation,peak_mem,#V,#T" << std::endl;
+		file << "step,time,forward,remeshing,global_relaxation,iterations,peak_mem,#V,#T" << std::endl;
 	}
 
 	RuntimeStatsCSVWriter::~RuntimeStatsCSVWriter()
@@ -2966,7 +3029,7 @@ namespace polyfem::io
 		file.close();
 	}
 
-	void RuntimeStatsCSVWriter::write(const int t, const double forward, const double remeshing, const double global_relaxation, const Eigen::MatrixXd &sol)
+	void RuntimeStatsCSVWriter::write(const int t, const double forward, const double remeshing, const double global_relaxation, const int iterations, const Eigen::MatrixXd &sol)
 	{
 		total_forward_solve_time += forward;
 		total_remeshing_time += remeshing;
@@ -2986,8 +3049,8 @@ namespace polyfem::io
 		// logger().debug("Peak mem: {} GiB", peak_mem);
 
 		file << fmt::format(
-			"{},{},{},{},{},{},{},{}\n",
-			t, t0 + dt * t, forward, remeshing, global_relaxation, peak_mem,
+			"{},{},{},{},{},{},{},{},{}\n",
+			t, t0 + dt * t, forward, remeshing, global_relaxation, iterations, peak_mem,
 			state.n_bases, state.mesh->n_elements());
 		file.flush();
 	}
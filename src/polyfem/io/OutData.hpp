@@ -16,6 +16,8 @@
 
 #include <polyfem/utils/RefElementSampler.hpp>
 
+#include <polyfem/io/OutputQueue.hpp>
+
 #include <Eigen/Dense>
 
 namespace polyfem
@@ -266,7 +268,46 @@ namespace polyfem::io
 		void save_pvd(const std::string &name, const std::function<std::string(int)> &vtu_names,
 					  int time_steps, double t0, double dt, int skip_frame = 1) const;
 
+		/// background queue used to write the paraview files, if null the files are written immediately
+		/// the visualization meshes and fields are still sampled on the calling thread
+		std::shared_ptr<OutputQueue> output_queue;
+
+		/// @brief wait for all the pending file writes
+		void flush() const;
+
+		/// @brief drop the cached visualization mesh, must be called when the mesh or the bases change
+		void clear_vis_mesh_cache() { vis_mesh_cache = VisMeshCache(); }
+
 	private:
+		/// visualization mesh and interpolation operator, they depend only on the mesh, the bases, and the sampler
+		struct VisMeshCache
+		{
+			const mesh::Mesh *mesh = nullptr;
+			int n_bases = -1;
+			bool use_sampler = false;
+			bool boundary_only = false;
+
+			Eigen::MatrixXd points;
+			Eigen::MatrixXi tets;
+			Eigen::MatrixXi el_id;
+			Eigen::MatrixXd discr;
+			std::vector<std::vector<int>> elements;
+
+			/// maps the nodal values to the visualization points
+			StiffnessMatrix interpolation;
+		};
+		mutable VisMeshCache vis_mesh_cache;
+
+		/// @brief get the visualization mesh for the export options, builds it on the first call
+		/// @param[in] state state to get the data
+		/// @param[in] opts export options
+		/// @return cached visualization mesh
+		const VisMeshCache &vis_mesh(const State &state, const ExportOptions &opts) const;
+
+		/// @brief run a file write on the output queue, or immediately if there is none
+		/// @param[in] job write job, must own all its data
+		void write(std::function<void()> job) const;
+
 		/// used to sample the solution
 		utils::RefElementSampler ref_element_sampler;
 
@@ -526,7 +567,7 @@ namespace polyfem::io
 		RuntimeStatsCSVWriter(const std::string &path, const State &state, const double t0, const double dt);
 		~RuntimeStatsCSVWriter();
 
-		void write(const int t, const double forward, const double remeshing, const double global_relaxation, const Eigen::MatrixXd &sol);
+		void write(const int t, const double forward, const double remeshing, const double global_relaxation, const int iterations, const Eigen::MatrixXd &sol);
 
 	protected:
 		std::ofstream file;
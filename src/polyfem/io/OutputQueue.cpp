@@ -0,0 +1,115 @@
+#include "OutputQueue.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace polyfem::io
+{
+	OutputQueue::OutputQueue(const int n_threads, const int max_jobs)
+		: max_jobs_(std::max(1, max_jobs))
+	{
+		const int n = std::max(1, n_threads);
+		workers_.reserve(n);
+		for (int i = 0; i < n; ++i)
+			workers_.emplace_back([this]() { run(); });
+	}
+
+	OutputQueue::~OutputQueue()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			job_done_.wait(lock, [this]() { return jobs_.empty() && running_ == 0; });
+			stop_ = true;
+		}
+		job_available_.notify_all();
+
+		for (auto &w : workers_)
+			w.join();
+
+		if (error_)
+		{
+			try
+			{
+				std::rethrow_exception(error_);
+			}
+			catch (const std::exception &e)
+			{
+				logger().error("Output job failed: {}", e.what());
+			}
+			catch (...)
+			{
+				logger().error("Output job failed");
+			}
+		}
+	}
+
+	void OutputQueue::push(std::function<void()> job)
+	{
+		std::exception_ptr error;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			assert(!stop_);
+			job_done_.wait(lock, [this]() { return int(jobs_.size()) < max_jobs_; });
+			std::swap(error, error_);
+			if (!error)
+				jobs_.push_back(std::move(job));
+		}
+
+		if (error)
+			std::rethrow_exception(error);
+		job_available_.notify_one();
+	}
+
+	void OutputQueue::flush()
+	{
+		std::exception_ptr error;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			job_done_.wait(lock, [this]() { return jobs_.empty() && running_ == 0; });
+			std::swap(error, error_);
+		}
+
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	void OutputQueue::run()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				job_available_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+				if (jobs_.empty())
+					return;
+
+				job = std::move(jobs_.front());
+				jobs_.pop_front();
+				++running_;
+			}
+			// a slot is free for the producer
+			job_done_.notify_all();
+
+			std::exception_ptr error;
+			try
+			{
+				job();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				--running_;
+				if (error && !error_)
+					error_ = error;
+			}
+			job_done_.notify_all();
+		}
+	}
+} // namespace polyfem::io
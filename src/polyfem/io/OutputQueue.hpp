@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace polyfem::io
+{
+	/// Bounded queue of output jobs (e.g., VTU/HDF5 file writes) executed by background threads.
+	/// Jobs must own all the data they need: the caller is free to modify its state as soon as push() returns.
+	class OutputQueue
+	{
+	public:
+		/// @param[in] n_threads number of worker threads (at least one)
+		/// @param[in] max_jobs maximum number of pending jobs; push() blocks when the queue is full
+		OutputQueue(const int n_threads, const int max_jobs);
+		~OutputQueue();
+
+		OutputQueue(const OutputQueue &) = delete;
+		OutputQueue &operator=(const OutputQueue &) = delete;
+
+		/// @brief enqueue a job, blocking while the queue is full
+		/// rethrows (instead of queuing the job) the first exception thrown by a job since the last push or flush
+		/// @param[in] job job to execute on a worker thread
+		void push(std::function<void()> job);
+
+		/// @brief wait until all the queued jobs are done
+		/// rethrows the first exception thrown by a job since the last push or flush
+		void flush();
+
+		/// @brief number of worker threads
+		int n_threads() const { return workers_.size(); }
+		/// @brief maximum number of pending jobs
+		int max_jobs() const { return max_jobs_; }
+
+	private:
+		void run();
+
+		const int max_jobs_;
+		std::vector<std::thread> workers_;
+
+		std::mutex mutex_;
+		/// signaled when a job is queued or the queue is stopped
+		std::condition_variable job_available_;
+		/// signaled when a job is dequeued or done
+		std::condition_variable job_done_;
+
+		std::deque<std::function<void()>> jobs_;
+		int running_ = 0;
+		bool stop_ = false;
+		std::exception_ptr error_;
+	};
+} // namespace polyfem::io
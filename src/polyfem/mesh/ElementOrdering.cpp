@@ -0,0 +1,224 @@
+#include "ElementOrdering.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MatrixCache.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+
+namespace polyfem::mesh
+{
+	namespace
+	{
+		/// spreads the lower 21 bits of x so that there are two zeros between consecutive bits
+		uint64_t spread_bits_3(uint64_t x)
+		{
+			x &= 0x1fffff;
+			x = (x | x << 32) & 0x1f00000000ffff;
+			x = (x | x << 16) & 0x1f0000ff0000ff;
+			x = (x | x << 8) & 0x100f00f00f00f00f;
+			x = (x | x << 4) & 0x10c30c30c30c30c3;
+			x = (x | x << 2) & 0x1249249249249249;
+			return x;
+		}
+
+		/// spreads the lower 32 bits of x so that there is one zero between consecutive bits
+		uint64_t spread_bits_2(uint64_t x)
+		{
+			x &= 0xffffffff;
+			x = (x | x << 16) & 0x0000ffff0000ffff;
+			x = (x | x << 8) & 0x00ff00ff00ff00ff;
+			x = (x | x << 4) & 0x0f0f0f0f0f0f0f0f;
+			x = (x | x << 2) & 0x3333333333333333;
+			x = (x | x << 1) & 0x5555555555555555;
+			return x;
+		}
+
+		/// number of global nodes referenced by the bases
+		int n_nodes(const std::vector<basis::ElementBases> &bases)
+		{
+			int n = 0;
+			for (const auto &eb : bases)
+				for (const auto &b : eb.bases)
+					for (const auto &g : b.global())
+						n = std::max(n, g.index + 1);
+			return n;
+		}
+
+		/// for every element, the list of elements sharing at least one global node
+		std::vector<std::vector<int>> element_adjacency(const std::vector<basis::ElementBases> &bases)
+		{
+			const int n_elements = bases.size();
+
+			std::vector<std::vector<int>> node_to_elements(n_nodes(bases));
+			for (int e = 0; e < n_elements; ++e)
+			{
+				for (const auto &b : bases[e].bases)
+				{
+					for (const auto &g : b.global())
+					{
+						auto &elements = node_to_elements[g.index];
+						if (elements.empty() || elements.back() != e)
+							elements.push_back(e);
+					}
+				}
+			}
+
+			std::vector<std::vector<int>> adjacency(n_elements);
+			std::vector<int> marker(n_elements, -1);
+			for (int e = 0; e < n_elements; ++e)
+			{
+				marker[e] = e;
+				for (const auto &b : bases[e].bases)
+				{
+					for (const auto &g : b.global())
+					{
+						for (const int f : node_to_elements[g.index])
+						{
+							if (marker[f] == e)
+								continue;
+							marker[f] = e;
+							adjacency[e].push_back(f);
+						}
+					}
+				}
+			}
+
+			return adjacency;
+		}
+	} // namespace
+
+	void ElementOrdering::build(const Mesh &mesh, const std::vector<basis::ElementBases> &bases, const std::string &strategy)
+	{
+		clear();
+
+		const int n_elements = bases.size();
+		if (n_elements == 0)
+			return;
+
+		const std::vector<std::vector<int>> adjacency = element_adjacency(bases);
+
+		if (strategy == "none")
+		{
+			order_.resize(n_elements);
+			std::iota(order_.begin(), order_.end(), 0);
+		}
+		else if (strategy == "morton")
+		{
+			Eigen::MatrixXd barycenters;
+			mesh.compute_element_barycenters(barycenters);
+			if (barycenters.rows() == n_elements)
+				order_ = morton_order(barycenters);
+			else
+			{
+				logger().warn("Mesh and bases have different number of elements, using reverse Cuthill-McKee element ordering");
+				order_ = rcm_order(adjacency);
+			}
+		}
+		else if (strategy == "rcm")
+		{
+			order_ = rcm_order(adjacency);
+		}
+		else
+		{
+			log_and_throw_error("Unknown element ordering {}", strategy);
+		}
+		assert(order_.size() == n_elements);
+
+		// neighbors (elements sharing a global node) get different colors
+		colors_ = utils::compute_element_colors(order_, n_nodes(bases), [&](const int e, const auto &f) {
+			for (const auto &b : bases[e].bases)
+				for (const auto &g : b.global())
+					f(g.index);
+		});
+
+		logger().debug("Element ordering {}: {} elements, {} colors", strategy, n_elements, colors_.size());
+	}
+
+	std::vector<int> ElementOrdering::morton_order(const Eigen::MatrixXd &barycenters)
+	{
+		const int n = barycenters.rows();
+		const int dim = barycenters.cols();
+		assert(dim == 2 || dim == 3);
+
+		std::vector<int> order(n);
+		std::iota(order.begin(), order.end(), 0);
+		if (n == 0)
+			return order;
+
+		const Eigen::RowVectorXd min = barycenters.colwise().minCoeff();
+		const Eigen::RowVectorXd extent = barycenters.colwise().maxCoeff() - min;
+		const double scale = std::max(extent.maxCoeff(), 1e-16);
+		const double n_cells = dim == 3 ? double((1 << 21) - 1) : double(0xffffffffu);
+
+		std::vector<uint64_t> codes(n);
+		for (int i = 0; i < n; ++i)
+		{
+			uint64_t code = 0;
+			for (int d = 0; d < dim; ++d)
+			{
+				const uint64_t x = uint64_t((barycenters(i, d) - min(d)) / scale * n_cells);
+				code |= (dim == 3 ? spread_bits_3(x) : spread_bits_2(x)) << d;
+			}
+			codes[i] = code;
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&](const int a, const int b) { return codes[a] < codes[b]; });
+		return order;
+	}
+
+	std::vector<int> ElementOrdering::rcm_order(const std::vector<std::vector<int>> &adjacency)
+	{
+		const int n = adjacency.size();
+
+		std::vector<int> by_degree(n);
+		std::iota(by_degree.begin(), by_degree.end(), 0);
+		std::stable_sort(by_degree.begin(), by_degree.end(), [&](const int a, const int b) {
+			return adjacency[a].size() < adjacency[b].size();
+		});
+
+		std::vector<int> order;
+		order.reserve(n);
+		std::vector<bool> visited(n, false);
+		std::vector<int> neighbors;
+
+		// one breadth first traversal per connected component, starting from a node of minimum degree
+		for (const int start : by_degree)
+		{
+			if (visited[start])
+				continue;
+
+			std::queue<int> queue;
+			queue.push(start);
+			visited[start] = true;
+
+			while (!queue.empty())
+			{
+				const int e = queue.front();
+				queue.pop();
+				order.push_back(e);
+
+				neighbors.clear();
+				for (const int f : adjacency[e])
+				{
+					if (!visited[f])
+					{
+						visited[f] = true;
+						neighbors.push_back(f);
+					}
+				}
+
+				std::stable_sort(neighbors.begin(), neighbors.end(), [&](const int a, const int b) {
+					return adjacency[a].size() < adjacency[b].size();
+				});
+				for (const int f : neighbors)
+					queue.push(f);
+			}
+		}
+
+		std::reverse(order.begin(), order.end());
+		return order;
+	}
+} // namespace polyfem::mesh
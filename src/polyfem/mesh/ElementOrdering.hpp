@@ -0,0 +1,49 @@
+#pragma once
+
+#include <polyfem/mesh/Mesh.hpp>
+#include <polyfem/basis/ElementBases.hpp>
+
+#include <Eigen/Dense>
+
+#include <string>
+#include <vector>
+
+namespace polyfem::mesh
+{
+	/// locality preserving order and coloring of the elements, used to schedule the assembly loops
+	/// built from the bases, it must be rebuilt every time the bases change (e.g., after remeshing)
+	class ElementOrdering
+	{
+	public:
+		/// computes the order and the coloring of the elements
+		/// @param[in] mesh mesh used for the element barycenters
+		/// @param[in] bases bases of every element, elements sharing a global node are neighbors
+		/// @param[in] strategy "none" (input order), "morton" (Morton curve over the barycenters), or "rcm" (reverse Cuthill-McKee on the element graph)
+		void build(const Mesh &mesh, const std::vector<basis::ElementBases> &bases, const std::string &strategy);
+
+		void clear()
+		{
+			order_.clear();
+			colors_.clear();
+		}
+
+		bool empty() const { return order_.empty(); }
+		int n_elements() const { return order_.size(); }
+
+		/// k-th element to visit
+		int element(const int k) const { return order_[k]; }
+		const std::vector<int> &order() const { return order_; }
+
+		/// groups of elements not sharing any global node, each group follows the order
+		const std::vector<std::vector<int>> &colors() const { return colors_; }
+
+		/// elements sorted along a Morton (z-order) curve of their barycenters
+		static std::vector<int> morton_order(const Eigen::MatrixXd &barycenters);
+		/// reverse Cuthill-McKee order of the graph given by adjacency lists
+		static std::vector<int> rcm_order(const std::vector<std::vector<int>> &adjacency);
+
+	private:
+		std::vector<int> order_;
+		std::vector<std::vector<int>> colors_;
+	};
+} // namespace polyfem::mesh
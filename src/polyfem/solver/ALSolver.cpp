@@ -94,6 +94,7 @@ namespace polyfem::solver
 			{
 				for (auto &f : alagr_forms)
 					f->update_lagrangian(sol, al_weight);
+				nl_problem.clear_evaluation_cache();
 			}
 
 			post_subsolve(al_weight);
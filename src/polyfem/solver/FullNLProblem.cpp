@@ -11,24 +11,32 @@ namespace polyfem::solver
 	{
 		for (auto &f : forms_)
 			f->init(x);
+
+		evaluation_cache_active_ = true;
+		clear_evaluation_cache();
+		// start a new union of the form patterns for this solve
+		evaluation_cache_.hess.resize(0, 0);
 	}
 
 	void FullNLProblem::set_project_to_psd(bool project_to_psd)
 	{
 		for (auto &f : forms_)
 			f->set_project_to_psd(project_to_psd);
+		clear_evaluation_cache();
 	}
 
 	void FullNLProblem::init_lagging(const TVector &x)
 	{
 		for (auto &f : forms_)
 			f->init_lagging(x);
+		clear_evaluation_cache();
 	}
 
 	void FullNLProblem::update_lagging(const TVector &x, const int iter_num)
 	{
 		for (auto &f : forms_)
 			f->update_lagging(x, iter_num);
+		clear_evaluation_cache();
 	}
 
 	int FullNLProblem::max_lagging_iterations() const
@@ -65,6 +73,8 @@ namespace polyfem::solver
 		for (auto &f : forms_)
 			if (f->enabled())
 				step = std::min(step, f->max_step_size(x0, x1));
+		// the elastic form may refine its quadrature
+		clear_evaluation_cache();
 		return step;
 	}
 
@@ -86,36 +96,127 @@ namespace polyfem::solver
 
 	double FullNLProblem::value(const TVector &x)
 	{
-		double val = 0;
-		for (auto &f : forms_)
-			if (f->enabled())
-				val += f->value(x);
-		return val;
+		// energy only: most values (e.g., rejected line search trials) are never followed by a gradient
+		evaluate(x, true, false, false);
+		return evaluation_cache_.value;
 	}
 
 	void FullNLProblem::gradient(const TVector &x, TVector &grad)
 	{
-		grad = TVector::Zero(x.size());
-		for (auto &f : forms_)
+		// during a solve the value at the point of a gradient is needed next, get both in one pass unless it is known
+		evaluate(x, evaluation_cache_active_, true, false);
+		grad = evaluation_cache_.grad;
+	}
+
+	void FullNLProblem::hessian(const TVector &x, THessian &hessian)
+	{
+		evaluate(x, false, false, true);
+		hessian = evaluation_cache_.hess;
+	}
+
+	void FullNLProblem::evaluate(const TVector &x, const bool want_value, const bool want_grad, const bool want_hess)
+	{
+		prepare_evaluation_cache(x);
+
+		const bool need_value = want_value && !evaluation_cache_.has_value;
+		const bool need_grad = want_grad && !evaluation_cache_.has_grad;
+		const bool need_hess = want_hess && !evaluation_cache_.has_hess;
+
+		if (need_value || need_grad)
 		{
-			if (!f->enabled())
-				continue;
-			TVector tmp;
-			f->first_derivative(x, tmp);
-			grad += tmp;
+			double val = 0;
+			TVector grad;
+			if (need_grad)
+				grad = TVector::Zero(x.size());
+
+			for (auto &f : forms_)
+			{
+				if (!f->enabled())
+					continue;
+
+				TVector tmp;
+				if (need_value && need_grad)
+				{
+					val += f->value_and_first_derivative(x, tmp);
+					grad += tmp;
+				}
+				else if (need_value)
+					val += f->value(x);
+				else
+				{
+					f->first_derivative(x, tmp);
+					grad += tmp;
+				}
+			}
+
+			if (need_value)
+			{
+				evaluation_cache_.value = val;
+				evaluation_cache_.has_value = true;
+			}
+			if (need_grad)
+			{
+				evaluation_cache_.grad = std::move(grad);
+				evaluation_cache_.has_grad = true;
+			}
+		}
+
+		if (need_hess)
+		{
+			// the matrix persists across iterations, its pattern is the union of the form patterns seen so far
+			THessian &hessian = evaluation_cache_.hess;
+			if (hessian.rows() != x.size() || hessian.cols() != x.size())
+				hessian.resize(x.size(), x.size());
+			else
+				hessian.coeffs().setZero();
+
+			for (auto &f : forms_)
+				if (f->enabled())
+					f->add_second_derivative(x, hessian);
+
+			hessian.makeCompressed();
+			evaluation_cache_.has_hess = true;
 		}
 	}
 
-	void FullNLProblem::hessian(const TVector &x, THessian &hessian)
+	void FullNLProblem::prepare_evaluation_cache(const TVector &x)
+	{
+		std::vector<double> weights(forms_.size());
+		for (int i = 0; i < forms_.size(); ++i)
+			weights[i] = forms_[i]->enabled() ? forms_[i]->weight() : 0;
+
+		if (evaluation_cache_active_
+			&& evaluation_cache_.x.size() == x.size()
+			&& evaluation_cache_.weights == weights
+			&& evaluation_cache_.x == x)
+			return;
+
+		clear_evaluation_cache();
+		evaluation_cache_.x = x;
+		evaluation_cache_.weights = std::move(weights);
+	}
+
+	void FullNLProblem::clear_evaluation_cache()
 	{
-		hessian.resize(x.size(), x.size());
+		evaluation_cache_.x.resize(0);
+		evaluation_cache_.weights.clear();
+		evaluation_cache_.has_value = false;
+		evaluation_cache_.has_grad = false;
+		evaluation_cache_.has_hess = false;
+		evaluation_cache_.grad.resize(0);
+		// the values of hess are stale but its pattern is kept
+	}
+
+	void FullNLProblem::hessian_vector_product(const TVector &x, const TVector &v, TVector &Hv)
+	{
+		Hv = TVector::Zero(x.size());
 		for (auto &f : forms_)
 		{
 			if (!f->enabled())
 				continue;
-			THessian tmp;
-			f->second_derivative(x, tmp);
-			hessian += tmp;
+			TVector tmp;
+			f->hessian_vector_product(x, v, tmp);
+			Hv += tmp;
 		}
 	}
 
@@ -123,11 +224,16 @@ namespace polyfem::solver
 	{
 		for (auto &f : forms_)
 			f->solution_changed(x);
+		// forms update their state (e.g., the collision set) for x
+		if (evaluation_cache_.x.size() != x.size() || evaluation_cache_.x != x)
+			clear_evaluation_cache();
 	}
 
 	void FullNLProblem::post_step(const polysolve::nonlinear::PostStepData &data)
 	{
 		for (auto &f : forms_)
 			f->post_step(data);
+		// forms may update their state after a step (e.g., the barrier stiffness)
+		clear_evaluation_cache();
 	}
 } // namespace polyfem::solver
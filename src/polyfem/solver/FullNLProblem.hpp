@@ -19,6 +19,27 @@ namespace polyfem::solver
 		virtual void gradient(const TVector &x, TVector &gradv) override;
 		virtual void hessian(const TVector &x, THessian &hessian) override;
 
+		/// @brief Evaluate the requested quantities at x, in a single pass per form when possible
+		/// @note During a solve (between init and finish) the results are memoized on the iterate and reused by value, gradient and hessian,
+		/// and gradient also evaluates the value in the same pass when it is not known yet.
+		/// @param[in] x Current solution
+		/// @param[in] want_value Compute the value
+		/// @param[in] want_grad Compute the gradient
+		/// @param[in] want_hess Compute the Hessian
+		void evaluate(const TVector &x, const bool want_value, const bool want_grad, const bool want_hess);
+
+		/// @brief Drop the memoized evaluation, to be called when the forms change outside of the problem callbacks
+		void clear_evaluation_cache();
+
+		/// @brief Hessian computed by the last evaluate with want_hess, valid until the next evaluation
+		const THessian &evaluated_hessian() const { return evaluation_cache_.hess; }
+
+		/// @brief Product of the Hessian at x with v, forms supporting it do not assemble their Hessian
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply the Hessian with
+		/// @param[out] Hv Output product
+		virtual void hessian_vector_product(const TVector &x, const TVector &v, TVector &Hv);
+
 		virtual bool is_step_valid(const TVector &x0, const TVector &x1) override;
 		virtual bool is_step_collision_free(const TVector &x0, const TVector &x1);
 		virtual double max_step_size(const TVector &x0, const TVector &x1) override;
@@ -44,9 +65,31 @@ namespace polyfem::solver
 		{
 			for (auto &form : forms_)
 				form->finish();
+			evaluation_cache_active_ = false;
+			clear_evaluation_cache();
 		}
 
 	protected:
 		std::vector<std::shared_ptr<Form>> forms_;
+
+	private:
+		/// Quantities evaluated at the last iterate
+		struct EvaluationCache
+		{
+			TVector x;
+			std::vector<double> weights; ///< weight of each form, zero if disabled
+			bool has_value = false;
+			double value = 0;
+			bool has_grad = false;
+			TVector grad;
+			bool has_hess = false;
+			THessian hess; ///< persistent, only the values are reset between evaluations
+		};
+
+		EvaluationCache evaluation_cache_;
+		bool evaluation_cache_active_ = false; ///< memoize only during a solve, outside the forms may change without notice
+
+		/// @brief Reset the cache if it does not hold quantities of x with the current weights
+		void prepare_evaluation_cache(const TVector &x);
 	};
 } // namespace polyfem::solver
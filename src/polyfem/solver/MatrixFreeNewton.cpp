@@ -0,0 +1,209 @@
+#include "MatrixFreeNewton.hpp"
+
+#include <polyfem/solver/FullNLProblem.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <polysolve/nonlinear/descent_strategies/GradientDescent.hpp>
+
+#include <igl/Timer.h>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+
+namespace polyfem::solver
+{
+	MatrixFreeNewton::MatrixFreeNewton(const json &solver_params, const json &krylov_params, const double characteristic_length, spdlog::logger &logger)
+		: polysolve::nonlinear::DescentStrategy(solver_params, characteristic_length, logger),
+		  method_(krylov_params["solver"]),
+		  max_iterations_(krylov_params["max_iterations"]),
+		  restart_(krylov_params["restart"]),
+		  max_forcing_(krylov_params["max_forcing"])
+	{
+		if (method_ != "CG" && method_ != "GMRES")
+			log_and_throw_error("Unknown matrix-free Krylov solver {}", method_);
+	}
+
+	std::shared_ptr<polysolve::nonlinear::Solver> MatrixFreeNewton::create_solver(
+		const json &solver_params, const json &krylov_params, const double characteristic_length, spdlog::logger &logger)
+	{
+		auto solver = std::make_shared<polysolve::nonlinear::Solver>(solver_params, characteristic_length, logger);
+		solver->set_line_search(solver_params);
+		solver->add_strategy(std::make_unique<MatrixFreeNewton>(solver_params, krylov_params, characteristic_length, logger));
+		solver->add_strategy(std::make_unique<polysolve::nonlinear::GradientDescent>(solver_params, characteristic_length, logger));
+		solver->set_strategies_iterations(solver_params);
+		return solver;
+	}
+
+	void MatrixFreeNewton::reset(const int ndof)
+	{
+		initial_grad_norm_ = -1;
+	}
+
+	void MatrixFreeNewton::reset_times()
+	{
+		krylov_iterations_ = 0;
+		krylov_time_ = 0;
+	}
+
+	void MatrixFreeNewton::update_solver_info(json &solver_info, const double per_iteration)
+	{
+		solver_info["krylov_solver"] = method_;
+		solver_info["krylov_iterations"] = krylov_iterations_;
+		solver_info["time_krylov"] = krylov_time_ * per_iteration;
+	}
+
+	bool MatrixFreeNewton::compute_update_direction(
+		polysolve::nonlinear::Problem &objFunc,
+		const TVector &x,
+		const TVector &grad,
+		TVector &direction)
+	{
+		FullNLProblem *problem = dynamic_cast<FullNLProblem *>(&objFunc);
+		if (problem == nullptr)
+			log_and_throw_error("Matrix-free Newton requires a problem with Hessian-vector products");
+
+		// the linear solve only needs to be accurate close to the solution (inexact Newton)
+		const double grad_norm = grad.norm();
+		if (initial_grad_norm_ <= 0)
+			initial_grad_norm_ = grad_norm;
+		const double forcing = std::min(max_forcing_, std::sqrt(grad_norm / std::max(initial_grad_norm_, 1e-300)));
+
+		const Operator hessian = [&](const Eigen::VectorXd &v, Eigen::VectorXd &Hv) { problem->hessian_vector_product(x, v, Hv); };
+
+		igl::Timer timer;
+		timer.start();
+		const Eigen::VectorXd rhs = -grad;
+		const int iterations = method_ == "CG"
+								   ? conjugate_gradient(hessian, rhs, forcing, max_iterations_, direction)
+								   : gmres(hessian, rhs, forcing, max_iterations_, restart_, direction);
+		timer.stop();
+		krylov_time_ += timer.getElapsedTimeInSec();
+		krylov_iterations_ += iterations;
+
+		m_logger.trace("Matrix-free Newton: {} {} iterations, forcing {:g}", method_, iterations, forcing);
+
+		if (!direction.allFinite() || direction.squaredNorm() == 0 || direction.dot(grad) >= 0)
+		{
+			m_logger.debug("Matrix-free Newton direction is not a descent direction, reverting to the next strategy");
+			return false;
+		}
+
+		return true;
+	}
+
+	int MatrixFreeNewton::conjugate_gradient(const Operator &A, const Eigen::VectorXd &b, const double tol, const int max_iterations, Eigen::VectorXd &x)
+	{
+		x.setZero(b.size());
+		Eigen::VectorXd r = b;
+		Eigen::VectorXd p = r;
+		Eigen::VectorXd Ap;
+
+		const double threshold = tol * tol * b.squaredNorm();
+		double rr = r.squaredNorm();
+
+		int k = 0;
+		while (k < max_iterations && rr > threshold)
+		{
+			A(p, Ap);
+			++k;
+
+			// the iterates so far are descent directions, stop before leaving the convex region
+			const double pAp = p.dot(Ap);
+			if (pAp <= 0)
+				break;
+
+			const double alpha = rr / pAp;
+			x += alpha * p;
+			r -= alpha * Ap;
+
+			const double rr_next = r.squaredNorm();
+			p = r + (rr_next / rr) * p;
+			rr = rr_next;
+		}
+
+		return k;
+	}
+
+	int MatrixFreeNewton::gmres(const Operator &A, const Eigen::VectorXd &b, const double tol, const int max_iterations, const int restart, Eigen::VectorXd &x)
+	{
+		const int n = b.size();
+		const int m = std::max(1, std::min(restart, max_iterations));
+		const double b_norm = b.norm();
+
+		x.setZero(n);
+		if (b_norm == 0)
+			return 0;
+
+		Eigen::MatrixXd V(n, m + 1);            // Krylov basis
+		Eigen::MatrixXd H = Eigen::MatrixXd::Zero(m + 1, m); // Hessenberg matrix, rotated to upper triangular
+		Eigen::VectorXd cs(m), sn(m), g(m + 1), w;
+
+		Eigen::VectorXd r = b;
+		int k = 0;
+		while (k < max_iterations)
+		{
+			const double beta = r.norm();
+			if (beta <= tol * b_norm)
+				break;
+
+			V.col(0) = r / beta;
+			H.setZero();
+			g.setZero();
+			g(0) = beta;
+
+			int j = 0;
+			for (; j < m && k < max_iterations; ++j)
+			{
+				A(V.col(j), w);
+				++k;
+
+				// modified Gram-Schmidt
+				for (int i = 0; i <= j; ++i)
+				{
+					H(i, j) = w.dot(V.col(i));
+					w -= H(i, j) * V.col(i);
+				}
+				H(j + 1, j) = w.norm();
+				if (H(j + 1, j) > 0)
+					V.col(j + 1) = w / H(j + 1, j);
+
+				// apply the previous rotations, then eliminate the subdiagonal entry
+				for (int i = 0; i < j; ++i)
+				{
+					const double tmp = cs(i) * H(i, j) + sn(i) * H(i + 1, j);
+					H(i + 1, j) = -sn(i) * H(i, j) + cs(i) * H(i + 1, j);
+					H(i, j) = tmp;
+				}
+				const double rho = std::hypot(H(j, j), H(j + 1, j));
+				cs(j) = rho > 0 ? H(j, j) / rho : 1;
+				sn(j) = rho > 0 ? H(j + 1, j) / rho : 0;
+				H(j, j) = rho;
+				H(j + 1, j) = 0;
+				g(j + 1) = -sn(j) * g(j);
+				g(j) = cs(j) * g(j);
+
+				// |g(j + 1)| is the residual norm of the current iterate
+				if (std::abs(g(j + 1)) <= tol * b_norm || H(j, j) == 0)
+				{
+					++j;
+					break;
+				}
+			}
+
+			// x += V y with H y = g on the j columns built in this cycle
+			const Eigen::VectorXd y = H.topLeftCorner(j, j).triangularView<Eigen::Upper>().solve(g.head(j));
+			x += V.leftCols(j) * y;
+
+			if (std::abs(g(j)) <= tol * b_norm || H(j - 1, j - 1) == 0)
+				break;
+
+			// restart from the true residual
+			A(x, w);
+			r = b - w;
+		}
+
+		return k;
+	}
+} // namespace polyfem::solver
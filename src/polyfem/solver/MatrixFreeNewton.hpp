@@ -0,0 +1,61 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+#include <polysolve/nonlinear/Solver.hpp>
+#include <polysolve/nonlinear/descent_strategies/DescentStrategy.hpp>
+
+#include <Eigen/Core>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace polyfem::solver
+{
+	/// Newton direction computed by a Krylov method (CG or GMRES) on the Hessian-vector products of a FullNLProblem,
+	/// the Hessian of the problem is never assembled
+	class MatrixFreeNewton : public polysolve::nonlinear::DescentStrategy
+	{
+	public:
+		using Operator = std::function<void(const Eigen::VectorXd &, Eigen::VectorXd &)>;
+
+		/// @param[in] solver_params nonlinear solver settings
+		/// @param[in] krylov_params solver/advanced/matrix_free settings (Krylov method, iterations, forcing term)
+		MatrixFreeNewton(const json &solver_params, const json &krylov_params, const double characteristic_length, spdlog::logger &logger);
+
+		/// nonlinear solver using the matrix-free Newton direction, falling back to gradient descent
+		static std::shared_ptr<polysolve::nonlinear::Solver> create_solver(
+			const json &solver_params, const json &krylov_params, const double characteristic_length, spdlog::logger &logger);
+
+		std::string name() const override { return "MatrixFreeNewton"; }
+
+		void reset(const int ndof) override;
+		void reset_times() override;
+		void update_solver_info(json &solver_info, const double per_iteration) override;
+
+		bool compute_update_direction(
+			polysolve::nonlinear::Problem &objFunc,
+			const TVector &x,
+			const TVector &grad,
+			TVector &direction) override;
+
+		/// conjugate gradient on A x = b starting from x = 0, stops at the first direction of non-positive curvature
+		/// @return number of iterations, x holds the last iterate (zero if the first direction has non-positive curvature)
+		static int conjugate_gradient(const Operator &A, const Eigen::VectorXd &b, const double tol, const int max_iterations, Eigen::VectorXd &x);
+
+		/// restarted GMRES on A x = b starting from x = 0
+		/// @return number of iterations (products with A)
+		static int gmres(const Operator &A, const Eigen::VectorXd &b, const double tol, const int max_iterations, const int restart, Eigen::VectorXd &x);
+
+	private:
+		std::string method_;    ///< CG or GMRES
+		int max_iterations_;    ///< maximum Krylov iterations per direction
+		int restart_;           ///< GMRES restart length
+		double max_forcing_;    ///< upper bound of the relative residual of the linear solve
+		double initial_grad_norm_ = -1;
+
+		long krylov_iterations_ = 0;
+		double krylov_time_ = 0;
+	};
+} // namespace polyfem::solver
@@ -0,0 +1,94 @@
+#include "ModifiedNewton.hpp"
+
+#include <polyfem/solver/NLProblem.hpp>
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/Types.hpp>
+
+#include <polysolve/nonlinear/descent_strategies/GradientDescent.hpp>
+
+#include <igl/Timer.h>
+
+namespace polyfem::solver
+{
+	ModifiedNewton::ModifiedNewton(const json &solver_params, const json &linear_solver_params, const double characteristic_length, spdlog::logger &logger)
+		: polysolve::nonlinear::DescentStrategy(solver_params, characteristic_length, logger),
+		  linear_solver_(polysolve::linear::Solver::create(linear_solver_params, logger))
+	{
+	}
+
+	std::shared_ptr<polysolve::nonlinear::Solver> ModifiedNewton::create_solver(
+		const json &solver_params, const json &linear_solver_params, const double characteristic_length, spdlog::logger &logger)
+	{
+		auto solver = std::make_shared<polysolve::nonlinear::Solver>(solver_params, characteristic_length, logger);
+		solver->set_line_search(solver_params);
+		solver->add_strategy(std::make_unique<ModifiedNewton>(solver_params, linear_solver_params, characteristic_length, logger));
+		solver->add_strategy(std::make_unique<polysolve::nonlinear::GradientDescent>(solver_params, characteristic_length, logger));
+		solver->set_strategies_iterations(solver_params);
+		return solver;
+	}
+
+	void ModifiedNewton::reset_times()
+	{
+		n_factorizations_ = 0;
+		n_saved_factorizations_ = 0;
+		factorization_time_ = 0;
+		solve_time_ = 0;
+	}
+
+	void ModifiedNewton::update_solver_info(json &solver_info, const double per_iteration)
+	{
+		solver_info["factorizations"] = n_factorizations_;
+		solver_info["saved_factorizations"] = n_saved_factorizations_;
+		solver_info["time_factorization"] = factorization_time_ * per_iteration;
+		solver_info["time_linear_solve"] = solve_time_ * per_iteration;
+	}
+
+	bool ModifiedNewton::compute_update_direction(
+		polysolve::nonlinear::Problem &objFunc,
+		const TVector &x,
+		const TVector &grad,
+		TVector &direction)
+	{
+		NLProblem *problem = dynamic_cast<NLProblem *>(&objFunc);
+		if (problem == nullptr)
+			log_and_throw_error("Modified Newton requires an NLProblem");
+
+		StiffnessMatrix hessian;
+		problem->hessian(x, hessian);
+
+		igl::Timer timer;
+		// the problem handed out the Hessian that is already factorized
+		if (problem != factorized_problem_ || problem->hessian_revision() != factorized_revision_)
+		{
+			timer.start();
+			linear_solver_->analyze_pattern(hessian, hessian.rows());
+			linear_solver_->factorize(hessian);
+			timer.stop();
+			factorization_time_ += timer.getElapsedTimeInSec();
+
+			factorized_problem_ = problem;
+			factorized_revision_ = problem->hessian_revision();
+			++n_factorizations_;
+		}
+		else
+		{
+			++n_saved_factorizations_;
+		}
+
+		timer.start();
+		direction.setZero(grad.size());
+		linear_solver_->solve(-grad, direction);
+		timer.stop();
+		solve_time_ += timer.getElapsedTimeInSec();
+
+		if (!direction.allFinite() || direction.squaredNorm() == 0 || direction.dot(grad) >= 0)
+		{
+			m_logger.debug("Modified Newton direction is not a descent direction, reverting to the next strategy");
+			// the next direction is computed with a freshly assembled (and factorized) Hessian
+			problem->invalidate_reused_hessian();
+			return false;
+		}
+
+		return true;
+	}
+} // namespace polyfem::solver
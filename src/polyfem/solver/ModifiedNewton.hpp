@@ -0,0 +1,56 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+#include <polysolve/linear/Solver.hpp>
+#include <polysolve/nonlinear/Solver.hpp>
+#include <polysolve/nonlinear/descent_strategies/DescentStrategy.hpp>
+
+#include <memory>
+#include <string>
+
+namespace polyfem::solver
+{
+	class NLProblem;
+
+	/// Newton direction solved with the factorization of the last assembled Hessian of an NLProblem,
+	/// the linear solver is only refactorized when the problem assembles a new Hessian (see NLProblem::set_hessian_reuse)
+	class ModifiedNewton : public polysolve::nonlinear::DescentStrategy
+	{
+	public:
+		/// @param[in] solver_params nonlinear solver settings
+		/// @param[in] linear_solver_params settings of the linear solver used for the Newton system
+		ModifiedNewton(const json &solver_params, const json &linear_solver_params, const double characteristic_length, spdlog::logger &logger);
+
+		/// nonlinear solver using the modified Newton direction, falling back to gradient descent
+		static std::shared_ptr<polysolve::nonlinear::Solver> create_solver(
+			const json &solver_params, const json &linear_solver_params, const double characteristic_length, spdlog::logger &logger);
+
+		std::string name() const override { return "ModifiedNewton"; }
+
+		void reset_times() override;
+		void update_solver_info(json &solver_info, const double per_iteration) override;
+
+		bool compute_update_direction(
+			polysolve::nonlinear::Problem &objFunc,
+			const TVector &x,
+			const TVector &grad,
+			TVector &direction) override;
+
+		/// number of factorizations since the last reset_times()
+		long n_factorizations() const { return n_factorizations_; }
+		/// number of directions solved with an existing factorization since the last reset_times()
+		long n_saved_factorizations() const { return n_saved_factorizations_; }
+
+	private:
+		std::unique_ptr<polysolve::linear::Solver> linear_solver_;
+
+		const NLProblem *factorized_problem_ = nullptr; ///< problem whose Hessian is factorized
+		long factorized_revision_ = -1;                 ///< NLProblem::hessian_revision() of the factorized Hessian
+
+		long n_factorizations_ = 0;
+		long n_saved_factorizations_ = 0;
+		double factorization_time_ = 0;
+		double solve_time_ = 0;
+	};
+} // namespace polyfem::solver
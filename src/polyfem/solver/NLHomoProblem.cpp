@@ -191,6 +191,13 @@ namespace polyfem::solver
 			}
 	}
 
+	void NLHomoProblem::hessian_vector_product(const TVector &x, const TVector &v, TVector &Hv)
+	{
+		THessian H;
+		hessian(x, H);
+		Hv = H * v;
+	}
+
 	void NLHomoProblem::set_fixed_entry(const Eigen::VectorXi &fixed_entry)
 	{
 		const int dim = state_.mesh->dimension();
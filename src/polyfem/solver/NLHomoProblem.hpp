@@ -32,6 +32,8 @@ namespace polyfem::solver
 		double value(const TVector &x) override;
 		void gradient(const TVector &x, TVector &gradv) override;
 		void hessian(const TVector &x, THessian &hessian) override;
+		/// the macro strain couples all the dofs, the product uses the assembled Hessian
+		void hessian_vector_product(const TVector &x, const TVector &v, TVector &Hv) override;
 
 		void full_hessian_to_reduced_hessian(const THessian &full, THessian &reduced) const override;
 
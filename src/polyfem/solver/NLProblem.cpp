@@ -3,6 +3,8 @@
 #include <polyfem/io/OBJWriter.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
 
+#include <algorithm>
+
 /*
 m \frac{\partial^2 u}{\partial t^2} = \psi = \text{div}(\sigma[u])\newline
 u^{t+1} = u(t+\Delta t)\approx u(t) + \Delta t \dot u + \frac{\Delta t^2} 2 \ddot u \newline
@@ -30,6 +32,7 @@ namespace polyfem::solver
 	{
 		setup_constrain_nodes();
 		reduced_size_ = full_size_ - constraint_nodes_.size();
+		setup_reduction_maps();
 
 		use_reduced_size();
 	}
@@ -51,6 +54,7 @@ namespace polyfem::solver
 
 		assert(std::is_sorted(constraint_nodes_.begin(), constraint_nodes_.end()));
 		assert(constraint_nodes_.size() == 0 || (constraint_nodes_.front() >= 0 && constraint_nodes_.back() < full_size_));
+		setup_reduction_maps();
 		use_reduced_size();
 	}
 
@@ -67,14 +71,80 @@ namespace polyfem::solver
 		constraint_nodes_.resize(std::distance(constraint_nodes_.begin(), it));
 	}
 
+	void NLProblem::setup_reduction_maps()
+	{
+		const int mid_size = periodic_bc_ ? periodic_bc_->n_periodic_dof() : full_size_;
+		assert(mid_size - int(constraint_nodes_.size()) == reduced_size_);
+
+		Eigen::VectorXi mid_to_reduced(mid_size);
+		int j = 0;
+		size_t k = 0;
+		for (int i = 0; i < mid_size; ++i)
+		{
+			if (k < constraint_nodes_.size() && constraint_nodes_[k] == i)
+			{
+				++k;
+				mid_to_reduced(i) = -1;
+			}
+			else
+				mid_to_reduced(i) = j++;
+		}
+		assert(j == reduced_size_);
+
+		full_to_mid_index_.resize(full_size_);
+		full_to_reduced_index_.resize(full_size_);
+		reduced_to_full_index_.setConstant(reduced_size_, -1);
+		for (int i = 0; i < full_size_; ++i)
+		{
+			full_to_mid_index_(i) = periodic_bc_ ? periodic_bc_->full_to_periodic_index(i) : i;
+			full_to_reduced_index_(i) = mid_to_reduced(full_to_mid_index_(i));
+			// values of periodic copies are taken from the last one, as in PeriodicBoundary::full_to_periodic
+			if (full_to_reduced_index_(i) >= 0)
+				reduced_to_full_index_(full_to_reduced_index_(i)) = i;
+		}
+		assert(reduced_to_full_index_.size() == 0 || reduced_to_full_index_.minCoeff() >= 0);
+
+		hessian_reductions_.clear();
+	}
+
+	void NLProblem::init(const TVector &x0)
+	{
+		FullNLProblem::init(x0);
+
+		HessianReuse &r = hessian_reuse_;
+		r.n_reused = 0;
+		r.prev_grad_norm = -1;
+		r.pending_step = false;
+		if (!r.across_solves)
+			r.stale = true;
+	}
+
+	void NLProblem::set_hessian_reuse(const bool enabled, const double max_rate, const int max_reuses, const bool across_solves)
+	{
+		hessian_reuse_ = HessianReuse();
+		hessian_reuse_.enabled = enabled;
+		hessian_reuse_.max_rate = max_rate;
+		hessian_reuse_.max_reuses = max_reuses;
+		hessian_reuse_.across_solves = across_solves;
+	}
+
+	void NLProblem::set_project_to_psd(bool val)
+	{
+		hessian_reuse_.stale = true;
+		FullNLProblem::set_project_to_psd(val);
+	}
+
 	void NLProblem::init_lagging(const TVector &x)
 	{
 		FullNLProblem::init_lagging(reduced_to_full(x));
+		hessian_reuse_.stale = true;
 	}
 
 	void NLProblem::update_lagging(const TVector &x, const int iter_num)
 	{
 		FullNLProblem::update_lagging(reduced_to_full(x), iter_num);
+		// the lagged quantities (e.g., friction) are part of the Hessian
+		hessian_reuse_.stale = true;
 	}
 
 	void NLProblem::update_quantities(const double t, const TVector &x)
@@ -83,6 +153,10 @@ namespace polyfem::solver
 		const TVector full = reduced_to_full(x);
 		for (auto &f : forms_)
 			f->update_quantities(t, full);
+		clear_evaluation_cache();
+		// the convergence rate check refreshes the Hessian if it is too far off the new time step
+		if (!hessian_reuse_.across_solves)
+			hessian_reuse_.stale = true;
 	}
 
 	void NLProblem::line_search_begin(const TVector &x0, const TVector &x1)
@@ -120,10 +194,53 @@ namespace polyfem::solver
 
 	void NLProblem::hessian(const TVector &x, THessian &hessian)
 	{
-		THessian full_hessian;
-		FullNLProblem::hessian(reduced_to_full(x), full_hessian);
+		HessianReuse &r = hessian_reuse_;
+		// a second request without a step in between means the old Hessian did not give a usable direction
+		if (r.enabled && !r.stale && !r.pending_step && r.uses < r.max_reuses && r.hessian.rows() == x.size()
+			&& r.weights == hessian_weights())
+		{
+			hessian = r.hessian;
+			++r.uses;
+			++r.n_reused;
+			r.pending_step = true;
+			return;
+		}
+
+		// reduce straight from the persistent full Hessian
+		evaluate(reduced_to_full(x), false, false, true);
+		full_hessian_to_reduced_hessian(evaluated_hessian(), hessian);
+		++r.revision;
+
+		if (r.enabled)
+		{
+			r.hessian = hessian;
+			r.weights = hessian_weights();
+			r.stale = false;
+			r.uses = 0;
+			r.pending_step = true;
+		}
+	}
+
+	std::vector<double> NLProblem::hessian_weights() const
+	{
+		std::vector<double> weights;
+		weights.reserve(forms_.size() + penalty_forms_.size());
+		for (const auto &f : forms_)
+			weights.push_back(f->enabled() ? f->weight() : 0);
+		for (const auto &f : penalty_forms_)
+			weights.push_back(f->penalty_weight());
+		return weights;
+	}
+
+	void NLProblem::hessian_vector_product(const TVector &x, const TVector &v, TVector &Hv)
+	{
+		// v is a direction, it vanishes on the constrained dofs
+		TVector full_v;
+		reduced_to_full_aux(v, Eigen::MatrixXd::Zero(full_size(), 1), full_v);
 
-		full_hessian_to_reduced_hessian(full_hessian, hessian);
+		TVector full_Hv;
+		FullNLProblem::hessian_vector_product(reduced_to_full(x), full_v, full_Hv);
+		Hv = full_to_reduced_grad(full_Hv);
 	}
 
 	void NLProblem::solution_changed(const TVector &newX)
@@ -135,6 +252,16 @@ namespace polyfem::solver
 	{
 		FullNLProblem::post_step(polysolve::nonlinear::PostStepData(data.iter_num, data.solver_info, reduced_to_full(data.x), reduced_to_full(data.grad)));
 
+		HessianReuse &r = hessian_reuse_;
+		if (r.enabled)
+		{
+			const double grad_norm = data.grad.norm();
+			if (r.prev_grad_norm > 0 && grad_norm > r.max_rate * r.prev_grad_norm)
+				r.stale = true;
+			r.prev_grad_norm = grad_norm;
+			r.pending_step = false;
+		}
+
 		// TODO: add me back
 		// if (state_.args["output"]["advanced"]["save_nl_solve_sequence"])
 		// {
@@ -149,21 +276,21 @@ namespace polyfem::solver
 	NLProblem::TVector NLProblem::full_to_reduced(const TVector &full) const
 	{
 		TVector reduced;
-		full_to_reduced_aux(constraint_nodes_, full_size(), current_size(), full, reduced);
+		full_to_reduced_aux(full, reduced);
 		return reduced;
 	}
 
 	NLProblem::TVector NLProblem::full_to_reduced_grad(const TVector &full) const
 	{
 		TVector reduced;
-		full_to_reduced_aux_grad(constraint_nodes_, full_size(), current_size(), full, reduced);
+		full_to_reduced_aux_grad(full, reduced);
 		return reduced;
 	}
 
 	NLProblem::TVector NLProblem::reduced_to_full(const TVector &reduced) const
 	{
 		TVector full;
-		reduced_to_full_aux(constraint_nodes_, full_size(), current_size(), reduced, constraint_values(reduced), full);
+		reduced_to_full_aux(reduced, constraint_values(reduced), full);
 		return full;
 	}
 
@@ -181,128 +308,163 @@ namespace polyfem::solver
 		return result;
 	}
 
-	template <class FullMat, class ReducedMat>
-	void NLProblem::full_to_reduced_aux(const std::vector<int> &constraint_nodes, const int full_size, const int reduced_size, const FullMat &full, ReducedMat &reduced) const
+	void NLProblem::full_to_reduced_aux(const TVector &full, TVector &reduced) const
 	{
-		using namespace polyfem;
-
 		// Reduced is already at the full size
-		if (full_size == reduced_size || full.size() == reduced_size)
+		if (full_size() == current_size() || full.size() == current_size())
 		{
 			reduced = full;
 			return;
 		}
 
-		assert(full.size() == full_size);
-		assert(full.cols() == 1);
-		reduced.resize(reduced_size, 1);
-
-		Eigen::MatrixXd mid;
-		if (periodic_bc_)
-			mid = periodic_bc_->full_to_periodic(full, false);
-		else
-			mid = full;
-
-		assert(std::is_sorted(constraint_nodes.begin(), constraint_nodes.end()));
+		assert(full.size() == full_size());
+		reduced.resize(reduced_size_);
+		for (int j = 0; j < reduced_size_; ++j)
+			reduced(j) = full(reduced_to_full_index_(j));
+	}
 
-		long j = 0;
-		size_t k = 0;
-		for (int i = 0; i < mid.size(); ++i)
+	void NLProblem::reduced_to_full_aux(const TVector &reduced, const Eigen::MatrixXd &rhs, TVector &full) const
+	{
+		// Full is already at the reduced size
+		if (full_size() == current_size() || full_size() == reduced.size())
 		{
-			if (k < constraint_nodes.size() && constraint_nodes[k] == i)
-			{
-				++k;
-				continue;
-			}
+			full = reduced;
+			return;
+		}
 
-			assert(j < reduced.size());
-			reduced(j++) = mid(i);
+		assert(reduced.size() == reduced_size_);
+		full.resize(full_size_);
+		for (int i = 0; i < full_size_; ++i)
+		{
+			const int j = full_to_reduced_index_(i);
+			full(i) = j >= 0 ? reduced(j) : rhs(full_to_mid_index_(i));
 		}
 	}
 
-	template <class ReducedMat, class FullMat>
-	void NLProblem::reduced_to_full_aux(const std::vector<int> &constraint_nodes, const int full_size, const int reduced_size, const ReducedMat &reduced, const Eigen::MatrixXd &rhs, FullMat &full) const
+	void NLProblem::full_to_reduced_aux_grad(const TVector &full, TVector &reduced) const
 	{
-		using namespace polyfem;
-
-		// Full is already at the reduced size
-		if (full_size == reduced_size || full_size == reduced.size())
+		// Reduced is already at the full size
+		if (full_size() == current_size() || full.size() == current_size())
 		{
-			full = reduced;
+			reduced = full;
 			return;
 		}
 
-		assert(reduced.size() == reduced_size);
-		assert(reduced.cols() == 1);
-		full.resize(full_size, 1);
-
-		assert(std::is_sorted(constraint_nodes.begin(), constraint_nodes.end()));
+		assert(full.size() == full_size());
+		// periodic copies accumulate into the same reduced dof
+		reduced.setZero(reduced_size_);
+		for (int i = 0; i < full_size_; ++i)
+		{
+			const int j = full_to_reduced_index_(i);
+			if (j >= 0)
+				reduced(j) += full(i);
+		}
+	}
 
-		long j = 0;
-		size_t k = 0;
-		Eigen::MatrixXd mid(reduced_size + constraint_nodes.size(), 1);
-		for (int i = 0; i < mid.size(); ++i)
+	const NLProblem::HessianReduction &NLProblem::hessian_reduction(const THessian &full) const
+	{
+		// one slot per shape, NLHomoProblem reduces both the full and the extended (macro strain) Hessian
+		for (HessianReduction &r : hessian_reductions_)
 		{
-			if (k < constraint_nodes.size() && constraint_nodes[k] == i)
-			{
-				++k;
-				mid(i) = rhs(i);
+			if (r.rows != full.rows())
 				continue;
-			}
-
-			mid(i) = reduced(j++);
+			if (!hessian_reduction_matches(r, full))
+				build_hessian_reduction(full, r);
+			return r;
 		}
 
-		full = periodic_bc_ ? periodic_bc_->periodic_to_full(full_size, mid) : mid;
+		build_hessian_reduction(full, hessian_reductions_.emplace_back());
+		return hessian_reductions_.back();
 	}
 
-	template <class FullMat, class ReducedMat>
-	void NLProblem::full_to_reduced_aux_grad(const std::vector<int> &constraint_nodes, const int full_size, const int reduced_size, const FullMat &full, ReducedMat &reduced) const
+	bool NLProblem::hessian_reduction_matches(const HessianReduction &r, const THessian &full)
 	{
-		using namespace polyfem;
+		return r.rows == full.rows()
+			   && Eigen::Index(r.inner.size()) == full.nonZeros()
+			   && std::equal(r.outer.begin(), r.outer.end(), full.outerIndexPtr())
+			   && std::equal(r.inner.begin(), r.inner.end(), full.innerIndexPtr());
+	}
 
-		// Reduced is already at the full size
-		if (full_size == reduced_size || full.size() == reduced_size)
-		{
-			reduced = full;
-			return;
-		}
+	void NLProblem::build_hessian_reduction(const THessian &full, HessianReduction &r) const
+	{
+		assert(full.isCompressed());
 
-		assert(full.size() == full_size);
-		assert(full.cols() == 1);
-		reduced.resize(reduced_size, 1);
+		r.rows = full.rows();
+		r.outer.assign(full.outerIndexPtr(), full.outerIndexPtr() + full.outerSize() + 1);
+		r.inner.assign(full.innerIndexPtr(), full.innerIndexPtr() + full.nonZeros());
 
-		Eigen::MatrixXd mid;
-		if (periodic_bc_)
-			mid = periodic_bc_->full_to_periodic(full, true);
-		else
-			mid = full;
+		const int n_reduced = full_to_reduced_index(full.rows());
 
-		long j = 0;
-		size_t k = 0;
-		for (int i = 0; i < mid.size(); ++i)
+		std::vector<Eigen::Triplet<double>> entries;
+		entries.reserve(full.nonZeros());
+		for (int k = 0; k < full.outerSize(); ++k)
 		{
-			if (k < constraint_nodes.size() && constraint_nodes[k] == i)
-			{
-				++k;
+			const int c = full_to_reduced_index(k);
+			if (c < 0)
 				continue;
+			for (THessian::InnerIterator it(full, k); it; ++it)
+			{
+				const int row = full_to_reduced_index(it.row());
+				if (row >= 0)
+					entries.emplace_back(row, c, 0.);
 			}
+		}
 
-			reduced(j++) = mid(i);
+		r.pattern.resize(n_reduced, n_reduced);
+		r.pattern.setFromTriplets(entries.begin(), entries.end());
+		r.pattern.makeCompressed();
+
+		r.value_map.assign(full.nonZeros(), -1);
+		const auto *outer = r.pattern.outerIndexPtr();
+		const auto *inner = r.pattern.innerIndexPtr();
+		for (int k = 0; k < full.outerSize(); ++k)
+		{
+			const int c = full_to_reduced_index(k);
+			if (c < 0)
+				continue;
+			for (auto l = full.outerIndexPtr()[k]; l < full.outerIndexPtr()[k + 1]; ++l)
+			{
+				const int row = full_to_reduced_index(full.innerIndexPtr()[l]);
+				if (row < 0)
+					continue;
+				const auto *pos = std::lower_bound(inner + outer[c], inner + outer[c + 1], row);
+				assert(pos != inner + outer[c + 1] && *pos == row);
+				r.value_map[l] = int(pos - inner);
+			}
 		}
 	}
 
 	void NLProblem::full_hessian_to_reduced_hessian(const THessian &full, THessian &reduced) const
 	{
 		// POLYFEM_SCOPED_TIMER("\tfull hessian to reduced hessian");
-		THessian mid = full;
+		if (current_size() == full_size() && !periodic_bc_)
+		{
+			reduced = full;
+			return;
+		}
+
+		if (current_size() == full_size() || !full.isCompressed())
+		{
+			THessian mid = full;
+
+			if (periodic_bc_)
+				periodic_bc_->full_to_periodic(mid);
+
+			if (current_size() < full_size())
+				utils::full_to_reduced_matrix(mid.rows(), mid.rows() - constraint_nodes_.size(), constraint_nodes_, mid, reduced);
+			else
+				reduced = mid;
+			return;
+		}
 
-		if (periodic_bc_)
-			periodic_bc_->full_to_periodic(mid);
+		const HessianReduction &r = hessian_reduction(full);
 
-		if (current_size() < full_size())
-			utils::full_to_reduced_matrix(mid.rows(), mid.rows() - constraint_nodes_.size(), constraint_nodes_, mid, reduced);
-		else
-			reduced = mid;
+		// copying the pattern reuses the storage of reduced once it has the right size
+		reduced = r.pattern;
+		double *values = reduced.valuePtr();
+		const double *full_values = full.valuePtr();
+		for (size_t l = 0; l < r.value_map.size(); ++l)
+			if (r.value_map[l] >= 0)
+				values[r.value_map[l]] += full_values[l];
 	}
 } // namespace polyfem::solver
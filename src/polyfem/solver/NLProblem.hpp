@@ -27,9 +27,12 @@ namespace polyfem::solver
 				  const std::vector<std::shared_ptr<AugmentedLagrangianForm>> &penalty_forms);
 		virtual ~NLProblem() = default;
 
+		void init(const TVector &x0) override;
+
 		virtual double value(const TVector &x) override;
 		virtual void gradient(const TVector &x, TVector &gradv) override;
 		virtual void hessian(const TVector &x, THessian &hessian) override;
+		virtual void hessian_vector_product(const TVector &x, const TVector &v, TVector &Hv) override;
 
 		virtual bool is_step_valid(const TVector &x0, const TVector &x1) override;
 		virtual bool is_step_collision_free(const TVector &x0, const TVector &x1) override;
@@ -39,6 +42,8 @@ namespace polyfem::solver
 
 		void solution_changed(const TVector &new_x) override;
 
+		void set_project_to_psd(bool val) override;
+
 		void init_lagging(const TVector &x) override;
 		void update_lagging(const TVector &x, const int iter_num) override;
 
@@ -49,6 +54,23 @@ namespace polyfem::solver
 		int full_size() const { return full_size_; }
 		int reduced_size() const { return reduced_size_; }
 
+		/// @brief Is the full dof i fixed by the constraints (e.g., Dirichlet boundary conditions)
+		bool is_constrained(const int i) const { return full_to_reduced_index_(i) < 0; }
+
+		/// @brief Reuse the last assembled Hessian across Newton iterations, used with ModifiedNewton to also reuse its factorization
+		/// @param enabled If false, the Hessian is assembled at every call
+		/// @param max_rate The Hessian is refreshed after a step with \f$\|g_{k+1}\| > \text{max\_rate}\|g_k\|\f$
+		/// @param max_reuses Maximum number of consecutive uses of the same Hessian
+		/// @param across_solves Keep the last Hessian from one solve (i.e., init) to the next, including across time steps
+		void set_hessian_reuse(const bool enabled, const double max_rate, const int max_reuses, const bool across_solves);
+		bool reuses_hessian() const { return hessian_reuse_.enabled; }
+		/// @brief Number of Hessian assemblies skipped (the last assembled Hessian was returned) since the last init
+		int n_reused_assemblies() const { return hessian_reuse_.n_reused; }
+		/// @brief Incremented every time hessian() assembles a new Hessian, equal revisions mean the same matrix
+		long hessian_revision() const { return hessian_reuse_.revision; }
+		/// @brief Force the next hessian() call to assemble (e.g., the reused Hessian gave no descent direction)
+		void invalidate_reused_hessian() { hessian_reuse_.stale = true; }
+
 		void use_full_size() { current_size_ = CurrentSize::FULL_SIZE; }
 		void use_reduced_size() { current_size_ = CurrentSize::REDUCED_SIZE; }
 
@@ -85,13 +107,61 @@ namespace polyfem::solver
 
 		void setup_constrain_nodes();
 
-		template <class FullMat, class ReducedMat>
-		void full_to_reduced_aux(const std::vector<int> &constraint_nodes, const int full_size, const int reduced_size, const FullMat &full, ReducedMat &reduced) const;
+		/// @brief Precompute the index maps between full and reduced dofs, to be called once the constraint nodes are known
+		void setup_reduction_maps();
+
+		/// @brief Reduced index of a full dof (rows past the full size, e.g. macro strain, are shifted), -1 if constrained
+		inline int full_to_reduced_index(const int i) const
+		{
+			return i < full_to_reduced_index_.size() ? full_to_reduced_index_(i) : (i - full_size_ + reduced_size_);
+		}
+
+		void full_to_reduced_aux(const TVector &full, TVector &reduced) const;
+		void reduced_to_full_aux(const TVector &reduced, const Eigen::MatrixXd &rhs, TVector &full) const;
+		void full_to_reduced_aux_grad(const TVector &full, TVector &reduced) const;
+
+		Eigen::VectorXi full_to_mid_index_;     ///< full dof to periodic dof (identity without periodic bc)
+		Eigen::VectorXi full_to_reduced_index_; ///< full dof to reduced dof, -1 for constrained dofs
+		Eigen::VectorXi reduced_to_full_index_; ///< reduced dof to the last full dof mapped to it
 
-		template <class ReducedMat, class FullMat>
-		void reduced_to_full_aux(const std::vector<int> &constraint_nodes, const int full_size, const int reduced_size, const ReducedMat &reduced, const Eigen::MatrixXd &rhs, FullMat &full) const;
+		/// Reduction of a full Hessian, rebuilt only when the pattern of the full Hessian changes
+		struct HessianReduction
+		{
+			Eigen::Index rows = -1;
+			std::vector<THessian::StorageIndex> outer, inner; ///< pattern of the full Hessian
+			std::vector<int> value_map;                        ///< full non-zero to reduced non-zero, -1 if dropped
+			THessian pattern;                                  ///< reduced pattern, zero values
+		};
+		mutable std::vector<HessianReduction> hessian_reductions_; ///< one per number of rows of the full Hessian
 
-		template <class FullMat, class ReducedMat>
-		void full_to_reduced_aux_grad(const std::vector<int> &constraint_nodes, const int full_size, const int reduced_size, const FullMat &full, ReducedMat &reduced) const;
+		/// Last reduced Hessian and the state of the reuse policy
+		struct HessianReuse
+		{
+			bool enabled = false;
+			double max_rate = 0.5;
+			int max_reuses = 10;
+			bool across_solves = false;
+
+			THessian hessian;           ///< last assembled reduced Hessian
+			bool stale = true;          ///< the Hessian must be reassembled at the next call
+			bool pending_step = false;  ///< a Hessian was handed out and no step was taken since
+			int uses = 0;               ///< number of reuses of the current Hessian
+			double prev_grad_norm = -1; ///< gradient norm after the previous step, negative if none
+			int n_reused = 0;           ///< number of reuses since the last init
+			long revision = 0;          ///< number of assembled Hessians
+			std::vector<double> weights; ///< form weights and AL penalties the Hessian was assembled with
+		};
+		HessianReuse hessian_reuse_;
+
+		/// @brief Weights scaling the form Hessians, the lagged Hessian is invalid once they change
+		/// (e.g., adaptive barrier stiffness, AL penalty weight, enabled/disabled forms)
+		std::vector<double> hessian_weights() const;
+
+		/// @brief Reduction for the shape of full, built or rebuilt if its pattern changed
+		const HessianReduction &hessian_reduction(const THessian &full) const;
+		/// @brief Check if the reduction r was built for the pattern of full
+		static bool hessian_reduction_matches(const HessianReduction &r, const THessian &full);
+		/// @brief Build the reduced pattern and the value map of full into r
+		void build_hessian_reduction(const THessian &full, HessianReduction &r) const;
 	};
 } // namespace polyfem::solver
@@ -75,6 +75,11 @@ namespace polyfem::solver
 		hessian.resize(x.size(), x.size());
 	}
 
+	void BodyForm::hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+	{
+		Hv.setZero(x.size());
+	}
+
 	void BodyForm::update_quantities(const double t, const Eigen::VectorXd &x)
 	{
 		this->t_ = t;
@@ -120,8 +125,7 @@ namespace polyfem::solver
 
 			for (int e = start; e < end; ++e)
 			{
-				assembler::ElementAssemblyValues &vals = local_storage.vals;
-				rhs_assembler_.ass_vals_cache().compute(e, rhs_assembler_.mesh().is_volume(), bases[e], gbases[e], vals);
+				const assembler::ElementAssemblyValues &vals = rhs_assembler_.ass_vals_cache().get(e, rhs_assembler_.mesh().is_volume(), bases[e], gbases[e], local_storage.vals);
 				assembler::ElementAssemblyValues &gvals = local_storage.gvals;
 				gvals.compute(e, rhs_assembler_.mesh().is_volume(), vals.quadrature.points, gbases[e], gbases[e]);
 
@@ -136,7 +140,7 @@ namespace polyfem::solver
 				rhs_function *= -1;
 				for (int q = 0; q < vals.val.rows(); q++)
 				{
-					const double rho = density_(quadrature.points.row(q), vals.val.row(q), t, e);
+					const double rho = density_(vals, q, t);
 					rhs_function.row(q) *= rho;
 				}
 
@@ -47,6 +47,18 @@ namespace polyfem::solver
 		/// @param[out] hessian Output Hessian of the value wrt x
 		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override;
 
+		/// @brief The body forces are linear, nothing is added to the Hessian
+		/// @param[in] x Current solution
+		/// @param[in] weight Scaling of the second derivative
+		/// @param[in,out] hessian Hessian receiving the contribution of the form
+		void add_second_derivative_unweighted(const Eigen::VectorXd &x, const double weight, StiffnessMatrix &hessian) const override {}
+
+		/// @brief Compute the product of the second derivative wrt x with v, the body forces are linear so it is zero
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply the Hessian with
+		/// @param[out] Hv Output product of the Hessian of the value wrt x with v
+		void hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const override;
+
 	public:
 		/// @brief Update time dependent quantities
 		/// @param t New time
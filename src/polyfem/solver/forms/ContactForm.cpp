@@ -15,6 +15,8 @@
 
 #include <igl/writePLY.h>
 
+#include <atomic>
+
 namespace polyfem::solver
 {
 	ContactForm::ContactForm(const ipc::CollisionMesh &collision_mesh,
@@ -26,9 +28,11 @@ namespace polyfem::solver
 							 const bool enable_shape_derivatives,
 							 const ipc::BroadPhaseMethod broad_phase_method,
 							 const double ccd_tolerance,
-							 const int ccd_max_iterations)
+							 const int ccd_max_iterations,
+							 const double dmin)
 		: collision_mesh_(collision_mesh),
 		  dhat_(dhat),
+		  dmin_(dmin),
 		  use_adaptive_barrier_stiffness_(use_adaptive_barrier_stiffness),
 		  avg_mass_(avg_mass),
 		  is_time_dependent_(is_time_dependent),
@@ -39,6 +43,7 @@ namespace polyfem::solver
 		  barrier_potential_(dhat)
 	{
 		assert(dhat_ > 0);
+		assert(dmin_ >= 0);
 		assert(ccd_tolerance > 0);
 
 		prev_distance_ = -1;
@@ -129,17 +134,16 @@ namespace polyfem::solver
 	void ContactForm::update_collision_set(const Eigen::MatrixXd &displaced_surface)
 	{
 		// Store the previous value used to compute the constraint set to avoid duplicate computation.
-		static Eigen::MatrixXd cached_displaced_surface;
-		if (cached_displaced_surface.size() == displaced_surface.size() && cached_displaced_surface == displaced_surface)
+		if (is_collision_set_current(displaced_surface))
 			return;
 
-		if (use_cached_candidates_)
+		if (use_cached_candidates_ || candidates_cover(displaced_surface, displaced_surface))
 			collision_set_.build(
-				candidates_, collision_mesh_, displaced_surface, dhat_);
+				candidates_, collision_mesh_, displaced_surface, dhat_, dmin_);
 		else
 			collision_set_.build(
 				collision_mesh_, displaced_surface, dhat_, dmin_, broad_phase_method_);
-		cached_displaced_surface = displaced_surface;
+		collision_set_surface_ = displaced_surface;
 	}
 
 	double ContactForm::value_unweighted(const Eigen::VectorXd &x) const
@@ -210,6 +214,14 @@ namespace polyfem::solver
 		hessian = collision_mesh_.to_full_dof(hessian);
 	}
 
+	void ContactForm::hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+	{
+		POLYFEM_SCOPED_TIMER("barrier hessian vector product");
+		const StiffnessMatrix surface_hessian = barrier_potential_.hessian(collision_set_, collision_mesh_, compute_displaced_surface(x), project_to_psd_);
+		const Eigen::VectorXd surface_v = utils::flatten(collision_mesh_.map_displacements(utils::unflatten(v, collision_mesh_.dim())));
+		Hv = collision_mesh_.to_full_dof(Eigen::VectorXd(surface_hessian * surface_v));
+	}
+
 	void ContactForm::solution_changed(const Eigen::VectorXd &new_x)
 	{
 		update_collision_set(compute_displaced_surface(new_x));
@@ -229,24 +241,31 @@ namespace polyfem::solver
 			igl::writePLY(resolve_output_path("debug_ccd_1.ply"), V1, F, E);
 		}
 
-		double max_step;
-		if (use_cached_candidates_ && broad_phase_method_ != ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE)
-			max_step = candidates_.compute_collision_free_stepsize(
-				collision_mesh_, V0, V1, dmin_, ccd_tolerance_, ccd_max_iterations_);
-		else
-			max_step = ipc::compute_collision_free_stepsize(
+		if (broad_phase_method_ == ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE)
+			return ipc::compute_collision_free_stepsize(
 				collision_mesh_, V0, V1, broad_phase_method_, ccd_tolerance_, ccd_max_iterations_);
 
+		// use the cached candidates if they cover the motion, otherwise run the broad phase once
+		ipc::Candidates local_candidates;
+		const bool use_cached = use_cached_candidates_ || candidates_cover(V0, V1);
+		if (!use_cached)
+			local_candidates.build(collision_mesh_, V0, V1, /*inflation_radius=*/dmin_ / 2, broad_phase_method_);
+		const ipc::Candidates &candidates = use_cached ? candidates_ : local_candidates;
+
+		double max_step = chunked_collision_free_stepsize(
+			candidates, collision_mesh_, V0, V1, dmin_, ccd_tolerance_, ccd_max_iterations_);
+
 		if (save_ccd_debug_meshes && ipc::has_intersections(collision_mesh_, (V1 - V0) * max_step + V0, broad_phase_method_))
 		{
 			log_and_throw_error("Taking max_step results in intersections (max_step={})", max_step);
 		}
 
 #ifndef NDEBUG
-		// This will check for static intersections as a failsafe. Not needed if we use our conservative CCD.
+		// Failsafe: V0 is intersection free, so V_toi is if the motion to it is collision free.
+		// Not needed if we use our conservative CCD. Reuses the candidates, no new broad phase.
 		Eigen::MatrixXd V_toi = (V1 - V0) * max_step + V0;
 
-		while (ipc::has_intersections(collision_mesh_, V_toi, broad_phase_method_))
+		while (!candidates.is_step_collision_free(collision_mesh_, V0, V_toi, dmin_, ccd_tolerance_, ccd_max_iterations_))
 		{
 			logger().error("Taking max_step results in intersections (max_step={:g})", max_step);
 			max_step /= 2.0;
@@ -262,22 +281,101 @@ namespace polyfem::solver
 		return max_step;
 	}
 
-	void ContactForm::line_search_begin(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1)
+	double ContactForm::chunked_collision_free_stepsize(
+		const ipc::Candidates &candidates,
+		const ipc::CollisionMesh &mesh,
+		const Eigen::MatrixXd &V0,
+		const Eigen::MatrixXd &V1,
+		const double min_distance,
+		const double tolerance,
+		const long max_iterations)
+	{
+		const Eigen::MatrixXi &E = mesh.edges();
+		const Eigen::MatrixXi &F = mesh.faces();
+		const Eigen::VectorXd displacement = (V1 - V0).rowwise().norm();
+
+		std::atomic<double> earliest_toi(1.0);
+		utils::maybe_parallel_for(candidates.size(), [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+			{
+				const double tmax = earliest_toi.load(std::memory_order_relaxed);
+				const ipc::ContinuousCollisionCandidate &candidate = candidates[i];
+
+				// the closest points approach each other by at most the displacement of both primitives
+				const std::array<long, 4> vis = candidate.vertex_ids(E, F);
+				double max_displacement = 0;
+				for (const long vi : vis)
+					if (vi >= 0)
+						max_displacement = std::max(max_displacement, displacement[vi]);
+
+				const ipc::VectorMax12d x0 = candidate.dof(V0, E, F);
+				const double d0 = std::sqrt(candidate.compute_distance(x0)); // compute_distance is squared
+				if (d0 - min_distance >= 2 * max_displacement * tmax)
+					continue;
+
+				double toi;
+				if (!candidate.ccd(x0, candidate.dof(V1, E, F), toi, min_distance, tmax, tolerance, max_iterations))
+					continue;
+
+				double current = earliest_toi.load(std::memory_order_relaxed);
+				while (toi < current && !earliest_toi.compare_exchange_weak(current, toi, std::memory_order_relaxed))
+					;
+			}
+		});
+
+		return earliest_toi.load();
+	}
+
+	bool ContactForm::candidates_cover(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const
+	{
+		if (candidates_margin_ < 0 || V0.rows() != candidates_min_.rows() || V0.cols() != candidates_min_.cols())
+			return false;
+
+		// every primitive box of the new motion is then inside its cached box inflated by the margin
+		const auto lower = candidates_min_.array() - candidates_margin_;
+		const auto upper = candidates_max_.array() + candidates_margin_;
+		return (V0.array() >= lower).all() && (V0.array() <= upper).all()
+			   && (V1.array() >= lower).all() && (V1.array() <= upper).all();
+	}
+
+	void ContactForm::build_candidates(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1)
 	{
+		// leave room for the next (usually shorter) Newton steps; the margin inflates every primitive so it follows
+		// the mean vertex motion, not the fastest vertex, a vertex moving past it triggers a rebuild (see candidates_cover)
+		const double margin = V0.rows() > 0 ? std::max(dhat_, (V1 - V0).rowwise().norm().mean()) : dhat_;
+
 		candidates_.build(
-			collision_mesh_,
-			compute_displaced_surface(x0),
-			compute_displaced_surface(x1),
-			/*inflation_radius=*/dhat_ / 2,
+			collision_mesh_, V0, V1,
+			/*inflation_radius=*/(dhat_ + dmin_) / 2 + margin,
 			broad_phase_method_);
 
+		candidates_min_ = V0.cwiseMin(V1);
+		candidates_max_ = V0.cwiseMax(V1);
+		candidates_margin_ = margin;
+		++n_candidates_builds_;
+	}
+
+	void ContactForm::line_search_begin(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1)
+	{
+		const Eigen::MatrixXd V0 = compute_displaced_surface(x0);
+		const Eigen::MatrixXd V1 = compute_displaced_surface(x1);
+
+		if (candidates_cover(V0, V1))
+			++n_candidates_reuses_;
+		else
+			build_candidates(V0, V1);
+
 		use_cached_candidates_ = true;
 	}
 
 	void ContactForm::line_search_end()
 	{
-		candidates_.clear();
+		// the candidates are kept, they are reused as long as they cover the motion
 		use_cached_candidates_ = false;
+
+		logger().trace(
+			"Contact candidates: {} broad phase builds, {} reuses",
+			n_candidates_builds_, n_candidates_reuses_);
 	}
 
 	void ContactForm::post_step(const polysolve::nonlinear::PostStepData &data)
@@ -329,7 +427,7 @@ namespace polyfem::solver
 		}
 
 		bool is_valid;
-		if (use_cached_candidates_)
+		if (use_cached_candidates_ || candidates_cover(displaced0, displaced1))
 			is_valid = candidates_.is_step_collision_free(
 				collision_mesh_, displaced0, displaced1, dmin_,
 				ccd_tolerance_, ccd_max_iterations_);
@@ -44,6 +44,7 @@ namespace polyfem::solver
 		/// @param broad_phase_method Broad phase method to use for distance and CCD evaluations
 		/// @param ccd_tolerance Continuous collision detection tolerance
 		/// @param ccd_max_iterations Continuous collision detection maximum iterations
+		/// @param dmin Minimum distance between elements kept by the step size
 		ContactForm(const ipc::CollisionMesh &collision_mesh,
 					const double dhat,
 					const double avg_mass,
@@ -53,7 +54,8 @@ namespace polyfem::solver
 					const bool enable_shape_derivatives,
 					const ipc::BroadPhaseMethod broad_phase_method,
 					const double ccd_tolerance,
-					const int ccd_max_iterations);
+					const int ccd_max_iterations,
+					const double dmin = 0);
 		virtual ~ContactForm() = default;
 
 		std::string name() const override { return "contact"; }
@@ -85,6 +87,13 @@ namespace polyfem::solver
 		/// @param hessian Output Hessian of the value wrt x
 		virtual void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override;
 
+		/// @brief Compute the product of the second derivative wrt x with v
+		/// @note Only the barrier Hessian of the surface is assembled, it is never expanded to the full dofs
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply the Hessian with
+		/// @param[out] Hv Output product of the Hessian of the value wrt x with v
+		virtual void hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const override;
+
 	public:
 		/// @brief Update time-dependent fields
 		/// @param t Current time
@@ -143,13 +152,49 @@ namespace polyfem::solver
 
 		double dhat() const { return dhat_; }
 		const ipc::Collisions &collision_set() const { return collision_set_; }
+		/// @brief Is the cached collision set the one of the given displaced surface
+		bool is_collision_set_current(const Eigen::MatrixXd &displaced_surface) const
+		{
+			return collision_set_surface_.size() == displaced_surface.size() && collision_set_surface_ == displaced_surface;
+		}
 		const ipc::BarrierPotential &barrier_potential() const { return barrier_potential_; }
 
+		/// @brief Earliest time of impact over the candidates, computed in parallel chunks sharing the current minimum
+		/// @note Each candidate is narrow-phased only up to the current minimum, and skipped if the distance
+		/// bound shows its primitives cannot get within min_distance before it.
+		/// @param candidates Broad phase candidates of the motion V0 → V1
+		/// @param mesh Collision mesh
+		/// @param V0 Surface vertex positions at the start of the motion
+		/// @param V1 Surface vertex positions at the end of the motion
+		/// @param min_distance Minimum distance allowed between primitives
+		/// @param tolerance CCD tolerance
+		/// @param max_iterations CCD maximum iterations
+		/// @return Largest collision free step size in [0, 1]
+		static double chunked_collision_free_stepsize(
+			const ipc::Candidates &candidates,
+			const ipc::CollisionMesh &mesh,
+			const Eigen::MatrixXd &V0,
+			const Eigen::MatrixXd &V1,
+			const double min_distance,
+			const double tolerance,
+			const long max_iterations);
+
 	protected:
 		/// @brief Update the cached candidate set for the current solution
 		/// @param displaced_surface Vertex positions displaced by the current solution
 		void update_collision_set(const Eigen::MatrixXd &displaced_surface);
 
+		/// @brief Check if the cached candidates contain every pair the broad phase would find for the motion V0 → V1
+		/// @note Holds if every vertex stays within the margin of the box it swept when the candidates were built
+		/// @param V0 Surface vertex positions at the start of the motion
+		/// @param V1 Surface vertex positions at the end of the motion
+		bool candidates_cover(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const;
+
+		/// @brief Rebuild the cached candidates for the motion V0 → V1, inflated by a margin so they can be reused for nearby motions
+		/// @param V0 Surface vertex positions at the start of the motion
+		/// @param V1 Surface vertex positions at the end of the motion
+		void build_candidates(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1);
+
 		/// @brief Collision mesh
 		const ipc::CollisionMesh &collision_mesh_;
 
@@ -157,7 +202,7 @@ namespace polyfem::solver
 		const double dhat_;
 
 		/// @brief Minimum distance between elements
-		const double dmin_ = 0;
+		const double dmin_;
 
 		/// @brief If true, use an adaptive barrier stiffness
 		const bool use_adaptive_barrier_stiffness_;
@@ -189,8 +234,16 @@ namespace polyfem::solver
 		bool use_cached_candidates_ = false;
 		/// @brief Cached constraint set for the current solution
 		ipc::Collisions collision_set_;
-		/// @brief Cached candidate set for the current solution
+		/// @brief Displaced surface the cached constraint set was built for
+		Eigen::MatrixXd collision_set_surface_;
+		/// @brief Cached candidate set, kept across line searches while the motion stays within the margin
 		ipc::Candidates candidates_;
+		/// @brief Per vertex box swept when the candidates were built
+		Eigen::MatrixXd candidates_min_, candidates_max_;
+		/// @brief Extra inflation of the cached candidates (negative if there are no cached candidates)
+		double candidates_margin_ = -1;
+		/// @brief Number of broad phase builds and reuses, for logging
+		int n_candidates_builds_ = 0, n_candidates_reuses_ = 0;
 
 		const ipc::BarrierPotential barrier_potential_;
 	};
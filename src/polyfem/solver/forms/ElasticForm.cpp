@@ -261,6 +261,8 @@ namespace polyfem::solver
 		  dt_(dt),
 		  is_volume_(is_volume)
 	{
+		assembler_.update_material_cache(is_volume_, bases_, geom_bases_, ass_vals_cache_, t_);
+
 		if (assembler_.is_linear())
 			compute_cached_stiffness();
 		// mat_cache_ = std::make_unique<utils::DenseMatrixCache>();
@@ -309,12 +311,34 @@ namespace polyfem::solver
 
 	void ElasticForm::first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
 	{
+		if (cached_grad_x_.size() == x.size() && cached_grad_x_ == x)
+		{
+			gradv = cached_grad_;
+			return;
+		}
+
 		Eigen::MatrixXd grad;
 		assembler_.assemble_gradient(is_volume_, n_bases_, bases_, geom_bases_,
 									 ass_vals_cache_, t_, dt_, x, x_prev_, grad);
 		gradv = grad;
 	}
 
+	double ElasticForm::value_and_first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
+	{
+		if (cached_grad_x_.size() == x.size() && cached_grad_x_ == x)
+		{
+			gradv = cached_grad_;
+			return value_unweighted(x);
+		}
+
+		Eigen::MatrixXd grad;
+		const double val = assembler_.assemble_energy_gradient(
+			is_volume_, n_bases_, bases_, geom_bases_,
+			ass_vals_cache_, t_, dt_, x, x_prev_, grad);
+		gradv = grad;
+		return val;
+	}
+
 	void ElasticForm::second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const
 	{
 		POLYFEM_SCOPED_TIMER("elastic hessian");
@@ -335,8 +359,46 @@ namespace polyfem::solver
 		}
 	}
 
+	void ElasticForm::add_second_derivative_unweighted(const Eigen::VectorXd &x, const double weight, StiffnessMatrix &hessian) const
+	{
+		const StiffnessMatrix *stiffness = &cached_stiffness_;
+		if (!assembler_.is_linear())
+		{
+			POLYFEM_SCOPED_TIMER("elastic hessian");
+			// assembled in the form's own matrix, whose storage is reused across iterations
+			assembler_.assemble_hessian(
+				is_volume_, n_bases_, project_to_psd_, bases_,
+				geom_bases_, ass_vals_cache_, t_, dt_, x, x_prev_, *mat_cache_, hessian_);
+			stiffness = &hessian_;
+		}
+
+		assert(stiffness->rows() == x.size() && stiffness->cols() == x.size());
+		if (!utils::add_to_sparse_pattern(*stiffness, weight, hessian))
+			hessian += weight * *stiffness;
+	}
+
+	void ElasticForm::hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+	{
+		POLYFEM_SCOPED_TIMER("elastic hessian vector product");
+
+		assert(v.size() == x.size());
+
+		if (assembler_.is_linear())
+		{
+			assert(cached_stiffness_.rows() == x.size() && cached_stiffness_.cols() == x.size());
+			Hv = cached_stiffness_ * v;
+		}
+		else
+		{
+			assembler_.assemble_hessian_vector_product(
+				is_volume_, n_bases_, project_to_psd_, bases_,
+				geom_bases_, ass_vals_cache_, t_, dt_, x, x_prev_, v, Hv);
+		}
+	}
+
 	void ElasticForm::finish()
 	{
+		clear_cached_gradient();
 		for (auto &t : quadrature_hierarchy_)
 			t = Tree();
 	}
@@ -367,7 +429,10 @@ namespace polyfem::solver
 			auto& bs = bases_[invalidID];
 			auto& gbs = geom_bases_[invalidID];
 			if (quadrature_hierarchy_[invalidID].merge(subdivision_tree)) // if the tree is refined
+			{
 				update_quadrature(invalidID, dim, quadrature_hierarchy_[invalidID], quadrature_order_, bs, gbs, ass_vals_cache_);
+				clear_cached_gradient();
+			}
 
 			// verify that new quadrature points don't make x0 invalid
 			// {
@@ -397,7 +462,12 @@ namespace polyfem::solver
 	{
 		// check inversion on quadrature points
 		Eigen::VectorXd grad;
-		first_derivative(x1, grad);
+		first_derivative_unweighted(x1, grad);
+
+		// keep the gradient, the next gradient evaluation is at x1 if the step is accepted
+		cached_grad_x_ = x1;
+		cached_grad_ = grad;
+
 		if (grad.array().isNaN().any())
 			return false;
 
@@ -440,10 +510,10 @@ namespace polyfem::solver
 			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
 				LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
 
-				for (int e = start; e < end; ++e)
+				for (int k = start; k < end; ++k)
 				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+					const int e = ass_vals_cache_.ordered_element(k);
+					const assembler::ElementAssemblyValues &vals = ass_vals_cache_.get(e, is_volume_, bases_[e], geom_bases_[e], local_storage.vals);
 
 					const quadrature::Quadrature &quadrature = vals.quadrature;
 					local_storage.da = vals.det.array() * quadrature.weights.array();
@@ -482,10 +552,10 @@ namespace polyfem::solver
 			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
 				LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
 
-				for (int e = start; e < end; ++e)
+				for (int k = start; k < end; ++k)
 				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+					const int e = ass_vals_cache_.ordered_element(k);
+					const assembler::ElementAssemblyValues &vals = ass_vals_cache_.get(e, is_volume_, bases_[e], geom_bases_[e], local_storage.vals);
 
 					const quadrature::Quadrature &quadrature = vals.quadrature;
 					local_storage.da = vals.det.array() * quadrature.weights.array();
@@ -530,10 +600,10 @@ namespace polyfem::solver
 			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
 				LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
 
-				for (int e = start; e < end; ++e)
+				for (int i_el = start; i_el < end; ++i_el)
 				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+					const int e = ass_vals_cache_.ordered_element(i_el);
+					const assembler::ElementAssemblyValues &vals = ass_vals_cache_.get(e, is_volume_, bases_[e], geom_bases_[e], local_storage.vals);
 					assembler::ElementAssemblyValues gvals;
 					gvals.compute(e, is_volume_, vals.quadrature.points, geom_bases_[e], geom_bases_[e]);
 
@@ -595,10 +665,10 @@ namespace polyfem::solver
 			utils::maybe_parallel_for(n_elements, [&](int start, int end, int thread_id) {
 				LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
 
-				for (int e = start; e < end; ++e)
+				for (int k = start; k < end; ++k)
 				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+					const int e = ass_vals_cache_.ordered_element(k);
+					const assembler::ElementAssemblyValues &vals = ass_vals_cache_.get(e, is_volume_, bases_[e], geom_bases_[e], local_storage.vals);
 					assembler::ElementAssemblyValues gvals;
 					gvals.compute(e, is_volume_, vals.quadrature.points, geom_bases_[e], geom_bases_[e]);
 
@@ -51,11 +51,29 @@ namespace polyfem::solver
 		/// @param[out] gradv Output gradient of the value wrt x
 		virtual void first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const override;
 
+		/// @brief Compute the elastic potential and its first derivative in a single pass over the elements
+		/// @param[in] x Current solution
+		/// @param[out] gradv Output gradient of the value wrt x
+		/// @return Value of the elastic potential
+		double value_and_first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const override;
+
 		/// @brief Compute the second derivative of the value wrt x
 		/// @param[in] x Current solution
 		/// @param[out] hessian Output Hessian of the value wrt x
 		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override;
 
+		/// @brief Add the second derivative wrt x scaled by weight into hessian, the linear stiffness is added without copy
+		/// @param[in] x Current solution
+		/// @param[in] weight Scaling of the second derivative
+		/// @param[in,out] hessian Hessian receiving the contribution of the form
+		void add_second_derivative_unweighted(const Eigen::VectorXd &x, const double weight, StiffnessMatrix &hessian) const override;
+
+		/// @brief Compute the product of the second derivative wrt x with v, element by element
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply the Hessian with
+		/// @param[out] Hv Output product of the Hessian of the value wrt x with v
+		void hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const override;
+
 	public:
 		/// @brief Determine if a step from solution x0 to solution x1 is allowed
 		/// @param x0 Current solution
@@ -74,6 +92,8 @@ namespace polyfem::solver
 		{
 			t_ = t;
 			x_prev_ = x;
+			clear_cached_gradient();
+			assembler_.update_material_cache(is_volume_, bases_, geom_bases_, ass_vals_cache_, t_);
 		}
 
 		/// @brief Determine the maximum step size allowable between the current and next solution
@@ -119,12 +139,22 @@ namespace polyfem::solver
 
 		StiffnessMatrix cached_stiffness_;                      ///< Cached stiffness matrix for linear elasticity
 		mutable std::unique_ptr<utils::MatrixCache> mat_cache_; ///< Matrix cache (mutable because it is modified in second_derivative_unweighted)
+		mutable StiffnessMatrix hessian_;                        ///< Nonlinear Hessian added to the global matrix, kept to reuse its storage
 
 		/// @brief Compute the stiffness matrix (cached)
 		void compute_cached_stiffness();
 
 		Eigen::VectorXd x_prev_;
 
+		/// Gradient computed by is_step_valid, reused when the line search accepts the step
+		mutable Eigen::VectorXd cached_grad_x_;
+		mutable Eigen::VectorXd cached_grad_;
+		void clear_cached_gradient() const
+		{
+			cached_grad_x_.resize(0);
+			cached_grad_.resize(0);
+		}
+
 		mutable std::vector<utils::Tree> quadrature_hierarchy_;
 		int quadrature_order_;
 	};
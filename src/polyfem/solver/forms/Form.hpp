@@ -1,6 +1,7 @@
 #pragma once
 
 #include <polyfem/utils/Types.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
 #include <polysolve/nonlinear/PostStepData.hpp>
 
 #include <filesystem>
@@ -45,6 +46,18 @@ namespace polyfem::solver
 			gradv *= weight();
 		}
 
+		/// @brief Compute the value and the first derivative wrt x multiplied with the weigth
+		/// @note Forms implementing value_and_first_derivative_unweighted share a single pass over the elements.
+		/// @param[in] x Current solution
+		/// @param[out] gradv Output gradient of the value wrt x
+		/// @return Computed value
+		inline double value_and_first_derivative(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
+		{
+			const double val = value_and_first_derivative_unweighted(x, gradv);
+			gradv *= weight();
+			return weight() * val;
+		}
+
 		/// @brief Compute the second derivative of the value wrt x multiplied with the weigth
 		/// @note This is not marked const because ElasticForm needs to cache the matrix assembly.
 		/// @param[in] x Current solution
@@ -55,6 +68,26 @@ namespace polyfem::solver
 			hessian *= weight();
 		}
 
+		/// @brief Add the second derivative wrt x multiplied with the weigth into hessian
+		/// @note The values are added in place when the sparsity pattern of hessian already holds the form's entries.
+		/// @param[in] x Current solution
+		/// @param[in,out] hessian Hessian receiving the contribution of the form
+		inline void add_second_derivative(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const
+		{
+			add_second_derivative_unweighted(x, weight(), hessian);
+		}
+
+		/// @brief Compute the product of the second derivative wrt x multiplied with the weigth and a vector
+		/// @note Forms implementing hessian_vector_product_unweighted do not assemble the Hessian.
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply the Hessian with
+		/// @param[out] Hv Output product of the Hessian of the value wrt x with v
+		inline void hessian_vector_product(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+		{
+			hessian_vector_product_unweighted(x, v, Hv);
+			Hv *= weight();
+		}
+
 		/// @brief Determine if a step from solution x0 to solution x1 is allowed
 		/// @param x0 Current solution
 		/// @param x1 Proposed next solution
@@ -173,9 +206,45 @@ namespace polyfem::solver
 		/// @param[out] gradv Output gradient of the value wrt x
 		virtual void first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const = 0;
 
+		/// @brief Compute the value and the first derivative wrt x
+		/// @note The default evaluates them separately, forms override it to share the element loop.
+		/// @param[in] x Current solution
+		/// @param[out] gradv Output gradient of the value wrt x
+		/// @return Computed value
+		virtual double value_and_first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
+		{
+			first_derivative_unweighted(x, gradv);
+			return value_unweighted(x);
+		}
+
 		/// @brief Compute the second derivative of the value wrt x
 		/// @param[in] x Current solution
 		/// @param[out] hessian Output Hessian of the value wrt x
 		virtual void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const = 0;
+
+		/// @brief Add the second derivative wrt x scaled by weight into hessian
+		/// @note The default assembles the Hessian, forms holding a persistent matrix override it to skip the temporary.
+		/// @param[in] x Current solution
+		/// @param[in] weight Scaling of the second derivative
+		/// @param[in,out] hessian Hessian receiving the contribution of the form
+		virtual void add_second_derivative_unweighted(const Eigen::VectorXd &x, const double weight, StiffnessMatrix &hessian) const
+		{
+			StiffnessMatrix tmp;
+			second_derivative_unweighted(x, tmp);
+			if (!utils::add_to_sparse_pattern(tmp, weight, hessian))
+				hessian += weight * tmp;
+		}
+
+		/// @brief Compute the product of the second derivative wrt x with a vector
+		/// @note The default assembles the Hessian, forms override it to compute the product without the matrix.
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply the Hessian with
+		/// @param[out] Hv Output product of the Hessian of the value wrt x with v
+		virtual void hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+		{
+			StiffnessMatrix hessian;
+			second_derivative_unweighted(x, hessian);
+			Hv = hessian * v;
+		}
 	};
 } // namespace polyfem::solver
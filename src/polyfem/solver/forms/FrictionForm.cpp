@@ -128,6 +128,15 @@ namespace polyfem::solver
 	{
 		const Eigen::MatrixXd displaced_surface = compute_displaced_surface(x);
 
+		// The contact form usually holds the collisions of x already (e.g., after a solve)
+		if (contact_form_.is_collision_set_current(displaced_surface))
+		{
+			friction_collision_set_.build(
+				collision_mesh_, displaced_surface, contact_form_.collision_set(),
+				contact_form_.barrier_potential(), contact_form_.barrier_stiffness(), mu_);
+			return;
+		}
+
 		ipc::Collisions collision_set;
 		collision_set.set_use_convergent_formulation(contact_form_.use_convergent_formulation());
 		collision_set.set_are_shape_derivatives_enabled(contact_form_.enable_shape_derivatives());
@@ -36,12 +36,34 @@ namespace polyfem::solver
 		: mass_(mass), time_integrator_(time_integrator)
 	{
 		assert(mass.size() != 0);
+		update_lumped_mass();
+	}
+
+	void InertiaForm::update_lumped_mass()
+	{
+		bool is_diagonal = mass_.rows() == mass_.cols();
+		for (int k = 0; is_diagonal && k < mass_.outerSize(); ++k)
+			for (StiffnessMatrix::InnerIterator it(mass_, k); it; ++it)
+				if (it.row() != it.col() && it.value() != 0)
+				{
+					is_diagonal = false;
+					break;
+				}
+
+		if (is_diagonal)
+			lumped_mass_ = mass_.diagonal();
+		else
+			lumped_mass_.resize(0);
 	}
 
 	double InertiaForm::value_unweighted(const Eigen::VectorXd &x) const
 	{
-		const Eigen::VectorXd tmp = x - time_integrator_.x_tilde();
+		const Eigen::VectorXd &x_tilde = this->x_tilde(x);
 		// FIXME: DBC on x tilde
+		if (is_mass_lumped())
+			return 0.5 * (lumped_mass_.array() * (x - x_tilde).array().square()).sum();
+
+		const Eigen::VectorXd tmp = x - x_tilde;
 		const double prod = tmp.transpose() * mass_ * tmp;
 		const double energy = 0.5 * prod;
 		return energy;
@@ -49,7 +71,10 @@ namespace polyfem::solver
 
 	void InertiaForm::first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
 	{
-		gradv = mass_ * (x - time_integrator_.x_tilde());
+		if (is_mass_lumped())
+			gradv = lumped_mass_.cwiseProduct(x - x_tilde(x));
+		else
+			gradv = mass_ * (x - x_tilde(x));
 	}
 
 	void InertiaForm::second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const
@@ -57,6 +82,28 @@ namespace polyfem::solver
 		hessian = mass_;
 	}
 
+	void InertiaForm::add_second_derivative_unweighted(const Eigen::VectorXd &x, const double weight, StiffnessMatrix &hessian) const
+	{
+		// only the diagonal is touched, each entry is found by a binary search in its column
+		if (is_mass_lumped() && hessian.isCompressed() && hessian.rows() == lumped_mass_.size())
+		{
+			for (int i = 0; i < lumped_mass_.size(); ++i)
+				hessian.coeffRef(i, i) += weight * lumped_mass_(i);
+			return;
+		}
+
+		if (!utils::add_to_sparse_pattern(mass_, weight, hessian))
+			hessian += weight * mass_;
+	}
+
+	void InertiaForm::hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+	{
+		if (is_mass_lumped())
+			Hv = lumped_mass_.cwiseProduct(v);
+		else
+			Hv = mass_ * v;
+	}
+
 	void InertiaForm::force_shape_derivative(
 		bool is_volume,
 		const int n_geom_bases,
@@ -80,8 +127,7 @@ namespace polyfem::solver
 
 			for (int e = start; e < end; ++e)
 			{
-				assembler::ElementAssemblyValues &vals = local_storage.vals;
-				ass_vals_cache.compute(e, is_volume, bases[e], geom_bases[e], vals);
+				const assembler::ElementAssemblyValues &vals = ass_vals_cache.get(e, is_volume, bases[e], geom_bases[e], local_storage.vals);
 				assembler::ElementAssemblyValues gvals;
 				gvals.compute(e, is_volume, vals.quadrature.points, geom_bases[e], geom_bases[e]);
 
@@ -94,7 +140,7 @@ namespace polyfem::solver
 
 				for (int q = 0; q < local_storage.da.size(); ++q)
 				{
-					const double rho = assembler.density()(quadrature.points.row(q), vals.val.row(q), t, e);
+					const double rho = assembler.density()(vals, q, t);
 					const double value = rho * dot(p.row(q), vel.row(q)) * local_storage.da(q);
 					for (const auto &v : gvals.basis_values)
 					{
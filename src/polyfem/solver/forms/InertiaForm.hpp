@@ -33,6 +33,26 @@ namespace polyfem::solver
 
 		std::string name() const override { return "inertia"; }
 
+		/// @brief Initialize the form
+		/// @param x Current solution
+		void init(const Eigen::VectorXd &x) override
+		{
+			update_lumped_mass();
+			update_x_tilde();
+		}
+
+		/// @brief Update time-dependent fields
+		/// @param t Current time
+		/// @param x Current solution at time t
+		void update_quantities(const double t, const Eigen::VectorXd &x) override
+		{
+			update_lumped_mass();
+			update_x_tilde();
+		}
+
+		/// @brief Is the mass matrix diagonal (e.g., lumped), in which case the form is evaluated coefficient-wise
+		bool is_mass_lumped() const { return lumped_mass_.size() > 0; }
+
 		static void force_shape_derivative(
 			bool is_volume,
 			const int n_geom_bases,
@@ -61,9 +81,43 @@ namespace polyfem::solver
 		/// @param[out] hessian Output Hessian of the value wrt x
 		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override;
 
+		/// @brief Add the mass matrix scaled by weight into hessian
+		/// @param[in] x Current solution
+		/// @param[in] weight Scaling of the second derivative
+		/// @param[in,out] hessian Hessian receiving the contribution of the form
+		void add_second_derivative_unweighted(const Eigen::VectorXd &x, const double weight, StiffnessMatrix &hessian) const override;
+
+		/// @brief Compute the product of the second derivative wrt x with v, i.e., the mass matrix times v
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply the Hessian with
+		/// @param[out] Hv Output product of the Hessian of the value wrt x with v
+		void hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const override;
+
 	private:
-		// TODO mass might be time dependent
 		const StiffnessMatrix &mass_;                                    ///< Mass matrix
 		const time_integrator::ImplicitTimeIntegrator &time_integrator_; ///< Time integrator
+
+		Eigen::VectorXd lumped_mass_;      ///< Diagonal of the mass matrix if it is diagonal, empty otherwise
+		mutable Eigen::VectorXd x_tilde_; ///< Predicted solution of the time integrator, constant over a time step
+		mutable int x_tilde_revision_ = -1; ///< Revision of the time integrator x_tilde_ was computed from
+
+		/// @brief Detect if the mass matrix is diagonal and store its diagonal
+		/// @note The mass matrix is referenced, it is checked again on every init/update_quantities in case it changed
+		void update_lumped_mass();
+
+		/// @brief Cache the predicted solution of the time integrator
+		void update_x_tilde() const
+		{
+			x_tilde_ = time_integrator_.x_tilde();
+			x_tilde_revision_ = time_integrator_.revision();
+		}
+
+		/// @brief Cached predicted solution, recomputed if the time integrator changed since it was cached
+		const Eigen::VectorXd &x_tilde(const Eigen::VectorXd &x) const
+		{
+			if (x_tilde_revision_ != time_integrator_.revision() || x_tilde_.size() != x.size())
+				update_x_tilde();
+			return x_tilde_;
+		}
 	};
 } // namespace polyfem::solver
@@ -29,6 +29,11 @@ namespace polyfem::solver
 		hessian.setIdentity();
 	}
 
+	void LaggedRegForm::hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+	{
+		Hv = v;
+	}
+
 	void LaggedRegForm::init_lagging(const Eigen::VectorXd &x)
 	{
 		update_lagging(x, 0);
@@ -129,6 +129,15 @@ namespace polyfem::solver
         //     collision_mesh_.edges(), collision_mesh_.faces());
     }
 
+    void PeriodicContactForm::hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+    {
+        update_projection();
+
+        Eigen::VectorXd Hv_full;
+        ContactForm::hessian_vector_product_unweighted(single_to_tiled(x), proj.transpose() * v, Hv_full);
+        Hv = proj * Hv_full;
+    }
+
     void PeriodicContactForm::update_quantities(const double t, const Eigen::VectorXd &x) 
     {
         ContactForm::update_quantities(t, single_to_tiled(x));
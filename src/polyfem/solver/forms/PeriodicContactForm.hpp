@@ -56,6 +56,12 @@ namespace polyfem::solver
 		/// @param hessian Output Hessian of the value wrt x
 		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override;
 
+		/// @brief Compute the product of the second derivative wrt x with v
+		/// @param x Current solution
+		/// @param v Vector to multiply the Hessian with
+		/// @param Hv Output product of the Hessian of the value wrt x with v
+		void hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const override;
+
     public:
 		/// @brief Update time-dependent fields
 		/// @param t Current time
@@ -18,9 +18,13 @@ namespace polyfem::solver
 		virtual Eigen::VectorXd target(const Eigen::VectorXd &x) const { return Eigen::VectorXd{}; };
 
 		inline void set_initial_weight(const double k_al) { k_al_ = k_al; }
+		inline double penalty_weight() const { return k_al_; }
 
 		inline const std::vector<int> &constraint_nodes() const { return constraint_nodes_; }
 
+		inline const Eigen::VectorXd &lagrangian_multipliers() const { return lagr_mults_; }
+		inline void set_lagrangian_multipliers(const Eigen::VectorXd &lagr_mults) { lagr_mults_ = lagr_mults; }
+
 	protected:
 		Eigen::VectorXd lagr_mults_;              ///< vector of lagrange multipliers
 		double k_al_;                             ///< penalty parameter
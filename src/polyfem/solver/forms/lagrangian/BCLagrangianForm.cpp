@@ -139,6 +139,11 @@ namespace polyfem::solver
 		hessian = k_al_ * masked_lumped_mass_;
 	}
 
+	void BCLagrangianForm::hessian_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &Hv) const
+	{
+		Hv = k_al_ * (masked_lumped_mass_ * v);
+	}
+
 	void BCLagrangianForm::update_quantities(const double t, const Eigen::VectorXd &)
 	{
 		if (is_time_dependent_)
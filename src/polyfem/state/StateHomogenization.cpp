@@ -321,7 +321,7 @@ namespace polyfem
 
 			// save restart file
 			save_restart_json(t0, dt, t);
-			// stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, sol);
+			// stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, iterations, sol);
 		}
 	}
 
@@ -222,6 +222,16 @@ namespace polyfem
 		const unsigned int thread_in = this->args["solver"]["max_threads"];
 		set_max_threads(thread_in);
 
+		out_geom.output_queue = nullptr; // flushes the previous writes
+		const int async_writers = this->args["output"]["advanced"]["async_writers"];
+		if (async_writers > 0)
+		{
+			// the HDF5 library is not thread safe
+			const bool use_hdf5 = this->args["output"]["paraview"]["options"]["use_hdf5"];
+			out_geom.output_queue = std::make_shared<io::OutputQueue>(
+				use_hdf5 ? 1 : async_writers, this->args["output"]["advanced"]["async_queue_size"]);
+		}
+
 		has_dhat = args_in["contact"].contains("dhat");
 
 		init_time();
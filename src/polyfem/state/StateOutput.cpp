@@ -1,5 +1,8 @@
 #include <polyfem/State.hpp>
 
+#include <polyfem/solver/forms/ContactForm.hpp>
+#include <polyfem/solver/forms/lagrangian/AugmentedLagrangianForm.hpp>
+#include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
 #include <polyfem/utils/Timer.hpp>
 
@@ -263,4 +266,52 @@ namespace polyfem
 		std::ofstream file(resolve_output_path(fmt::format(restart_json_path, t)));
 		file << restart_json;
 	}
+
+	void State::wait_for_hdf5_writes() const
+	{
+		if (args["output"]["paraview"]["options"]["use_hdf5"])
+			out_geom.flush();
+	}
+
+	void State::save_state(const time_integrator::ImplicitTimeIntegrator &integrator, const int t)
+	{
+		const std::string state_path = resolve_output_path(fmt::format(args["output"]["data"]["state"], t));
+		if (state_path.empty())
+			return;
+
+		if (!io::Checkpoint::has_checkpoint_extension(state_path))
+		{
+			wait_for_hdf5_writes();
+			integrator.save_state(state_path);
+			return;
+		}
+
+		POLYFEM_SCOPED_TIMER("Save checkpoint");
+
+		io::Checkpoint checkpoint;
+		integrator.save_state(checkpoint);
+		for (int i = 0; i < solve_data.al_form.size(); ++i)
+			checkpoint.set(fmt::format("al_multipliers/{}", i), Eigen::MatrixXd(solve_data.al_form[i]->lagrangian_multipliers()));
+
+		// every full_interval checkpoints, write a full one so that the chain of delta checkpoints stays short
+		const int full_interval = args["output"]["data"]["advanced"]["checkpoint_full_interval"];
+		if (last_checkpoint_path.empty() || last_checkpoint_path == state_path || n_delta_checkpoints + 1 >= full_interval)
+		{
+			checkpoint.save(state_path);
+			n_delta_checkpoints = 0;
+		}
+		else
+		{
+			checkpoint.save(state_path, &last_checkpoint, last_checkpoint_path);
+			++n_delta_checkpoints;
+		}
+		logger().debug("Saved checkpoint {} ({} bytes of data)", state_path, checkpoint.saved_bytes());
+
+		// only kept in memory if it can be the base of a delta checkpoint
+		if (full_interval > 1)
+		{
+			last_checkpoint = std::move(checkpoint);
+			last_checkpoint_path = state_path;
+		}
+	}
 } // namespace polyfem
@@ -1,5 +1,6 @@
 #include <polyfem/State.hpp>
 
+#include <polyfem/io/Checkpoint.hpp>
 #include <polyfem/io/MatrixIO.hpp>
 #include <polyfem/utils/Timer.hpp>
 
@@ -49,7 +50,17 @@ namespace polyfem
 			if (state_path.empty())
 				return false;
 
-			if (!read_matrix(state_path, x_name, x))
+			if (io::Checkpoint::is_checkpoint(state_path))
+			{
+				io::Checkpoint checkpoint;
+				checkpoint.load(state_path);
+				if (!checkpoint.get_columns(x_name, x))
+				{
+					logger().debug("Unable to read initial {} from checkpoint ({})", x_name, state_path);
+					return false;
+				}
+			}
+			else if (!read_matrix(state_path, x_name, x))
 			{
 				logger().debug("Unable to read initial {} from file ({})", x_name, state_path);
 				return false;
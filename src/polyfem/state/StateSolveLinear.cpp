@@ -342,9 +342,7 @@ namespace polyfem
 
 			save_timestep(time, t, t0, dt, sol, pressure);
 
-			const std::string &state_path = resolve_output_path(fmt::format(args["output"]["data"]["state"], t));
-			if (!state_path.empty())
-				time_integrator->save_state(state_path);
+			save_state(*time_integrator, t);
 
 			logger().info("{}/{}  t={}", t, time_steps, time);
 		}
@@ -14,7 +14,11 @@
 
 #include <polyfem/solver/NLProblem.hpp>
 #include <polyfem/solver/ALSolver.hpp>
+#include <polyfem/solver/MatrixFreeNewton.hpp>
+#include <polyfem/solver/ModifiedNewton.hpp>
 #include <polyfem/solver/SolveData.hpp>
+#include <polyfem/time_integrator/CentralDifference.hpp>
+#include <polyfem/io/Checkpoint.hpp>
 #include <polyfem/io/MshWriter.hpp>
 #include <polyfem/io/OBJWriter.hpp>
 #include <polyfem/io/OutData.hpp>
@@ -35,7 +39,14 @@ namespace polyfem
 
 	std::shared_ptr<polysolve::nonlinear::Solver> State::make_nl_solver(bool for_al) const
 	{
-		return polysolve::nonlinear::Solver::create(for_al ? args["solver"]["augmented_lagrangian"]["nonlinear"] : args["solver"]["nonlinear"], args["solver"]["linear"], units.characteristic_length(), logger());
+		const json &solver_params = for_al ? args["solver"]["augmented_lagrangian"]["nonlinear"] : args["solver"]["nonlinear"];
+		const json &matrix_free = args["solver"]["advanced"]["matrix_free"];
+		if (matrix_free["enabled"])
+			return MatrixFreeNewton::create_solver(solver_params, matrix_free, units.characteristic_length(), logger());
+		// the stock Newton strategies refactorize at every iteration, even if the Hessian is reused
+		if (args["solver"]["advanced"]["reuse_hessian"]["enabled"])
+			return ModifiedNewton::create_solver(solver_params, args["solver"]["linear"], units.characteristic_length(), logger());
+		return polysolve::nonlinear::Solver::create(solver_params, args["solver"]["linear"], units.characteristic_length(), logger());
 	}
 
 	void State::solve_transient_tensor_nonlinear(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol)
@@ -57,13 +68,30 @@ namespace polyfem
 		if (optimization_enabled != solver::CacheLevel::None)
 			cache_transient_adjoint_quantities(0, sol, Eigen::MatrixXd::Zero(mesh->dimension(), mesh->dimension()));
 
+		// Nonlinear iterations of the solves logged after start
+		// (counted solve by solve because remeshing resets stats.solver_info)
+		const auto solver_iterations = [this](const size_t start) {
+			int iterations = 0;
+			for (size_t i = start; i < stats.solver_info.size(); ++i)
+			{
+				const json &info = stats.solver_info[i]["info"];
+				if (info.is_object())
+					iterations += info.value("iterations", 0);
+			}
+			return iterations;
+		};
+
 		for (int t = 1; t <= time_steps; ++t)
 		{
 			double forward_solve_time = 0, remeshing_time = 0, global_relaxation_time = 0;
+			int iterations = 0;
 
 			{
 				POLYFEM_SCOPED_TIMER(forward_solve_time);
+				predict_time_step(sol);
+				const size_t solver_info_start = stats.solver_info.size();
 				solve_tensor_nonlinear(sol, t);
+				iterations += solver_iterations(solver_info_start);
 			}
 
 			if (remesh_enabled)
@@ -87,7 +115,9 @@ namespace polyfem
 				if (remesh_success)
 				{
 					POLYFEM_SCOPED_TIMER(global_relaxation_time);
+					const size_t solver_info_start = stats.solver_info.size();
 					solve_tensor_nonlinear(sol, t, false); // solve the scene again after remeshing
+					iterations += solver_iterations(solver_info_start);
 				}
 			}
 
@@ -125,21 +155,171 @@ namespace polyfem
 					V, F, mesh->get_body_ids(), mesh->is_volume(), /*binary=*/true);
 			}
 
-			const std::string &state_path = resolve_output_path(fmt::format(args["output"]["data"]["state"], t));
-			if (!state_path.empty())
-				solve_data.time_integrator->save_state(state_path);
+			save_state(*solve_data.time_integrator, t);
+
+			// save restart file
+			save_restart_json(t0, dt, t);
+
+			stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, iterations, sol);
+		}
+	}
+
+	bool State::is_explicit_time_integration() const
+	{
+		if (!problem->is_time_dependent())
+			return false;
+		return ImplicitTimeIntegrator::construct_time_integrator(args["time"]["integrator"])->is_explicit();
+	}
+
+	void State::solve_transient_tensor_explicit(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol)
+	{
+		if (optimization_enabled != solver::CacheLevel::None)
+			log_and_throw_error("Explicit time integration does not support adjoint computations!");
+		if (args["space"]["remesh"]["enabled"])
+			log_and_throw_error("Explicit time integration does not support remeshing!");
+		if (problem->is_scalar())
+			log_and_throw_error("Explicit time integration only supports tensor problems!");
+		if (mixed_assembler != nullptr)
+			log_and_throw_error("Explicit time integration does not support mixed formulations!");
+		// the step is not clipped by CCD and the critical time step ignores the barrier stiffness
+		if (is_contact_enabled())
+			log_and_throw_error("Explicit time integration does not support contact!");
+
+		init_nonlinear_tensor_solve(sol, t0 + dt);
+
+		const std::shared_ptr<CentralDifference> integrator = std::dynamic_pointer_cast<CentralDifference>(solve_data.time_integrator);
+		assert(integrator != nullptr);
+		NLProblem &nl_problem = *(solve_data.nl_problem);
+		nl_problem.use_reduced_size();
+
+		if (solve_data.friction_form != nullptr)
+			logger().warn("Friction is ignored by the explicit time integrator");
+
+		// Only the forces are needed, the inertia is handled by the integrator
+		const std::array<std::shared_ptr<Form>, 4> force_forms{
+			{solve_data.elastic_form, solve_data.body_form, solve_data.pressure_form, solve_data.damping_form}};
+
+		// Lumped mass (HRZ, row sums are not positive for higher order bases)
+		const Eigen::VectorXd lumped_mass = CentralDifference::lumped_mass(mass, mesh->dimension());
+		const Eigen::VectorXd reduced_mass = nl_problem.full_to_reduced_grad(lumped_mass);
+
+		// a = M⁻¹f(x) on the free dofs, the constrained dofs follow the boundary conditions
+		const auto compute_acceleration = [&](const Eigen::VectorXd &x) {
+			Eigen::VectorXd force = Eigen::VectorXd::Zero(x.size());
+			for (const std::shared_ptr<Form> &form : force_forms)
+			{
+				if (form == nullptr || !form->enabled())
+					continue;
+
+				form->solution_changed(x);
+				Eigen::VectorXd grad;
+				form->first_derivative(x, grad);
+				force -= grad;
+			}
+
+			const Eigen::VectorXd reduced_force = nl_problem.full_to_reduced_grad(force);
+			const Eigen::VectorXd reduced_acc = reduced_force.cwiseQuotient(reduced_mass);
+
+			Eigen::VectorXd acc = nl_problem.reduced_to_full(reduced_acc);
+			const Eigen::VectorXd bc_acc = integrator->compute_acceleration(integrator->compute_velocity(x));
+			for (int i = 0; i < acc.size(); ++i)
+			{
+				if (nl_problem.is_constrained(i))
+					acc[i] = bc_acc[i];
+			}
+			return acc;
+		};
+
+		// Split the time step if it violates the stability condition, the stiffness changes with the
+		// deformation so the critical time step is re-estimated at the beginning of every time step
+		const auto estimate_substeps = [&](const Eigen::VectorXd &x) {
+			POLYFEM_SCOPED_TIMER("Estimate critical time step");
+			StiffnessMatrix stiffness;
+			solve_data.elastic_form->second_derivative(x, stiffness);
+			const double critical_dt = CentralDifference::critical_time_step(lumped_mass, stiffness);
+			const int n = integrator->n_substeps(dt, critical_dt);
+			logger().debug("Central difference critical dt={:g}, using {} sub-step(s) per time step", critical_dt, n);
+			return n;
+		};
+
+		// Start from the equilibrium acceleration
+		int n_substeps = estimate_substeps(sol);
+		{
+			const Eigen::VectorXd v0 = integrator->v_prev();
+			Eigen::VectorXd a0 = compute_acceleration(sol);
+			for (int i = 0; i < a0.size(); ++i)
+			{
+				if (nl_problem.is_constrained(i))
+					a0[i] = integrator->a_prev()[i];
+			}
+			integrator->init(sol, v0, a0, dt / n_substeps);
+			solve_data.update_dt();
+		}
+
+		EnergyCSVWriter energy_csv(resolve_output_path("energy.csv"), solve_data);
+
+		energy_csv.write(0, sol);
+		save_timestep(t0, 0, t0, dt, sol, Eigen::MatrixXd()); // no pressure
+
+		for (int t = 1; t <= time_steps; ++t)
+		{
+			{
+				POLYFEM_SCOPED_TIMER("Explicit step");
+
+				if (t > 1)
+				{
+					const int prev_substeps = n_substeps;
+					n_substeps = estimate_substeps(integrator->x_prev());
+					if (n_substeps != prev_substeps)
+					{
+						integrator->init(integrator->x_prev(), integrator->v_prev(), integrator->a_prev(), dt / n_substeps);
+						solve_data.update_dt();
+					}
+				}
+				const double sub_dt = dt / n_substeps;
+
+				// the material parameters are updated once per time step, the other forms (boundary conditions, loads) every sub-step
+				solve_data.elastic_form->update_quantities(t0 + t * dt, integrator->x_prev());
+				for (int s = 1; s <= n_substeps; ++s)
+				{
+					const double ts = t0 + (t - 1) * dt + s * sub_dt;
+					for (const std::shared_ptr<Form> &form : nl_problem.forms())
+					{
+						if (form != solve_data.elastic_form)
+							form->update_quantities(ts, integrator->x_prev());
+					}
+					nl_problem.clear_evaluation_cache();
+
+					// Predict and impose the boundary conditions at ts
+					Eigen::VectorXd x = integrator->x_tilde();
+					x = nl_problem.reduced_to_full(nl_problem.full_to_reduced(x));
+
+					integrator->update_quantities(x, compute_acceleration(x));
+				}
+			}
+
+			sol = integrator->x_prev();
+			if (!sol.allFinite())
+				log_and_throw_error("Explicit time integration diverged at t={}; reduce the time step", t0 + dt * t);
+
+			energy_csv.write(t, sol);
+			save_timestep(t0 + dt * t, t, t0, dt, sol, Eigen::MatrixXd()); // no pressure
+
+			solve_data.update_barrier_stiffness(sol);
+
+			logger().info("{}/{}  t={}", t, time_steps, t0 + dt * t);
+
+			save_state(*solve_data.time_integrator, t);
 
 			// save restart file
 			save_restart_json(t0, dt, t);
-			if (remesh_enabled)
-				stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, sol);
 		}
 	}
 
 	void State::init_nonlinear_tensor_solve(Eigen::MatrixXd &sol, const double t, const bool init_time_integrator)
 	{
 		assert(sol.cols() == 1);
-		assert(!assembler->is_linear() || is_contact_enabled()); // non-linear
+		assert(!assembler->is_linear() || is_contact_enabled() || is_explicit_time_integration()); // non-linear
 		assert(!problem->is_scalar());                           // tensor
 		assert(mixed_assembler == nullptr);
 
@@ -269,13 +449,85 @@ namespace polyfem
 		const int ndof = n_bases * mesh->dimension();
 		solve_data.nl_problem = std::make_shared<NLProblem>(
 			ndof, periodic_bc, t, forms, solve_data.al_form);
+		{
+			const json &reuse_hessian = args["solver"]["advanced"]["reuse_hessian"];
+			solve_data.nl_problem->set_hessian_reuse(
+				reuse_hessian["enabled"], reuse_hessian["max_rate"],
+				reuse_hessian["max_reuses"], reuse_hessian["across_solves"]);
+		}
 		solve_data.nl_problem->init(sol);
 		solve_data.nl_problem->update_quantities(t, sol);
+
+		// --------------------------------------------------------------------
+		// Restore the solver state from the input checkpoint
+
+		const std::string state_path = resolve_input_path(args["input"]["data"]["state"]);
+		if (init_time_integrator && !state_path.empty() && io::Checkpoint::is_checkpoint(state_path))
+		{
+			io::Checkpoint checkpoint;
+			checkpoint.load(state_path);
+
+			// the multipliers are per dof, they cannot be restored if the nodes are reordered
+			for (int i = 0; i < solve_data.al_form.size() && !args["input"]["data"]["reorder"].get<bool>(); ++i)
+			{
+				Eigen::MatrixXd lagr_mults;
+				if (checkpoint.get(fmt::format("al_multipliers/{}", i), lagr_mults)
+					&& lagr_mults.size() == solve_data.al_form[i]->lagrangian_multipliers().size())
+					solve_data.al_form[i]->set_lagrangian_multipliers(lagr_mults);
+			}
+		}
 		// --------------------------------------------------------------------
 
 		stats.solver_info = json::array();
 	}
 
+	void State::predict_time_step(Eigen::MatrixXd &sol)
+	{
+		assert(solve_data.time_integrator != nullptr);
+		const ImplicitTimeIntegrator &time_integrator = *solve_data.time_integrator;
+
+		const std::string predictor = args["time"]["predictor"];
+		if (predictor == "previous")
+			return;
+
+		const double dt = time_integrator.dt();
+		Eigen::VectorXd prediction;
+		if (predictor == "linear")
+			prediction = time_integrator.x_prev() + dt * time_integrator.v_prev();
+		else if (predictor == "quadratic")
+			prediction = time_integrator.x_prev() + dt * (time_integrator.v_prev() + dt / 2 * time_integrator.a_prev());
+		else if (predictor == "x_tilde")
+			prediction = time_integrator.x_tilde();
+		else
+			log_and_throw_error("Unknown time step predictor ({})", predictor);
+
+		if (prediction.size() != sol.size() || !prediction.allFinite())
+			return;
+
+		// Do not extrapolate through contacts
+		double alpha = 1;
+		if (solve_data.contact_form != nullptr && solve_data.contact_form->enabled())
+		{
+			POLYFEM_SCOPED_TIMER("Clip predictor");
+			alpha = std::min(alpha, solve_data.contact_form->max_step_size(sol, prediction));
+		}
+
+		// Backtrack toward the previous solution until the elements are not inverted and the energy is finite
+		const std::shared_ptr<ElasticForm> &elastic_form = solve_data.elastic_form;
+		const Eigen::VectorXd x0 = sol;
+		for (int i = 0; alpha > 0 && i < 10; ++i, alpha /= 2)
+		{
+			const Eigen::VectorXd x = alpha >= 1 ? prediction : Eigen::VectorXd(x0 + alpha * (prediction - x0));
+			if (elastic_form != nullptr && (!elastic_form->is_step_valid(x0, x) || !std::isfinite(elastic_form->value(x))))
+				continue;
+
+			logger().debug("Using {} predictor (α={:g})", predictor, alpha);
+			sol = x;
+			return;
+		}
+		logger().debug("Rejected {} predictor, starting from the previous solution", predictor);
+	}
+
 	void State::solve_tensor_nonlinear(Eigen::MatrixXd &sol, const int t, const bool init_lagging)
 	{
 		assert(solve_data.nl_problem != nullptr);
@@ -320,6 +572,8 @@ namespace polyfem
 				 {"info", nl_solver->info()}});
 			if (al_weight > 0)
 				stats.solver_info.back()["weight"] = al_weight;
+			if (nl_problem.reuses_hessian())
+				stats.solver_info.back()["reused_assemblies"] = nl_problem.n_reused_assemblies();
 			save_subsolve(++subsolve_count, t, sol, Eigen::MatrixXd()); // no pressure
 		};
 
@@ -399,6 +653,8 @@ namespace polyfem
 					 {"t", t}, // TODO: null if static?
 					 {"lag_i", lag_i},
 					 {"info", nl_solver->info()}});
+				if (nl_problem.reuses_hessian())
+					stats.solver_info.back()["reused_assemblies"] = nl_problem.n_reused_assemblies();
 				save_subsolve(++subsolve_count, t, sol, Eigen::MatrixXd()); // no pressure
 			}
 		}
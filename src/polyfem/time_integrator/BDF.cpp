@@ -90,6 +90,7 @@ namespace polyfem::time_integrator
 		assert(x_prevs_.size() <= max_steps());
 		assert(x_prevs_.size() == v_prevs_.size());
 		assert(x_prevs_.size() == a_prevs_.size());
+		++revision_;
 	}
 
 	Eigen::VectorXd BDF::x_tilde() const
@@ -0,0 +1,120 @@
+#include "CentralDifference.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace polyfem::time_integrator
+{
+	void CentralDifference::set_parameters(const json &params)
+	{
+		cfl_ = params.value("cfl", cfl_);
+		max_substeps_ = params.value("max_substeps", max_substeps_);
+		assert(cfl_ > 0);
+		assert(max_substeps_ >= 1);
+	}
+
+	void CentralDifference::update_quantities(const Eigen::VectorXd &x)
+	{
+		update_quantities(x, a_prev());
+	}
+
+	void CentralDifference::update_quantities(const Eigen::VectorXd &x, const Eigen::VectorXd &a)
+	{
+		assert(x.size() == x_prev().size());
+		assert(a.size() == a_prev().size());
+
+		set_v_prev(v_prev() + dt() / 2 * (a_prev() + a));
+		set_a_prev(a);
+		set_x_prev(x);
+	}
+
+	Eigen::VectorXd CentralDifference::x_tilde() const
+	{
+		return x_prev() + dt() * (v_prev() + dt() / 2 * a_prev());
+	}
+
+	Eigen::VectorXd CentralDifference::compute_velocity(const Eigen::VectorXd &x) const
+	{
+		return 2 / dt() * (x - x_prev()) - v_prev();
+	}
+
+	Eigen::VectorXd CentralDifference::compute_acceleration(const Eigen::VectorXd &v) const
+	{
+		return 2 / dt() * (v - v_prev()) - a_prev();
+	}
+
+	double CentralDifference::dv_dx(const unsigned prev_ti) const
+	{
+		if (prev_ti == 0)
+			return 2 / dt();
+		return (prev_ti == 1 ? (-2 / dt()) : 0) - dv_dx(prev_ti - 1);
+	}
+
+	Eigen::VectorXd CentralDifference::lumped_mass(const StiffnessMatrix &mass, const int dim)
+	{
+		assert(mass.rows() == mass.cols());
+		assert(dim >= 1 && mass.rows() % dim == 0);
+
+		const Eigen::VectorXd diagonal = mass.diagonal();
+
+		Eigen::VectorXd total_mass = Eigen::VectorXd::Zero(dim);
+		for (int k = 0; k < mass.outerSize(); ++k)
+			for (StiffnessMatrix::InnerIterator it(mass, k); it; ++it)
+				total_mass[it.row() % dim] += it.value();
+
+		Eigen::VectorXd diagonal_mass = Eigen::VectorXd::Zero(dim);
+		for (int i = 0; i < diagonal.size(); ++i)
+			diagonal_mass[i % dim] += diagonal[i];
+
+		Eigen::VectorXd lumped(diagonal.size());
+		for (int i = 0; i < diagonal.size(); ++i)
+		{
+			const int c = i % dim;
+			lumped[i] = diagonal_mass[c] > 0 ? (diagonal[i] * total_mass[c] / diagonal_mass[c]) : 0;
+			if (!(lumped[i] > 0))
+				log_and_throw_error("Lumped mass of dof {} is not positive ({}), the explicit integrator needs a positive mass everywhere", i, lumped[i]);
+		}
+
+		return lumped;
+	}
+
+	double CentralDifference::critical_time_step(const Eigen::VectorXd &lumped_mass, const StiffnessMatrix &stiffness)
+	{
+		assert(stiffness.rows() == lumped_mass.size());
+		assert(stiffness.cols() == lumped_mass.size());
+
+		Eigen::VectorXd row_sums = Eigen::VectorXd::Zero(lumped_mass.size());
+		for (int k = 0; k < stiffness.outerSize(); ++k)
+			for (StiffnessMatrix::InnerIterator it(stiffness, k); it; ++it)
+				row_sums[it.row()] += std::abs(it.value());
+
+		double omega2 = 0;
+		for (int i = 0; i < lumped_mass.size(); ++i)
+		{
+			if (lumped_mass[i] > 0)
+				omega2 = std::max(omega2, row_sums[i] / lumped_mass[i]);
+		}
+
+		if (omega2 <= 0)
+			return std::numeric_limits<double>::infinity();
+		return 2 / std::sqrt(omega2);
+	}
+
+	int CentralDifference::n_substeps(const double dt, const double critical_dt) const
+	{
+		const double stable_dt = cfl() * critical_dt;
+		if (!std::isfinite(stable_dt) || stable_dt >= dt)
+			return 1;
+
+		const double n = std::ceil(dt / stable_dt);
+		if (n > max_substeps())
+		{
+			log_and_throw_error(
+				"Central difference needs {} sub-steps to be stable (dt={:g}, critical dt={:g}), but only {} are allowed; reduce the time step or increase max_substeps",
+				n, dt, critical_dt, max_substeps());
+		}
+		return int(n);
+	}
+} // namespace polyfem::time_integrator
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
+#include <polyfem/utils/Types.hpp>
+
+namespace polyfem::time_integrator
+{
+	/// Explicit central difference method (i.e., Newmark with \f$\beta=0\f$ and \f$\gamma=1/2\f$).
+	/// \f[
+	/// 	x^{t+1} = x^t + \Delta t v^t + \frac{\Delta t^2}{2} a^t\newline
+	/// 	a^{t+1} = M^{-1} f(x^{t+1})\newline
+	/// 	v^{t+1} = v^t + \frac{\Delta t}{2}(a^t + a^{t+1})
+	/// \f]
+	/// The mass matrix is lumped so no linear system has to be solved. Forces are
+	/// evaluated unscaled (i.e., the acceleration scaling is one).
+	/// @see https://en.wikipedia.org/wiki/Newmark-beta_method
+	class CentralDifference : public ImplicitTimeIntegrator
+	{
+	public:
+		CentralDifference() {}
+
+		/// @brief Set the `cfl` and `max_substeps` parameters from a json object.
+		/// @param params json containing `{"cfl": 0.9, "max_substeps": 100}`
+		void set_parameters(const json &params) override;
+
+		bool is_explicit() const override { return true; }
+
+		/// @brief Update the time integration quantities assuming \f$a^{t+1} = a^t\f$.
+		/// @param x new solution vector
+		void update_quantities(const Eigen::VectorXd &x) override;
+
+		/// @brief Update the time integration quantities with the acceleration computed from the forces at \f$x\f$.
+		/// @param x new solution vector
+		/// @param a acceleration at the new solution
+		void update_quantities(const Eigen::VectorXd &x, const Eigen::VectorXd &a);
+
+		/// @brief Compute the explicit prediction of the next solution.
+		/// \f[
+		/// 	\tilde{x} = x^t + \Delta t v^t + \frac{\Delta t^2}{2} a^t
+		/// \f]
+		/// @return value for \f$\tilde{x}\f$
+		Eigen::VectorXd x_tilde() const override;
+
+		/// @brief Compute the current velocity given the current solution (trapezoidal rule).
+		/// \f[
+		/// 	v = \frac{2}{\Delta t}(x - x^t) - v^t
+		/// \f]
+		/// @param x current solution vector
+		/// @return value for \f$v\f$
+		Eigen::VectorXd compute_velocity(const Eigen::VectorXd &x) const override;
+
+		/// @brief Compute the current acceleration given the current velocity.
+		/// \f[
+		/// 	a = \frac{2}{\Delta t}(v - v^t) - a^t
+		/// \f]
+		/// @param v current velocity
+		/// @return value for \f$a\f$
+		Eigen::VectorXd compute_acceleration(const Eigen::VectorXd &v) const override;
+
+		/// @brief Forces are not scaled by the explicit scheme.
+		double acceleration_scaling() const override { return 1; }
+
+		/// @brief Compute the derivative of the velocity with respect to the solution.
+		/// \f[
+		/// 	\frac{\partial v}{\partial x} = \frac{2}{\Delta t}
+		/// \f]
+		/// @param prev_ti index of the previous solution to use (0 -> current; 1 -> previous; 2 -> second previous; etc.)
+		double dv_dx(const unsigned prev_ti = 0) const override;
+
+		/// @brief Lump a consistent mass matrix by diagonal scaling (HRZ lumping).
+		/// The diagonal of the consistent mass is scaled so that each component keeps its total mass:
+		/// \f[
+		/// 	m_i = M_{ii} \frac{\sum_{jk} M_{jk}}{\sum_j M_{jj}}
+		/// \f]
+		/// where the sums run over the dofs of the same component as \f$i\f$. Unlike row sums, the
+		/// lumped masses stay positive for higher order bases.
+		/// @param mass consistent mass matrix
+		/// @param dim number of components per node (dofs are interleaved)
+		/// @return diagonal of the lumped mass matrix
+		/// @throws std::runtime_error if a lumped mass is not positive
+		static Eigen::VectorXd lumped_mass(const StiffnessMatrix &mass, const int dim);
+
+		/// @brief Estimate the critical time step of the explicit scheme.
+		/// This is the discrete counterpart of the CFL condition \f$\Delta t \leq h / c\f$: the largest
+		/// eigenvalue of \f$M^{-1}K\f$ is bounded by the Gershgorin circles of the lumped system, so the
+		/// element size, order, and wave speed are all accounted for.
+		/// \f[
+		/// 	\Delta t_{crit} = \frac{2}{\omega_{\max}},\quad \omega_{\max}^2 \leq \max_i \frac{1}{m_i}\sum_j |K_{ij}|
+		/// \f]
+		/// @param lumped_mass diagonal of the lumped mass matrix
+		/// @param stiffness stiffness matrix (i.e., Hessian of the elastic energy)
+		/// @return critical time step (infinity if the system has no stiffness)
+		static double critical_time_step(const Eigen::VectorXd &lumped_mass, const StiffnessMatrix &stiffness);
+
+		/// @brief Number of uniform sub-steps needed to integrate a step of size dt stably.
+		/// @param dt size of the time step to split
+		/// @param critical_dt critical time step from critical_time_step()
+		/// @return number of sub-steps, at least one
+		/// @throws std::runtime_error if more than max_substeps() sub-steps are needed
+		int n_substeps(const double dt, const double critical_dt) const;
+
+		/// @brief Safety factor applied to the critical time step.
+		double cfl() const { return cfl_; }
+		/// @brief Maximum number of sub-steps taken per time step.
+		int max_substeps() const { return max_substeps_; }
+
+	protected:
+		/// @brief Safety factor applied to the critical time step.
+		double cfl_ = 0.9;
+		/// @brief Maximum number of sub-steps taken per time step.
+		int max_substeps_ = 1000;
+	};
+} // namespace polyfem::time_integrator
@@ -3,7 +3,9 @@
 #include <polyfem/time_integrator/ImplicitEuler.hpp>
 #include <polyfem/time_integrator/ImplicitNewmark.hpp>
 #include <polyfem/time_integrator/BDF.hpp>
+#include <polyfem/time_integrator/CentralDifference.hpp>
 
+#include <polyfem/io/Checkpoint.hpp>
 #include <polyfem/io/MatrixIO.hpp>
 #include <polyfem/utils/StringUtils.hpp>
 #include <polyfem/utils/Logger.hpp>
@@ -39,6 +41,7 @@ namespace polyfem
 
 			assert(dt > 0);
 			dt_ = dt;
+			++revision_;
 		}
 
 		void ImplicitTimeIntegrator::save_state(const std::string &state_path) const
@@ -63,6 +66,27 @@ namespace polyfem
 			write_matrix(state_path, "a", tmp, /*replace=*/false);
 		}
 
+		void ImplicitTimeIntegrator::save_state(io::Checkpoint &checkpoint) const
+		{
+			const int ndof = x_prev().size();
+			const int prev_steps = x_prevs().size();
+
+			// stored column by column so that delta checkpoints share the history shifted by one step
+			Eigen::MatrixXd tmp(ndof, prev_steps);
+
+			for (int i = 0; i < prev_steps; ++i)
+				tmp.col(i) = x_prevs()[i];
+			checkpoint.set_columns("u", tmp);
+
+			for (int i = 0; i < prev_steps; ++i)
+				tmp.col(i) = v_prevs()[i];
+			checkpoint.set_columns("v", tmp);
+
+			for (int i = 0; i < prev_steps; ++i)
+				tmp.col(i) = a_prevs()[i];
+			checkpoint.set_columns("a", tmp);
+		}
+
 		std::shared_ptr<ImplicitTimeIntegrator> ImplicitTimeIntegrator::construct_time_integrator(const json &params)
 		{
 			const std::string type = params.is_object() ? params["type"] : params;
@@ -80,6 +104,10 @@ namespace polyfem
 			{
 				integrator = std::make_shared<BDF>(type == "BDF" ? 1 : std::stoi(type.substr(3)));
 			}
+			else if (type == "central_difference" || type == "CentralDifference")
+			{
+				integrator = std::make_shared<CentralDifference>();
+			}
 			else
 			{
 				logger().error("Unknown time integrator ({})", type);
@@ -98,6 +126,7 @@ namespace polyfem
 				std::string("ImplicitEuler"),
 				std::string("ImplicitNewmark"),
 				std::string("BDF"),
+				std::string("CentralDifference"),
 			};
 			return names;
 		}
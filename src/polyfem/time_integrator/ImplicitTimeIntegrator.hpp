@@ -8,6 +8,11 @@
 #include <vector>
 #include <deque>
 
+namespace polyfem::io
+{
+	class Checkpoint;
+} // namespace polyfem::io
+
 namespace polyfem::time_integrator
 {
 	/// Implicit time integrator of a second order ODE (equivently a system of coupled first order ODEs).
@@ -21,6 +26,9 @@ namespace polyfem::time_integrator
 		/// @param params json containing parameters specific to each time integrator
 		virtual void set_parameters(const json &params) {}
 
+		/// @brief Is the integrator explicit, i.e., the next solution is computed from the forces without a nonlinear solve.
+		virtual bool is_explicit() const { return false; }
+
 		/// @brief Initialize the time integrator with the previous values for \f$x\f$, \f$v\f$, and \f$a\f$.
 		/// @param x_prev previous value(s) for the solution
 		/// @param v_prev previous value(s) for the velocity
@@ -62,6 +70,10 @@ namespace polyfem::time_integrator
 		/// @param state_path path for the output file containing \f$x, v, a\f$ as hdf5
 		virtual void save_state(const std::string &state_path) const;
 
+		/// @brief Add the values of \f$x\f$, \f$v\f$, and \f$a\f$ to a checkpoint.
+		/// @param checkpoint checkpoint containing \f$x, v, a\f$ (one entry per previous step)
+		virtual void save_state(io::Checkpoint &checkpoint) const;
+
 		/// @brief Factory method for constructing implicit time integrators from the name of the integrator.
 		/// @param name name of the type of ImplicitTimeIntegrator to construct
 		/// @return new implicit time integrator of type specfied by name
@@ -88,6 +100,10 @@ namespace polyfem::time_integrator
 		/// @brief Get the current number of steps to use for integration.
 		int steps() const { return x_prevs_.size(); }
 
+		/// @brief Counter incremented every time the previous values change (init() or update_quantities()).
+		/// Lets users caching quantities derived from the history (e.g., \f$\tilde{x}\f$) detect stale values.
+		int revision() const { return revision_; }
+
 	protected:
 		/// @brief Get the maximum number of steps to use for integration.
 		virtual int max_steps() const { return 1; }
@@ -103,8 +119,15 @@ namespace polyfem::time_integrator
 		/// Store the necessary previous values of the acceleration for single or multi-step integration.
 		std::deque<Eigen::VectorXd> a_prevs_;
 
+		/// Incremented every time the previous values change, see revision().
+		int revision_ = 0;
+
 		/// Convenience functions for setting the most recent previous solution.
-		void set_x_prev(const Eigen::VectorXd &x_prev) { x_prevs_.front() = x_prev; }
+		void set_x_prev(const Eigen::VectorXd &x_prev)
+		{
+			x_prevs_.front() = x_prev;
+			++revision_;
+		}
 		/// Convenience functions for setting the most recent previous velocity.
 		void set_v_prev(const Eigen::VectorXd &v_prev) { v_prevs_.front() = v_prev; }
 		/// Convenience functions for setting the most recent previous acceleration.
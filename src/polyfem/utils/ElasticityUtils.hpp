@@ -81,14 +81,10 @@ namespace polyfem
 		local_dispv.setZero();
 		for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 		{
-			const auto &bs = data.vals.basis_values[i];
-			for (size_t ii = 0; ii < bs.global.size(); ++ii)
-			{
+			data.vals.for_each_global(i, [&](const int index, const double val) {
 				for (int d = 0; d < size; ++d)
-				{
-					local_dispv(i * size + d) += bs.global[ii].val * data.x(bs.global[ii].index * size + d);
-				}
-			}
+					local_dispv(i * size + d) += val * data.x(index * size + d);
+			});
 		}
 
 		DiffScalarBase::setVariableCount(local_dispv.rows());
@@ -114,6 +110,25 @@ namespace polyfem
 		for (long k = 0; k < def_grad.size(); ++k)
 			def_grad(k) = T(0);
 
+		const assembler::PackedElementValues &packed = data.vals.packed;
+		if (packed.is_valid())
+		{
+			// gradients are already mapped to the physical element, no need to multiply by jac_it
+			assert(packed.dim == size);
+			for (int i = 0; i < packed.n_bases; ++i)
+			{
+				const double *grad = packed.grad_t_m_at(i, p);
+				for (int d = 0; d < size; ++d)
+				{
+					for (int c = 0; c < size; ++c)
+					{
+						def_grad(d, c) += grad[c] * local_disp(i * size + d);
+					}
+				}
+			}
+			return;
+		}
+
 		for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 		{
 			const auto &bs = data.vals.basis_values[i];
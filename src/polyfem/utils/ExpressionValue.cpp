@@ -10,6 +10,13 @@
 #include <tinyexpr.h>
 #include <filesystem>
 
+#ifdef POLYFEM_WITH_TBB
+#include <tbb/enumerable_thread_specific.h>
+#else
+#include <mutex>
+#include <thread>
+#endif
+
 #include <iostream>
 
 namespace polyfem
@@ -60,6 +67,95 @@ namespace polyfem
 			return a < b ? 1.0 : 0.0;
 		}
 
+		// tinyexpr trees are bound to the address of their variables, so every thread
+		// evaluating the expression gets its own tree, compiled on first use
+		class ExpressionValue::CompiledExpression
+		{
+		public:
+			/// tinyexpr tree together with the variables it is bound to
+			struct Tree
+			{
+				double x = 0, y = 0, z = 0, t = 0;
+				te_expr *expr = nullptr;
+
+				Tree() = default;
+				Tree(const Tree &) = delete;
+				Tree &operator=(const Tree &) = delete;
+				~Tree() { te_free(expr); }
+
+				void compile(const std::string &str)
+				{
+					const std::vector<te_variable> vars = {
+						{"x", &x, TE_VARIABLE},
+						{"y", &y, TE_VARIABLE},
+						{"z", &z, TE_VARIABLE},
+						{"t", &t, TE_VARIABLE},
+						{"min", (const void *)min, TE_FUNCTION2},
+						{"max", (const void *)max, TE_FUNCTION2},
+						{"smoothstep", (const void *)smoothstep, TE_FUNCTION1},
+						{"half_smoothstep", (const void *)half_smoothstep, TE_FUNCTION1},
+						{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
+						{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
+						{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
+						{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
+						{"compare", (const void *)compare, TE_FUNCTION2},
+						{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
+						{"sign", (const void *)sign, TE_FUNCTION1},
+					};
+
+					int err;
+					expr = te_compile(str.c_str(), vars.data(), vars.size(), &err);
+					if (!expr)
+					{
+						logger().error("Unable to parse: {}", str);
+						logger().error("Error near here: {0: >{1}}", "^", err - 1);
+						assert(false);
+					}
+				}
+
+				double eval(const double x_, const double y_, const double z_, const double t_)
+				{
+					x = x_;
+					y = y_;
+					z = z_;
+					t = t_;
+					return expr ? te_eval(expr) : 0;
+				}
+			};
+
+			explicit CompiledExpression(const std::string &expr)
+				: expr_(expr)
+			{
+				// compile eagerly to report parsing errors at init
+				local();
+			}
+
+			Tree &local()
+			{
+#ifdef POLYFEM_WITH_TBB
+				std::unique_ptr<Tree> &tree = trees_.local();
+#else
+				std::lock_guard<std::mutex> lock(mutex_);
+				std::unique_ptr<Tree> &tree = trees_[std::this_thread::get_id()];
+#endif
+				if (!tree)
+				{
+					tree = std::make_unique<Tree>();
+					tree->compile(expr_);
+				}
+				return *tree;
+			}
+
+		private:
+			const std::string expr_;
+#ifdef POLYFEM_WITH_TBB
+			tbb::enumerable_thread_specific<std::unique_ptr<Tree>> trees_;
+#else
+			std::mutex mutex_;
+			std::map<std::thread::id, std::unique_ptr<Tree>> trees_;
+#endif
+		};
+
 		ExpressionValue::ExpressionValue()
 		{
 			clear();
@@ -68,6 +164,7 @@ namespace polyfem
 		void ExpressionValue::clear()
 		{
 			expr_ = "";
+			compiled_ = nullptr;
 			mat_.resize(0, 0);
 			mat_expr_ = {};
 			sfunc_ = nullptr;
@@ -114,36 +211,7 @@ namespace polyfem
 			}
 
 			expr_ = expr;
-
-			double x = 0, y = 0, z = 0, t = 0;
-
-			std::vector<te_variable> vars = {
-				{"x", &x, TE_VARIABLE},
-				{"y", &y, TE_VARIABLE},
-				{"z", &z, TE_VARIABLE},
-				{"t", &t, TE_VARIABLE},
-				{"min", (const void *)min, TE_FUNCTION2},
-				{"max", (const void *)max, TE_FUNCTION2},
-				{"smoothstep", (const void *)smoothstep, TE_FUNCTION1},
-				{"half_smoothstep", (const void *)half_smoothstep, TE_FUNCTION1},
-				{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
-				{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
-				{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
-				{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
-				{"compare", (const void *)compare, TE_FUNCTION2},
-				{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
-				{"sign", (const void *)sign, TE_FUNCTION1},
-			};
-
-			int err;
-			te_expr *tmp = te_compile(expr.c_str(), vars.data(), vars.size(), &err);
-			if (!tmp)
-			{
-				logger().error("Unable to parse: {}", expr);
-				logger().error("Error near here: {0: >{1}}", "^", err - 1);
-				assert(false);
-			}
-			te_free(tmp);
+			compiled_ = std::make_shared<CompiledExpression>(expr_);
 		}
 
 		void ExpressionValue::init(const json &vals)
@@ -185,6 +253,7 @@ namespace polyfem
 
 				unit_ = units::unit_from_string(vals["unit"].get<std::string>());
 				init(vals["value"]);
+				update_unit_conversion();
 			}
 			else
 			{
@@ -276,41 +345,64 @@ namespace polyfem
 			}
 			else
 			{
-
-				std::vector<te_variable> vars = {
-					{"x", &x, TE_VARIABLE},
-					{"y", &y, TE_VARIABLE},
-					{"z", &z, TE_VARIABLE},
-					{"t", &t, TE_VARIABLE},
-					{"min", (const void *)min, TE_FUNCTION2},
-					{"max", (const void *)max, TE_FUNCTION2},
-					{"smoothstep", (const void *)smoothstep, TE_FUNCTION1},
-					{"half_smoothstep", (const void *)half_smoothstep, TE_FUNCTION1},
-					{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
-					{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
-					{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
-					{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
-					{"compare", (const void *)compare, TE_FUNCTION2},
-					{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
-					{"sign", (const void *)sign, TE_FUNCTION1},
-				};
-
-				int err;
-				te_expr *tmp = te_compile(expr_.c_str(), vars.data(), vars.size(), &err);
-				assert(tmp != nullptr);
-				result = te_eval(tmp);
-				te_free(tmp);
+				result = compiled_->local().eval(x, y, z, t);
 			}
 
-			if (!unit_.base_units().empty())
+			return convert_unit_ ? convert_unit(result) : result;
+		}
+
+		void ExpressionValue::evaluate(const Eigen::MatrixXd &pts, const double t, Eigen::VectorXd &out) const
+		{
+			assert(pts.cols() == 2 || pts.cols() == 3);
+			out.resize(pts.rows());
+
+			const bool planar = pts.cols() == 2;
+			if (expr_.empty())
 			{
-				if (!unit_.is_convertible(unit_type_))
-					log_and_throw_error(fmt::format("Cannot convert {} to {}", units::to_string(unit_), units::to_string(unit_type_)));
+				for (int i = 0; i < pts.rows(); ++i)
+					out(i) = (*this)(pts(i, 0), pts(i, 1), planar ? 0 : pts(i, 2), t);
+				return;
+			}
+
+			assert(unit_type_set_);
 
-				result = units::convert(result, unit_, unit_type_);
+			CompiledExpression::Tree &tree = compiled_->local();
+			for (int i = 0; i < pts.rows(); ++i)
+				out(i) = tree.eval(pts(i, 0), pts(i, 1), planar ? 0 : pts(i, 2), t);
+
+			if (convert_unit_)
+			{
+				for (int i = 0; i < out.size(); ++i)
+					out(i) = convert_unit(out(i));
 			}
+		}
+
+		void ExpressionValue::update_unit_conversion()
+		{
+			convert_unit_ = false;
+			unit_is_affine_ = true;
+			unit_scale_ = 1;
+			unit_offset_ = 0;
+
+			if (unit_.base_units().empty() || !unit_type_set_)
+				return;
+
+			if (!unit_.is_convertible(unit_type_))
+				log_and_throw_error(fmt::format("Cannot convert {} to {}", units::to_string(unit_), units::to_string(unit_type_)));
+
+			convert_unit_ = true;
+			unit_offset_ = units::convert(0., unit_, unit_type_);
+			unit_scale_ = units::convert(1., unit_, unit_type_) - unit_offset_;
 
-			return result;
+			// logarithmic units are not affine, they are converted value by value
+			const double two = units::convert(2., unit_, unit_type_);
+			unit_is_affine_ = std::abs(two - (2 * unit_scale_ + unit_offset_)) <= 1e-12 * std::max(1., std::abs(two));
+		}
+
+		double ExpressionValue::convert_unit(const double value) const
+		{
+			assert(convert_unit_);
+			return unit_is_affine_ ? unit_scale_ * value + unit_offset_ : units::convert(value, unit_, unit_type_);
 		}
 	} // namespace utils
 } // namespace polyfem
@@ -2,6 +2,7 @@
 
 #include <polyfem/Common.hpp>
 #include <map>
+#include <memory>
 
 #include <units/units.hpp>
 
@@ -18,6 +19,7 @@ namespace polyfem
 			{
 				unit_type_ = units::unit_from_string(unit_type);
 				unit_type_set_ = true;
+				update_unit_conversion();
 			}
 
 			void init(const json &vals);
@@ -36,9 +38,17 @@ namespace polyfem
 
 			double operator()(double x, double y, double z = 0, double t = 0, int index = -1) const;
 
+			/// evaluates the value at every point at time t
+			/// @param[in] pts points, one per row (2 or 3 columns)
+			/// @param[in] t time
+			/// @param[out] out values, one per point
+			void evaluate(const Eigen::MatrixXd &pts, const double t, Eigen::VectorXd &out) const;
+
 			void clear();
 
 			bool is_zero() const { return expr_.empty() && fabs(value_) < 1e-10; }
+			/// the value does not depend on the point, the time, or the index
+			bool is_constant() const { return expr_.empty() && mat_.size() == 0 && mat_expr_.empty() && t_index_.empty() && !sfunc_ && !tfunc_; }
 			bool is_mat() const
 			{
 				if (expr_.empty() && mat_.size() > 0)
@@ -65,12 +75,23 @@ namespace polyfem
 				return value_;
 			}
 
+			/// value of a constant expression, in the unit type
+			double constant_value() const
+			{
+				assert(is_constant());
+				return convert_unit_ ? convert_unit(value_) : value_;
+			}
+
 		private:
+			/// expression compiled once per thread
+			class CompiledExpression;
+
 			std::function<double(double x, double y, double z, double t, int index)> sfunc_;
 			std::function<Eigen::MatrixXd(double x, double y, double z, double t)> tfunc_;
 			int tfunc_coo_;
 
 			std::string expr_;
+			std::shared_ptr<CompiledExpression> compiled_;
 			double value_;
 			Eigen::MatrixXd mat_;
 			std::vector<ExpressionValue> mat_expr_;
@@ -79,6 +100,16 @@ namespace polyfem
 			units::precise_unit unit_type_;
 			units::precise_unit unit_;
 			bool unit_type_set_ = false;
+
+			/// conversion from unit_ to unit_type_, result = unit_scale_ * value + unit_offset_
+			bool convert_unit_ = false;
+			bool unit_is_affine_ = true;
+			double unit_scale_ = 1;
+			double unit_offset_ = 0;
+
+			/// checks the units and precomputes the conversion factors
+			void update_unit_conversion();
+			double convert_unit(const double value) const;
 		};
 	} // namespace utils
 } // namespace polyfem
@@ -3,8 +3,23 @@
 #include <polyfem/utils/MaybeParallelFor.hpp>
 #include <polyfem/utils/Logger.hpp>
 
+#include <atomic>
+#include <cstdint>
+
 namespace polyfem::utils
 {
+	namespace
+	{
+		inline void atomic_add(double &target, const double value)
+		{
+			static_assert(sizeof(std::atomic<double>) == sizeof(double));
+			std::atomic<double> &atomic_target = reinterpret_cast<std::atomic<double> &>(target);
+			double expected = atomic_target.load(std::memory_order_relaxed);
+			while (!atomic_target.compare_exchange_weak(expected, expected + value, std::memory_order_relaxed))
+				;
+		}
+	} // namespace
+
 	SparseMatrixCache::SparseMatrixCache(const size_t size)
 	{
 		init(size);
@@ -28,22 +43,26 @@ namespace polyfem::utils
 
 	void SparseMatrixCache::init(const size_t size)
 	{
-		assert(mapping().empty() || size_ == size);
-
-		size_ = size;
-		tmp_.resize(size_, size_);
-		mat_.resize(size_, size_);
-		mat_.setZero();
+		init(size, size);
 	}
 
 	void SparseMatrixCache::init(const size_t rows, const size_t cols)
 	{
-		assert(mapping().empty());
+		assert(mapping().empty() || (rows_ == rows && cols_ == cols));
 
-		size_ = rows == cols ? rows : 0;
-		tmp_.resize(rows, cols);
-		mat_.resize(rows, cols);
-		mat_.setZero();
+		rows_ = rows;
+		cols_ = cols;
+		tmp_.resize(rows_, cols_);
+		if (mapping().empty() || mat_.rows() != rows_ || mat_.cols() != cols_)
+		{
+			mat_.resize(rows_, cols_);
+			mat_.setZero();
+		}
+		else
+		{
+			// once the pattern is known mat_ only receives values_, keep its structure
+			mat_.coeffs().setZero();
+		}
 	}
 
 	void SparseMatrixCache::init(const MatrixCache &other)
@@ -67,7 +86,10 @@ namespace polyfem::utils
 			// Only one level of cache
 			assert(main_cache_ != this && main_cache_ != nullptr && main_cache_->main_cache_ == nullptr);
 		}
-		size_ = other.size_;
+		rows_ = other.rows_;
+		cols_ = other.cols_;
+		shared_values_ = other.shared_values_;
+		use_atomic_ = other.use_atomic_;
 
 		values_.resize(other.values_.size());
 
@@ -77,10 +99,33 @@ namespace polyfem::utils
 		std::fill(values_.begin(), values_.end(), 0);
 	}
 
+	void SparseMatrixCache::init_shared(SparseMatrixCache &main, const bool use_atomic)
+	{
+		assert(this != &main);
+		assert(main.main_cache_ == nullptr && main.has_mapping());
+
+		main_cache_ = &main;
+		rows_ = main.rows_;
+		cols_ = main.cols_;
+
+		entries_.clear();
+		values_.clear();
+		mat_.resize(0, 0);
+		tmp_.resize(0, 0);
+
+		shared_values_ = main.values_.data();
+		use_atomic_ = use_atomic;
+		current_e_ = -1;
+		current_e_index_ = -1;
+	}
+
 	void SparseMatrixCache::set_zero()
 	{
 		tmp_.setZero();
-		mat_.setZero();
+		if (mapping().empty())
+			mat_.setZero();
+		else
+			mat_.coeffs().setZero();
 
 		std::fill(values_.begin(), values_.end(), 0);
 	}
@@ -107,7 +152,14 @@ namespace polyfem::utils
 			}
 
 			// save entry directly to value buffer at the proper index
-			values_[second_cache()[e][current_e_index_]] += value;
+			assert(current_e_index_ < second_cache()[e].size());
+			const int index = second_cache()[e][current_e_index_];
+			if (shared_values_ == nullptr)
+				values_[index] += value;
+			else if (use_atomic_)
+				atomic_add(shared_values_[index], value);
+			else
+				shared_values_[index] += value;
 			current_e_index_++;
 		}
 	}
@@ -138,13 +190,13 @@ namespace polyfem::utils
 		// caches have yet to be constructed (likely because the matrix has yet to be fully assembled)
 		if (mapping().empty())
 		{
-			if (compute_mapping && size_ > 0)
+			if (compute_mapping && rows_ > 0 && cols_ > 0)
 			{
 				assert(main_cache_ == nullptr);
 
 				values_.resize(mat_.nonZeros());
 				inner_index_.resize(mat_.nonZeros());
-				outer_index_.resize(mat_.rows() + 1);
+				outer_index_.resize(mat_.outerSize() + 1);
 				mapping_.resize(mat_.rows());
 
 				// note: mat_ is column major
@@ -206,6 +258,7 @@ namespace polyfem::utils
 					}
 				}
 
+				compute_element_colors();
 				second_cache_entries_.resize(0);
 
 				logger().trace("Second cache computed");
@@ -213,12 +266,21 @@ namespace polyfem::utils
 		}
 		else
 		{
-			assert(size_ > 0);
+			assert(rows_ > 0 && cols_ > 0);
 			const auto &outer_index = main_cache()->outer_index_;
 			const auto &inner_index = main_cache()->inner_index_;
-			// directly write the values to the matrix
-			mat_ = Eigen::Map<const StiffnessMatrix>(
-				size_, size_, values_.size(), &outer_index[0], &inner_index[0], &values_[0]);
+			if (mat_.isCompressed() && mat_.rows() == rows_ && mat_.cols() == cols_ && mat_.nonZeros() == values_.size())
+			{
+				// mat_ already has the cached structure, directly write the values to it
+				assert(std::equal(outer_index.begin(), outer_index.end(), mat_.outerIndexPtr()));
+				std::copy(values_.begin(), values_.end(), mat_.valuePtr());
+			}
+			else
+			{
+				// directly write the values to the matrix
+				mat_ = Eigen::Map<const StiffnessMatrix>(
+					rows_, cols_, values_.size(), outer_index.data(), inner_index.data(), values_.data());
+			}
 
 			current_e_ = -1;
 			current_e_index_ = -1;
@@ -228,6 +290,31 @@ namespace polyfem::utils
 		return mat_;
 	}
 
+	void SparseMatrixCache::compute_element_colors()
+	{
+		std::vector<int> order;
+		for (int e = 0; e < second_cache_entries_.size(); ++e)
+		{
+			if (!second_cache_entries_[e].empty())
+				order.push_back(e);
+		}
+
+		// the shared view falls back to atomics when coloring needs too many colors
+		constexpr int max_colors = 64;
+		element_colors_ = utils::compute_element_colors(
+			order, rows_,
+			[&](const int e, const auto &f) {
+				for (const auto &p : second_cache_entries_[e])
+					f(p.first);
+			},
+			max_colors);
+
+		if (element_colors_.empty() && !order.empty())
+			logger().debug("Unable to color the elements with {} colors, assembly will use atomics", max_colors);
+		else
+			logger().trace("Elements colored with {} colors", element_colors_.size());
+	}
+
 	std::shared_ptr<MatrixCache> SparseMatrixCache::operator+(const MatrixCache &a) const
 	{
 		assert(&a == &dynamic_cast<const SparseMatrixCache &>(a));
@@ -6,9 +6,52 @@
 #include <Eigen/Sparse>
 
 #include <memory>
+#include <vector>
 
 namespace polyfem::utils
 {
+	/// greedy coloring of the elements visited in the given order, elements sharing a key (e.g., a matrix row or a global node) get different colors
+	/// @param[in] order elements to color, in the order they are visited
+	/// @param[in] n_keys number of keys, every key is in [0, n_keys)
+	/// @param[in] for_each_key for_each_key(e, f) calls f(k) for every key k of element e
+	/// @param[in] max_colors the coloring fails if more colors are needed, 0 for no limit
+	/// @return elements grouped by color (each group follows order), empty if the coloring failed
+	template <typename ForEachKey>
+	std::vector<std::vector<int>> compute_element_colors(const std::vector<int> &order, const int n_keys, ForEachKey &&for_each_key, const int max_colors = 0)
+	{
+		std::vector<std::vector<int>> colors;
+		std::vector<std::vector<int>> key_colors(n_keys); // colors already used by the elements of each key
+		std::vector<int> forbidden;                        // forbidden[c] == e if color c is used by a neighbor of e
+
+		for (const int e : order)
+		{
+			for_each_key(e, [&](const int k) {
+				for (const int c : key_colors[k])
+					forbidden[c] = e;
+			});
+
+			int c = 0;
+			while (c < forbidden.size() && forbidden[c] == e)
+				++c;
+
+			if (c == forbidden.size())
+			{
+				if (max_colors > 0 && c >= max_colors)
+					return {};
+				forbidden.push_back(-1);
+				colors.emplace_back();
+			}
+
+			for_each_key(e, [&](const int k) {
+				if (key_colors[k].empty() || key_colors[k].back() != c)
+					key_colors[k].push_back(c);
+			});
+			colors[c].push_back(e);
+		}
+
+		return colors;
+	}
+
 	/// abstract class used for caching 
 	class MatrixCache
 	{
@@ -64,6 +107,10 @@ namespace polyfem::utils
 		void init(const MatrixCache &other) override;
 		/// set matrix to be a matrix of all zeros with same size as other (potentially with the same main cache)
 		void init(const SparseMatrixCache &other, const bool copy_main_cache_ptr = false);
+		/// make this cache a view writing directly into the values of main (which must have a mapping)
+		/// no local storage is used: concurrent writes to the same entry must be prevented
+		/// by the caller (e.g., by assembling one element color at a time) or use_atomic must be true
+		void init_shared(SparseMatrixCache &main, const bool use_atomic);
 
 		/// set matrix values to zero
 		/// modifies tmp_, mat_, and values (setting all to zero)
@@ -76,6 +123,11 @@ namespace polyfem::utils
 		inline size_t triplet_count() const override { return entries_.size() + mat_.nonZeros(); }
 		inline bool is_sparse() const override { return true; }
 		inline size_t mapping_size() const { return mapping_.size(); }
+		inline bool has_mapping() const { return !mapping().empty(); }
+
+		/// groups of elements not sharing any row of the matrix, computed together with the mapping
+		/// empty if the elements could not be colored
+		inline const std::vector<std::vector<int>> &element_colors() const { return main_cache()->element_colors_; }
 
 		/// e = element_index, i = global row_index, j = global column_index, value = value to add to matrix
 		/// if the cache is yet to be constructed, save the row, column, and value to be added to the second cache
@@ -104,7 +156,7 @@ namespace polyfem::utils
 		const std::vector<Eigen::Triplet<double>> &entries() const { return entries_; }
 
 	private:
-		size_t size_;
+		size_t rows_ = 0, cols_ = 0;
 		StiffnessMatrix tmp_, mat_;
 		std::vector<Eigen::Triplet<double>> entries_; ///< contains global matrix indices and corresponding value
 		std::vector<std::vector<std::pair<int, size_t>>> mapping_; ///< maps row indices to column index/local index pairs
@@ -114,9 +166,16 @@ namespace polyfem::utils
 
 		std::vector<std::vector<int>> second_cache_; ///< maps element index to local index
 		std::vector<std::vector<std::pair<int, int>>> second_cache_entries_; ///< maps element indices to global matrix indices
+		std::vector<std::vector<int>> element_colors_; ///< elements grouped by color
 		int current_e_ = -1;
 		int current_e_index_ = -1;
 
+		double *shared_values_ = nullptr; ///< values_ of the main cache when used as a shared view
+		bool use_atomic_ = false;
+
+		/// greedy coloring of the elements from second_cache_entries_, fills element_colors_
+		void compute_element_colors();
+
 		inline const SparseMatrixCache *main_cache() const
 		{
 			return main_cache_ == nullptr ? this : main_cache_;
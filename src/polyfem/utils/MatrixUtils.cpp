@@ -159,6 +159,41 @@ void polyfem::utils::full_to_reduced_matrix(
 	reduced.makeCompressed();
 }
 
+bool polyfem::utils::add_to_sparse_pattern(
+	const StiffnessMatrix &src,
+	const double weight,
+	StiffnessMatrix &dst)
+{
+	if (src.rows() != dst.rows() || src.cols() != dst.cols())
+		return false;
+
+	// both inner indices are sorted, walk the two columns together
+	const auto for_each_match = [&](const auto &on_match) {
+		for (int k = 0; k < src.outerSize(); ++k)
+		{
+			StiffnessMatrix::InnerIterator dst_it(dst, k);
+			for (StiffnessMatrix::InnerIterator src_it(src, k); src_it; ++src_it)
+			{
+				while (dst_it && dst_it.index() < src_it.index())
+					++dst_it;
+				if (!dst_it || dst_it.index() != src_it.index())
+					return false;
+				on_match(dst_it, src_it.value());
+			}
+		}
+		return true;
+	};
+
+	if (!for_each_match([](StiffnessMatrix::InnerIterator &, const double) {}))
+		return false;
+
+	for_each_match([weight](StiffnessMatrix::InnerIterator &dst_it, const double value) {
+		dst_it.valueRef() += weight * value;
+	});
+
+	return true;
+}
+
 Eigen::MatrixXd polyfem::utils::reorder_matrix(
 	const Eigen::MatrixXd &in,
 	const Eigen::VectorXi &in_to_out,
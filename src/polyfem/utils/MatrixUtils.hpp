@@ -113,6 +113,16 @@ namespace polyfem
 			const StiffnessMatrix &full,
 			StiffnessMatrix &reduced);
 
+		/// @brief Add a scaled sparse matrix into another one without changing its sparsity pattern.
+		/// @param[in] src Matrix to add.
+		/// @param[in] weight Scaling of src.
+		/// @param[in,out] dst Compressed matrix receiving weight * src.
+		/// @return False, leaving dst untouched, if the pattern of src is not contained in the pattern of dst.
+		bool add_to_sparse_pattern(
+			const StiffnessMatrix &src,
+			const double weight,
+			StiffnessMatrix &dst);
+
 		/// @brief Reorder row blocks in a matrix.
 		/// @param in Input matrix.
 		/// @param in_to_out Mapping from input blocks to output blocks.
@@ -2,11 +2,21 @@
 
 #include <polyfem/assembler/NeoHookeanElasticity.hpp>
 #include <polyfem/assembler/NeoHookeanElasticityAutodiff.hpp>
+#include <polyfem/assembler/MooneyRivlinElasticity.hpp>
+#include <polyfem/assembler/MooneyRivlin3ParamElasticity.hpp>
+#include <polyfem/assembler/OgdenElasticity.hpp>
+#include <polyfem/assembler/Mass.hpp>
+#include <polyfem/assembler/MatParams.hpp>
+#include <polyfem/assembler/AssemblerUtils.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <set>
 
 using namespace polyfem;
 using namespace polyfem::assembler;
@@ -14,6 +24,46 @@ using namespace polyfem::basis;
 using namespace polyfem::mesh;
 using namespace polyfem::utils;
 
+namespace
+{
+	std::shared_ptr<State> get_cached_state(const int discr_order)
+	{
+		const std::string path = POLYFEM_DATA_DIR;
+		json in_args = json({});
+		in_args["geometry"] = {};
+		in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+		in_args["geometry"]["surface_selection"] = 7;
+
+		in_args["space"] = {};
+		in_args["space"]["discr_order"] = discr_order;
+
+		in_args["preset_problem"] = {};
+		in_args["preset_problem"]["type"] = "ElasticExact";
+
+		in_args["materials"] = {};
+		in_args["materials"]["type"] = "NeoHookean";
+		in_args["materials"]["E"] = 1e5;
+		in_args["materials"]["nu"] = 0.3;
+
+		auto state = std::make_shared<State>();
+		state->init_logger("", spdlog::level::err, spdlog::level::off, false);
+		state->init(in_args, true);
+		state->load_mesh();
+		state->build_basis();
+
+		return state;
+	}
+
+	// number of heap buffers duplicated when copying an ElementAssemblyValues
+	long count_heap_buffers(const ElementAssemblyValues &vals)
+	{
+		long n = 5; // basis_values, jac_it, quadrature points and weights, val, det
+		for (const auto &v : vals.basis_values)
+			n += 4 + v.global.size(); // global, val, grad, grad_t_m, and one node per global entry
+		return n;
+	}
+} // namespace
+
 TEST_CASE("hessian_lin", "[assembler]")
 {
 	const std::string path = POLYFEM_DATA_DIR;
@@ -284,3 +334,494 @@ TEST_CASE("generic_elastic_assembler", "[assembler]")
 		}
 	}
 }
+
+TEST_CASE("assembly_vals_cache_view", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const AssemblyValsCache &cache = state->ass_vals_cache;
+	REQUIRE(cache.is_initialized());
+
+	AssemblyValsCache empty_cache;
+	ElementAssemblyValues copy, tmp;
+
+	for (int e = 0; e < state->bases.size(); ++e)
+	{
+		cache.compute(e, is_volume, state->bases[e], state->geom_bases()[e], copy);
+
+		const ElementAssemblyValues &view = cache.get(e, is_volume, state->bases[e], state->geom_bases()[e], tmp);
+		REQUIRE(&view == &cache.get(e));
+		REQUIRE(&view != &tmp);
+
+		REQUIRE(view.element_id == copy.element_id);
+		REQUIRE(view.det == copy.det);
+		REQUIRE(view.val == copy.val);
+		REQUIRE(view.basis_values.size() == copy.basis_values.size());
+		for (int i = 0; i < view.basis_values.size(); ++i)
+			REQUIRE(view.grad_t_m(i) == copy.basis_values[i].grad_t_m);
+
+		// without a cache the values are computed in the temporary
+		const ElementAssemblyValues &computed = empty_cache.get(e, is_volume, state->bases[e], state->geom_bases()[e], tmp);
+		REQUIRE(&computed == &tmp);
+		REQUIRE((computed.det - copy.det).norm() == Catch::Approx(0).margin(1e-12));
+	}
+}
+
+TEST_CASE("assembly_vals_cache_packed", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const AssemblyValsCache &cache = state->ass_vals_cache;
+	REQUIRE(cache.is_initialized());
+
+	ElementAssemblyValues copy, fresh;
+
+	for (int e = 0; e < state->bases.size(); ++e)
+	{
+		fresh.compute(e, is_volume, state->bases[e], state->geom_bases()[e]);
+		const ElementAssemblyValues &vals = cache.get(e);
+		const PackedElementValues &packed = vals.packed;
+		REQUIRE(packed.is_valid());
+		REQUIRE(packed.n_bases == vals.basis_values.size());
+		REQUIRE(reinterpret_cast<std::uintptr_t>(packed.val) % AlignedBuffer<double>::ALIGNMENT == 0);
+
+		for (int i = 0; i < packed.n_bases; ++i)
+		{
+			const AssemblyValues &bv = vals.basis_values[i];
+			// the mapped gradients are only stored in the arena
+			REQUIRE(bv.grad_t_m.size() == 0);
+			REQUIRE(vals.grad_t_m(i) == fresh.basis_values[i].grad_t_m);
+			for (int q = 0; q < packed.n_quad; ++q)
+			{
+				REQUIRE(packed.val_at(i, q) == bv.val(q));
+				for (int d = 0; d < packed.dim; ++d)
+					REQUIRE(packed.grad_t_m_at(i, q)[d] == fresh.basis_values[i].grad_t_m(q, d));
+			}
+
+			int k = 0;
+			vals.for_each_global(i, [&](const int index, const double w) {
+				REQUIRE(index == bv.global[k].index);
+				REQUIRE(w == bv.global[k].val);
+				++k;
+			});
+			REQUIRE(k == bv.global.size());
+		}
+
+		// copies do not reference the cache memory
+		cache.compute(e, is_volume, state->bases[e], state->geom_bases()[e], copy);
+		REQUIRE(!copy.packed.is_valid());
+		for (int i = 0; i < packed.n_bases; ++i)
+			REQUIRE(copy.basis_values[i].grad_t_m == fresh.basis_values[i].grad_t_m);
+	}
+}
+
+TEST_CASE("linear_assembler_pattern_reuse", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const Mass &mass_assembler = *state->mass_matrix_assembler;
+
+	StiffnessMatrix first, second;
+	mass_assembler.assemble(is_volume, state->n_bases, state->bases, state->geom_bases(), state->mass_ass_vals_cache, 0, first, true);
+	// second assembly writes the values in the cached pattern
+	mass_assembler.assemble(is_volume, state->n_bases, state->bases, state->geom_bases(), state->mass_ass_vals_cache, 0, second, true);
+
+	REQUIRE(first.nonZeros() == second.nonZeros());
+	REQUIRE((first - second).norm() == Catch::Approx(0).margin(1e-12 * first.norm()));
+
+	// a different values cache invalidates the pattern
+	AssemblyValsCache uncached = state->mass_ass_vals_cache;
+	uncached.clear();
+	StiffnessMatrix third;
+	mass_assembler.assemble(is_volume, state->n_bases, state->bases, state->geom_bases(), uncached, 0, third, true);
+	REQUIRE((first - third).norm() == Catch::Approx(0).margin(1e-12 * first.norm()));
+
+	// copies start without pattern
+	const Mass copy = mass_assembler;
+	StiffnessMatrix fourth;
+	copy.assemble(is_volume, state->n_bases, state->bases, state->geom_bases(), state->mass_ass_vals_cache, 0, fourth, true);
+	REQUIRE((first - fourth).norm() == Catch::Approx(0).margin(1e-12 * first.norm()));
+}
+
+TEST_CASE("hessian_shared_scatter", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const int n_elements = state->bases.size();
+
+	Eigen::MatrixXd disp(state->n_bases * 2, 1);
+	disp.setRandom();
+	disp *= 1e-2;
+
+	SparseMatrixCache mat_cache;
+	StiffnessMatrix first, second;
+	// first assembly computes the pattern and the element coloring
+	state->assembler->assemble_hessian(is_volume, state->n_bases, false, state->bases, state->geom_bases(), state->ass_vals_cache, 0, 0, disp, Eigen::MatrixXd(), mat_cache, first);
+	REQUIRE(mat_cache.has_mapping());
+
+	// elements of the same color do not share any dof
+	const auto &colors = mat_cache.element_colors();
+	REQUIRE(!colors.empty());
+	std::vector<int> element_color(n_elements, -1);
+	for (int c = 0; c < colors.size(); ++c)
+	{
+		std::vector<bool> used(state->n_bases, false);
+		for (const int e : colors[c])
+		{
+			REQUIRE(element_color[e] < 0);
+			element_color[e] = c;
+			std::set<int> dofs;
+			for (const auto &b : state->bases[e].bases)
+				for (const auto &g : b.global())
+					dofs.insert(g.index);
+			for (const int d : dofs)
+			{
+				REQUIRE(!used[d]);
+				used[d] = true;
+			}
+		}
+	}
+	for (int e = 0; e < n_elements; ++e)
+		REQUIRE(element_color[e] >= 0);
+
+	// second assembly scatters directly in the shared values
+	state->assembler->assemble_hessian(is_volume, state->n_bases, false, state->bases, state->geom_bases(), state->ass_vals_cache, 0, 0, disp, Eigen::MatrixXd(), mat_cache, second);
+
+	REQUIRE(first.nonZeros() == second.nonZeros());
+	REQUIRE((first - second).norm() == Catch::Approx(0).margin(1e-10 * first.norm()));
+}
+
+TEST_CASE("element_ordering", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const int n_elements = state->bases.size();
+	REQUIRE(state->element_ordering != nullptr);
+	REQUIRE(state->ass_vals_cache.element_ordering() == state->element_ordering.get());
+
+	const std::string strategy = GENERATE(std::string("none"), std::string("morton"), std::string("rcm"));
+
+	mesh::ElementOrdering ordering;
+	ordering.build(*state->mesh, state->bases, strategy);
+	REQUIRE(ordering.n_elements() == n_elements);
+
+	// the order is a permutation
+	std::vector<int> order = ordering.order();
+	std::sort(order.begin(), order.end());
+	for (int e = 0; e < n_elements; ++e)
+		REQUIRE(order[e] == e);
+
+	// elements of the same color do not share any node
+	int n_colored = 0;
+	for (const auto &color : ordering.colors())
+	{
+		std::set<int> nodes;
+		for (const int e : color)
+		{
+			std::set<int> element_nodes;
+			for (const auto &b : state->bases[e].bases)
+				for (const auto &g : b.global())
+					element_nodes.insert(g.index);
+			for (const int n : element_nodes)
+				REQUIRE(nodes.insert(n).second);
+		}
+		n_colored += color.size();
+	}
+	REQUIRE(n_colored == n_elements);
+
+	// the assembled quantities do not depend on the order
+	Eigen::MatrixXd disp(state->n_bases * 2, 1);
+	disp.setRandom();
+	disp *= 1e-2;
+
+	const bool is_volume = state->mesh->is_volume();
+	AssemblyValsCache cache = state->ass_vals_cache;
+	cache.set_element_ordering(nullptr);
+	const double energy = state->assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), cache, 0, 0, disp, Eigen::MatrixXd());
+	Eigen::MatrixXd grad;
+	state->assembler->assemble_gradient(is_volume, state->n_bases, state->bases, state->geom_bases(), cache, 0, 0, disp, Eigen::MatrixXd(), grad);
+
+	cache.set_element_ordering(std::make_shared<mesh::ElementOrdering>(ordering));
+	const double ordered_energy = state->assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), cache, 0, 0, disp, Eigen::MatrixXd());
+	Eigen::MatrixXd ordered_grad;
+	state->assembler->assemble_gradient(is_volume, state->n_bases, state->bases, state->geom_bases(), cache, 0, 0, disp, Eigen::MatrixXd(), ordered_grad);
+
+	REQUIRE(ordered_energy == Catch::Approx(energy).epsilon(1e-12));
+	REQUIRE((grad - ordered_grad).norm() == Catch::Approx(0).margin(1e-10 * grad.norm()));
+}
+
+TEST_CASE("material_param_table", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const AssemblyValsCache &cache = state->ass_vals_cache;
+
+	LameParameters constant;
+	constant.add_multimaterial(0, json({{"E", 1e5}, {"nu", 0.3}}), is_volume, "Pa");
+
+	LameParameters varying;
+	varying.add_multimaterial(0, json({{"E", "1e5 * (1 + x * x + t)"}, {"nu", 0.3}}), is_volume, "Pa");
+	varying.update_quadrature_table(is_volume, state->bases, state->geom_bases(), cache, 0);
+
+	Density density;
+	density.add_multimaterial(0, json({{"rho", "1 + y * y"}}), "kg/m^3");
+	density.update_quadrature_table(is_volume, state->bases, state->geom_bases(), cache, 0);
+
+	const double E = 1e5, nu = 0.3;
+	ElementAssemblyValues tmp;
+	for (int e = 0; e < state->bases.size(); ++e)
+	{
+		const ElementAssemblyValues &vals = cache.get(e, is_volume, state->bases[e], state->geom_bases()[e], tmp);
+		for (int q = 0; q < vals.quadrature.points.rows(); ++q)
+		{
+			const Eigen::MatrixXd uv = vals.quadrature.points.row(q);
+			const Eigen::MatrixXd pt = vals.val.row(q);
+
+			double lambda, mu;
+			constant.lambda_mu(vals, q, 0, lambda, mu);
+			REQUIRE(lambda == Catch::Approx((nu * E) / (1.0 - nu * nu)));
+			REQUIRE(mu == Catch::Approx(E / (2.0 * (1.0 + nu))));
+
+			for (const double t : {0., 1.})
+			{
+				double expected_lambda, expected_mu;
+				varying.lambda_mu(uv, pt, t, e, expected_lambda, expected_mu);
+				varying.lambda_mu(vals, q, t, lambda, mu);
+				REQUIRE(lambda == Catch::Approx(expected_lambda));
+				REQUIRE(mu == Catch::Approx(expected_mu));
+
+				REQUIRE(density(vals, q, t) == Catch::Approx(density(uv, pt, t, e)));
+			}
+		}
+	}
+
+	// per element parameters override the table
+	const Eigen::VectorXd lambdas = Eigen::VectorXd::Constant(state->bases.size(), 2);
+	const Eigen::VectorXd mus = Eigen::VectorXd::Constant(state->bases.size(), 3);
+	varying.set_lame_mats(lambdas, mus);
+
+	double lambda, mu;
+	varying.lambda_mu(cache.get(0, is_volume, state->bases[0], state->geom_bases()[0], tmp), 0, 0, lambda, mu);
+	REQUIRE(lambda == 2);
+	REQUIRE(mu == 3);
+}
+
+TEST_CASE("generic_elastic_tangent", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const int dim = state->mesh->dimension();
+
+	MooneyRivlinElasticity mooney_rivlin;
+	MooneyRivlin3ParamElasticity mooney_rivlin_3;
+	IncompressibleOgdenElasticity ogden;
+	NeoHookeanAutodiff neo_hookean;
+
+	mooney_rivlin.set_size(dim);
+	mooney_rivlin_3.set_size(dim);
+	ogden.set_size(dim);
+	neo_hookean.set_size(dim);
+
+	mooney_rivlin.add_multimaterial(0, json({{"c1", 1e3}, {"c2", 2e2}, {"k", 1e4}}), state->units);
+	mooney_rivlin_3.add_multimaterial(0, json({{"c1", 1e3}, {"c2", 2e2}, {"c3", 1e2}, {"d1", 1e4}}), state->units);
+	ogden.add_multimaterial(0, json({{"c", {1e3, 2e2}}, {"m", {2, -1.5}}, {"k", 1e4}}), state->units);
+	neo_hookean.add_multimaterial(0, json({{"E", 1e5}, {"nu", 0.3}}), state->units);
+
+	Eigen::MatrixXd displacement(state->n_bases * dim, 1);
+	displacement.setRandom();
+	displacement *= 1e-2;
+
+	const auto check = [&](const auto &assembler) {
+		ElementAssemblyValues tmp;
+		for (int e = 0; e < state->bases.size(); ++e)
+		{
+			const ElementAssemblyValues &vals = state->ass_vals_cache.get(e, is_volume, state->bases[e], state->geom_bases()[e], tmp);
+			const QuadratureVector da = vals.det.array() * vals.quadrature.weights.array();
+			const NonLinearAssemblerData data(vals, 0, 0, displacement, displacement, da);
+
+			const Eigen::VectorXd grad = assembler.assemble_gradient(data);
+			const Eigen::VectorXd grad_autodiff = assembler.assemble_gradient_autodiff(data);
+			REQUIRE(grad.size() == grad_autodiff.size());
+			REQUIRE((grad - grad_autodiff).norm() == Catch::Approx(0).margin(1e-10 * std::max(1., grad_autodiff.norm())));
+
+			const Eigen::MatrixXd hessian = assembler.assemble_hessian(data);
+			const Eigen::MatrixXd hessian_autodiff = assembler.assemble_hessian_autodiff(data);
+			REQUIRE(hessian.rows() == hessian_autodiff.rows());
+			REQUIRE((hessian - hessian_autodiff).norm() == Catch::Approx(0).margin(1e-10 * std::max(1., hessian_autodiff.norm())));
+		}
+	};
+
+	check(mooney_rivlin);
+	check(mooney_rivlin_3);
+	check(ogden);
+	check(neo_hookean);
+}
+
+TEST_CASE("element_batch_energy", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const int dim = state->mesh->dimension();
+	const AssemblyValsCache &cache = state->ass_vals_cache;
+
+	const std::string formulation = GENERATE(std::string("NeoHookean"), std::string("LinearElasticity"));
+	const json material = GENERATE(json({{"E", 1e5}, {"nu", 0.3}}), json({{"E", "1e5 * (1 + x * x)"}, {"nu", 0.3}}));
+	const bool use_table = GENERATE(false, true);
+
+	const auto assembler = AssemblerUtils::make_assembler(formulation);
+	assembler->set_size(dim);
+	assembler->add_multimaterial(0, material, state->units);
+	// both paths read the parameters from the quadrature table when it is set
+	if (use_table)
+		assembler->update_material_cache(is_volume, state->bases, state->geom_bases(), cache, 0);
+
+	// elements of a batch share their quadrature, the last batch of every kind is partially filled
+	ElementBatches batches;
+	const std::vector<ElementBatch> &batched = batches.get(is_volume, dim, state->bases, cache);
+	int n_batched = 0;
+	for (const ElementBatch &batch : batched)
+	{
+		REQUIRE(batch.n_elements > 0);
+		REQUIRE(batch.n_elements <= ElementBatch::BATCH_SIZE);
+		for (int l = 0; l < batch.n_elements; ++l)
+			REQUIRE(cache.get(batch.elements[l]).quadrature.weights.size() == batch.n_quad);
+		n_batched += batch.n_elements;
+	}
+	REQUIRE(n_batched == state->bases.size());
+	REQUIRE(&batches.get(is_volume, dim, state->bases, cache) == &batched);
+
+	Eigen::MatrixXd disp(state->n_bases * dim, 1);
+	disp.setRandom();
+	disp *= 1e-2;
+
+	assembler->set_use_element_batches(false);
+	const double energy = assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), cache, 0, 0, disp, disp);
+
+	assembler->set_use_element_batches(true);
+	const double batched_energy = assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), cache, 0, 0, disp, disp);
+
+	REQUIRE(batched_energy == Catch::Approx(energy).epsilon(1e-12));
+}
+
+TEST_CASE("element_batch_cache_update", "[assembler]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const int dim = state->mesh->dimension();
+
+	AssemblyValsCache cache;
+	cache.init(is_volume, state->bases, state->geom_bases());
+
+	const auto assembler = AssemblerUtils::make_assembler("NeoHookean");
+	assembler->set_size(dim);
+	assembler->add_multimaterial(0, json({{"E", 1e5}, {"nu", 0.3}}), state->units);
+	assembler->set_use_element_batches(true);
+
+	Eigen::MatrixXd disp(state->n_bases * dim, 1);
+	disp.setRandom();
+	disp *= 1e-2;
+
+	ElementBatches batches;
+	batches.get(is_volume, dim, state->bases, cache);
+
+	// updating an element (e.g., adaptive quadrature) changes the id, the batches are rebuilt
+	const size_t id = cache.id();
+	const int e = 0;
+	cache.update(e, is_volume, state->bases[e], state->geom_bases()[e]);
+	REQUIRE(cache.id() != id);
+	REQUIRE(!cache.get(e).packed.is_valid());
+
+	// the batches read the refreshed values of the updated element
+	for (const ElementBatch &batch : batches.get(is_volume, dim, state->bases, cache))
+	{
+		for (int l = 0; l < batch.n_elements; ++l)
+			REQUIRE(batch.vals[l] == &cache.get(batch.elements[l]));
+	}
+
+	const double batched_energy = assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), cache, 0, 0, disp, disp);
+	assembler->set_use_element_batches(false);
+	const double energy = assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), cache, 0, 0, disp, disp);
+	REQUIRE(batched_energy == Catch::Approx(energy).epsilon(1e-12));
+}
+
+TEST_CASE("element_batch_benchmark", "[.][assembler][benchmark]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const int dim = state->mesh->dimension();
+
+	Eigen::MatrixXd disp(state->n_bases * dim, 1);
+	disp.setRandom();
+	disp *= 1e-2;
+
+	for (const std::string formulation : {"NeoHookean", "LinearElasticity"})
+	{
+		const auto assembler = AssemblerUtils::make_assembler(formulation);
+		assembler->set_size(dim);
+		assembler->add_multimaterial(0, json({{"E", 1e5}, {"nu", 0.3}}), state->units);
+
+		assembler->set_use_element_batches(false);
+		BENCHMARK(formulation + " energy (per element)")
+		{
+			return assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), state->ass_vals_cache, 0, 0, disp, disp);
+		};
+
+		assembler->set_use_element_batches(true);
+		BENCHMARK(formulation + " energy (batched)")
+		{
+			return assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), state->ass_vals_cache, 0, 0, disp, disp);
+		};
+	}
+}
+
+TEST_CASE("assembly_vals_cache_view_benchmark", "[.][assembler][benchmark]")
+{
+	const auto state = get_cached_state(2);
+	const bool is_volume = state->mesh->is_volume();
+	const AssemblyValsCache &cache = state->ass_vals_cache;
+	const int n_elements = state->bases.size();
+
+	long n_buffers = 0;
+	for (int e = 0; e < n_elements; ++e)
+		n_buffers += count_heap_buffers(cache.get(e));
+	logger().debug("heap buffers copied per assembly pass: {} with compute, 0 with get", n_buffers);
+
+	BENCHMARK("compute (copy)")
+	{
+		ElementAssemblyValues vals;
+		double res = 0;
+		for (int e = 0; e < n_elements; ++e)
+		{
+			cache.compute(e, is_volume, state->bases[e], state->geom_bases()[e], vals);
+			res += vals.det.sum();
+		}
+		return res;
+	};
+
+	BENCHMARK("get (view)")
+	{
+		ElementAssemblyValues tmp;
+		double res = 0;
+		for (int e = 0; e < n_elements; ++e)
+		{
+			const ElementAssemblyValues &vals = cache.get(e, is_volume, state->bases[e], state->geom_bases()[e], tmp);
+			res += vals.det.sum();
+		}
+		return res;
+	};
+
+	Eigen::MatrixXd disp(state->n_bases * 2, 1);
+	disp.setZero();
+	SparseMatrixCache mat_cache;
+	StiffnessMatrix hessian;
+
+	BENCHMARK("assemble_energy")
+	{
+		return state->assembler->assemble_energy(is_volume, state->bases, state->geom_bases(), cache, 0, 0, disp, disp);
+	};
+
+	BENCHMARK("assemble_hessian")
+	{
+		state->assembler->assemble_hessian(is_volume, state->n_bases, false, state->bases, state->geom_bases(), cache, 0, 0, disp, disp, mat_cache, hessian);
+		return hessian.nonZeros();
+	};
+}
@@ -16,18 +16,28 @@
 #include <polyfem/solver/forms/LaggedRegForm.hpp>
 #include <polyfem/solver/forms/RayleighDampingForm.hpp>
 #include <polyfem/solver/forms/adjoint_forms/AMIPSForm.hpp>
+#include <polyfem/solver/FullNLProblem.hpp>
+#include <polyfem/solver/NLProblem.hpp>
+#include <polyfem/solver/MatrixFreeNewton.hpp>
+#include <polyfem/solver/ModifiedNewton.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
 
 #include <polyfem/time_integrator/ImplicitEuler.hpp>
 
 #include <finitediff.hpp>
 
+#include <ipc/ipc.hpp>
+#include <igl/edges.h>
+
 #include <polyfem/State.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
 #include <iostream>
 #include <memory>
+#include <set>
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace polyfem;
@@ -194,6 +204,12 @@ void test_form(Form &form, const State &state, double step = 1e-8, double tol =
 			}
 
 			CHECK(fd::compare_gradient(grad, fgrad, tol));
+
+			// Test the fused evaluation against the separate ones
+			Eigen::VectorXd fused_grad;
+			const double fused_val = form.value_and_first_derivative(x, fused_grad);
+			CHECK(std::abs(fused_val - form.value(x)) <= 1e-10 * std::max(1.0, std::abs(fused_val)));
+			CHECK((fused_grad - grad).norm() <= 1e-10 * std::max(1.0, grad.norm()));
 		}
 
 		// Test hessian with finite differences
@@ -220,6 +236,15 @@ void test_form(Form &form, const State &state, double step = 1e-8, double tol =
 			}
 
 			CHECK(fd::compare_hessian(Eigen::MatrixXd(hess), fhess, tol));
+
+			// Test the matrix-free product against the assembled hessian
+			const Eigen::VectorXd v = Eigen::VectorXd::Random(x.size());
+			Eigen::VectorXd Hv;
+			form.hessian_vector_product(x, v, Hv);
+
+			const Eigen::VectorXd expected_Hv = hess * v;
+			REQUIRE(Hv.size() == expected_Hv.size());
+			CHECK((Hv - expected_Hv).norm() <= 1e-10 * std::max(1.0, expected_Hv.norm()));
 		}
 
 		x.setRandom();
@@ -300,6 +325,201 @@ TEST_CASE("contact form derivatives", "[form][form_derivatives][contact_form]")
 	test_form(form, *state_ptr);
 }
 
+namespace
+{
+	/// exposes the cached broad phase of the contact form
+	class CandidatesContactForm : public ContactForm
+	{
+	public:
+		using ContactForm::ContactForm;
+		using ContactForm::build_candidates;
+		using ContactForm::candidates_cover;
+
+		const ipc::Candidates &candidates() const { return candidates_; }
+	};
+
+	std::set<std::array<long, 3>> candidate_set(const ipc::Candidates &candidates)
+	{
+		std::set<std::array<long, 3>> out;
+		for (const auto &ev : candidates.ev_candidates)
+			out.insert({{0, long(ev.edge_id), long(ev.vertex_id)}});
+		for (const auto &ee : candidates.ee_candidates)
+			out.insert({{1, long(std::min(ee.edge0_id, ee.edge1_id)), long(std::max(ee.edge0_id, ee.edge1_id))}});
+		for (const auto &fv : candidates.fv_candidates)
+			out.insert({{2, long(fv.face_id), long(fv.vertex_id)}});
+		return out;
+	}
+} // namespace
+
+TEST_CASE("contact form reused candidates", "[form][contact_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+	const ipc::CollisionMesh &mesh = state_ptr->collision_mesh;
+
+	const double dhat = 1e-3;
+	const ipc::BroadPhaseMethod broad_phase_method = ipc::BroadPhaseMethod::HASH_GRID;
+	CandidatesContactForm form(
+		mesh, dhat, state_ptr->avg_mass,
+		/*use_convergent_formulation=*/false, /*use_adaptive_barrier_stiffness=*/false,
+		/*is_time_dependent=*/true, false, broad_phase_method, /*ccd_tolerance=*/1e-6,
+		/*ccd_max_iterations=*/static_cast<int>(1e6));
+
+	const Eigen::MatrixXd &rest = mesh.rest_positions();
+	const double scale = (rest.colwise().maxCoeff() - rest.colwise().minCoeff()).maxCoeff();
+
+	// a Newton step where a single vertex moves much more than the others
+	Eigen::MatrixXd V0 = rest + 1e-3 * scale * Eigen::MatrixXd::Random(rest.rows(), rest.cols());
+	Eigen::MatrixXd V1 = V0 + 1e-2 * scale * Eigen::MatrixXd::Random(rest.rows(), rest.cols());
+	V1.row(0).array() += 0.2 * scale;
+	form.build_candidates(V0, V1);
+
+	const std::set<std::array<long, 3>> cached = candidate_set(form.candidates());
+
+	// the following, shorter, steps of the solve
+	const double step = GENERATE(1e-4, 1e-3);
+	int n_covered = 0;
+	for (int i = 0; i < 20; ++i)
+	{
+		const Eigen::MatrixXd W0 = V0 + 0.5 * (V1 - V0) + step * scale * Eigen::MatrixXd::Random(rest.rows(), rest.cols());
+		const Eigen::MatrixXd W1 = W0 + step * scale * Eigen::MatrixXd::Random(rest.rows(), rest.cols());
+		if (!form.candidates_cover(W0, W1))
+			continue;
+		++n_covered;
+
+		ipc::Candidates fresh;
+		fresh.build(mesh, W0, W1, /*inflation_radius=*/dhat / 2, broad_phase_method);
+
+		for (const std::array<long, 3> &candidate : candidate_set(fresh))
+		{
+			CAPTURE(i, step, candidate[0], candidate[1], candidate[2]);
+			CHECK(cached.count(candidate) == 1);
+		}
+	}
+	CHECK(n_covered > 0);
+
+	// the fast vertex moving past the margin is not covered
+	Eigen::MatrixXd W1 = V1;
+	W1.row(0).array() += 0.2 * scale;
+	CHECK(!form.candidates_cover(V1, W1));
+}
+
+TEST_CASE("contact form collision free step size", "[form][contact_form]")
+{
+	const double tolerance = 1e-6;
+	const long max_iterations = static_cast<long>(1e6);
+	const ipc::BroadPhaseMethod broad_phase_method = ipc::BroadPhaseMethod::HASH_GRID;
+
+	// the chunked early-terminating CCD is never less conservative than the IPC toolkit one
+	const auto check_step = [&](const ipc::CollisionMesh &mesh, const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) {
+		ipc::Candidates candidates;
+		candidates.build(mesh, V0, V1, /*inflation_radius=*/0, broad_phase_method);
+
+		const double chunked = ContactForm::chunked_collision_free_stepsize(
+			candidates, mesh, V0, V1, /*min_distance=*/0, tolerance, max_iterations);
+		const double expected = ipc::compute_collision_free_stepsize(
+			mesh, V0, V1, broad_phase_method, /*min_distance=*/0, tolerance, max_iterations);
+
+		CAPTURE(chunked, expected);
+		CHECK(chunked <= expected + tolerance);
+		CHECK(chunked == Catch::Approx(expected).epsilon(1e-2).margin(tolerance));
+		return chunked;
+	};
+
+	SECTION("Known collision")
+	{
+		const int dim = GENERATE(2, 3);
+
+		Eigen::MatrixXd V0;
+		Eigen::MatrixXi E, F;
+		if (dim == 2)
+		{
+			// a horizontal segment falling on another one
+			V0.resize(4, 2);
+			V0 << -1, 0, 1, 0, -0.5, 1, 0.5, 1;
+			E.resize(2, 2);
+			E << 0, 1, 2, 3;
+		}
+		else
+		{
+			// a triangle falling on another one
+			V0.resize(6, 3);
+			V0 << -1, -1, 0, 1, -1, 0, 0, 1, 0,
+				-0.2, -0.2, 1, 0.2, -0.2, 1, 0, 0.2, 1;
+			F.resize(2, 3);
+			F << 0, 1, 2, 3, 4, 5;
+			igl::edges(F, E);
+		}
+		const ipc::CollisionMesh mesh(V0, E, F);
+
+		Eigen::MatrixXd V1 = V0;
+		V1.bottomRows(V0.rows() / 2).col(dim - 1).array() -= 2;
+
+		const double toi = check_step(mesh, V0, V1);
+		CHECK(toi > 0);
+		CHECK(toi < 0.5);
+	}
+
+	SECTION("Minimum distance")
+	{
+		const int dim = GENERATE(2, 3);
+		const double dmin = 1e-2;
+
+		// parallel primitives approaching from 2 dmin to dmin / 2 apart: they never touch, and their
+		// swept boxes only overlap once inflated by dmin / 2
+		Eigen::MatrixXd V0;
+		Eigen::MatrixXi E, F;
+		if (dim == 2)
+		{
+			V0.resize(4, 2);
+			V0 << -1, 0, 1, 0, -0.5, 2 * dmin, 0.5, 2 * dmin;
+			E.resize(2, 2);
+			E << 0, 1, 2, 3;
+		}
+		else
+		{
+			V0.resize(6, 3);
+			V0 << -1, -1, 0, 1, -1, 0, 0, 1, 0,
+				-0.2, -0.2, 2 * dmin, 0.2, -0.2, 2 * dmin, 0, 0.2, 2 * dmin;
+			F.resize(2, 3);
+			F << 0, 1, 2, 3, 4, 5;
+			igl::edges(F, E);
+		}
+		const ipc::CollisionMesh mesh(V0, E, F);
+
+		Eigen::MatrixXd V1 = V0;
+		V1.bottomRows(V0.rows() / 2).col(dim - 1).array() -= 1.5 * dmin;
+
+		const ContactForm form(
+			mesh, /*dhat=*/1e-3, /*avg_mass=*/1,
+			/*use_convergent_formulation=*/false, /*use_adaptive_barrier_stiffness=*/false,
+			/*is_time_dependent=*/false, false, broad_phase_method, tolerance, static_cast<int>(max_iterations), dmin);
+		const double step = form.max_step_size(
+			Eigen::VectorXd::Zero(V0.size()), utils::flatten(V1 - V0));
+		const double expected = ipc::compute_collision_free_stepsize(
+			mesh, V0, V1, broad_phase_method, dmin, tolerance, max_iterations);
+
+		// the primitives stop dmin apart, i.e., after 2/3 of the motion
+		CAPTURE(step, expected);
+		CHECK(expected < 1);
+		CHECK(step <= expected + tolerance);
+		CHECK(step == Catch::Approx(expected).epsilon(1e-2).margin(tolerance));
+	}
+
+	SECTION("Random motion")
+	{
+		const int dim = GENERATE(2, 3);
+		const auto state_ptr = get_state(dim);
+		const ipc::CollisionMesh &mesh = state_ptr->collision_mesh;
+
+		const Eigen::MatrixXd &V0 = mesh.rest_positions();
+		const double scale = (V0.colwise().maxCoeff() - V0.colwise().minCoeff()).maxCoeff();
+		const double amplitude = GENERATE(1e-3, 1e-2, 1e-1);
+		for (int i = 0; i < 5; ++i)
+			check_step(mesh, V0, V0 + amplitude * scale * Eigen::MatrixXd::Random(V0.rows(), V0.cols()));
+	}
+}
+
 TEST_CASE("elastic form derivatives", "[form][form_derivatives][elastic_form]")
 {
 	const int dim = GENERATE(2, 3);
@@ -399,6 +619,52 @@ TEST_CASE("inertia form derivatives", "[form][form_derivatives][inertia_form]")
 	InertiaForm form(state_ptr->mass, time_integrator);
 
 	test_form(form, *state_ptr);
+
+	const StiffnessMatrix lumped_mass = polyfem::utils::lump_matrix(state_ptr->mass);
+	InertiaForm lumped_form(lumped_mass, time_integrator);
+	CHECK(lumped_form.is_mass_lumped());
+
+	test_form(lumped_form, *state_ptr);
+}
+
+TEST_CASE("inertia form follows the time integrator", "[form][inertia_form]")
+{
+	const int n = 6;
+	const double dt = 0.1;
+
+	StiffnessMatrix mass(n, n);
+	mass.setIdentity();
+
+	ImplicitEuler time_integrator;
+	time_integrator.init(
+		Eigen::VectorXd::Zero(n), Eigen::VectorXd::Zero(n), Eigen::VectorXd::Zero(n), dt);
+
+	InertiaForm form(mass, time_integrator);
+	form.init(Eigen::VectorXd::Zero(n));
+	CHECK(form.is_mass_lumped());
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Ones(n);
+	CHECK(form.value(x) == Catch::Approx(0.5 * n));
+
+	// re-initializing the integrator without updating the form (e.g., after remeshing) must not use the old x_tilde
+	const Eigen::VectorXd x_prev = Eigen::VectorXd::LinSpaced(n, 0, 1);
+	const Eigen::VectorXd v_prev = Eigen::VectorXd::Constant(n, 2);
+	time_integrator.init(x_prev, v_prev, Eigen::VectorXd::Zero(n), dt);
+	CHECK(form.value(x) == Catch::Approx(0.5 * (x - time_integrator.x_tilde()).squaredNorm()));
+
+	time_integrator.update_quantities(x);
+	CHECK(form.value(x) == Catch::Approx(0.5 * (x - time_integrator.x_tilde()).squaredNorm()));
+
+	// the mass matrix is referenced, changing it to a consistent one disables the lumped path
+	mass.coeffRef(0, 1) = 0.5;
+	mass.coeffRef(1, 0) = 0.5;
+	form.update_quantities(0, x);
+	CHECK(!form.is_mass_lumped());
+
+	const Eigen::VectorXd dx = x - time_integrator.x_tilde();
+	Eigen::VectorXd grad;
+	form.first_derivative(x, grad);
+	CHECK((grad - mass * dx).norm() == Catch::Approx(0).margin(1e-12));
 }
 
 TEST_CASE("lagged regularization form derivatives", "[form][form_derivatives][lagged_reg_form]")
@@ -684,3 +950,302 @@ TEST_CASE("Fixed corotational form derivatives", "[form][form_derivatives][elast
 	form.update_quantities(0, Eigen::VectorXd::Ones(state_ptr->n_bases * dim));
 	test_form(form, *state_ptr, 1e-7, 1e-4);
 }
+
+namespace
+{
+	/// quadratic form counting its passes over the "elements"
+	class CountingForm : public Form
+	{
+	public:
+		std::string name() const override { return "counting"; }
+
+		mutable int n_value = 0, n_grad = 0, n_fused = 0, n_hess = 0;
+
+	protected:
+		double value_unweighted(const Eigen::VectorXd &x) const override
+		{
+			++n_value;
+			return 0.5 * x.squaredNorm();
+		}
+
+		void first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const override
+		{
+			++n_grad;
+			gradv = x;
+		}
+
+		double value_and_first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const override
+		{
+			++n_fused;
+			gradv = x;
+			return 0.5 * x.squaredNorm();
+		}
+
+		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override
+		{
+			++n_hess;
+			hessian.resize(x.size(), x.size());
+			hessian.setIdentity();
+		}
+	};
+} // namespace
+
+TEST_CASE("Newton iteration evaluates value and gradient in one pass", "[form][nl_problem]")
+{
+	auto form = std::make_shared<CountingForm>();
+	FullNLProblem problem(std::vector<std::shared_ptr<Form>>{form});
+
+	Eigen::VectorXd x = Eigen::VectorXd::Random(10);
+	Eigen::VectorXd grad;
+	StiffnessMatrix hessian;
+
+	problem.init(x);
+
+	// one Newton iteration: gradient and Hessian at x, then the value at x and at the trial points of the line search
+	problem.gradient(x, grad);
+	problem.hessian(x, hessian);
+	const double e0 = problem.value(x);
+	const Eigen::VectorXd rejected = x + grad;
+	CHECK(problem.value(rejected) > e0);
+	const Eigen::VectorXd x1 = x - 0.5 * grad;
+	const double e1 = problem.value(x1);
+	CHECK(e1 < e0);
+
+	// only the gradient is missing at the accepted point
+	problem.gradient(x1, grad);
+	CHECK((grad - x1).norm() == 0);
+
+	CHECK(form->n_fused == 1);
+	CHECK(form->n_value == 2);
+	CHECK(form->n_grad == 1);
+	CHECK(form->n_hess == 1);
+
+	// outside of a solve nothing is memoized nor fused
+	problem.finish();
+	problem.value(x);
+	problem.gradient(x, grad);
+	CHECK(form->n_fused == 1);
+	CHECK(form->n_value == 3);
+	CHECK(form->n_grad == 2);
+}
+
+namespace
+{
+	/// AL form without constrained nodes, only its penalty weight matters
+	class PenaltyWeightForm : public AugmentedLagrangianForm
+	{
+	public:
+		PenaltyWeightForm() : AugmentedLagrangianForm({}) { k_al_ = 1; }
+
+		std::string name() const override { return "penalty_weight"; }
+
+		void update_lagrangian(const Eigen::VectorXd &x, const double k_al) override { k_al_ = k_al; }
+		double compute_error(const Eigen::VectorXd &x) const override { return 0; }
+
+	protected:
+		double value_unweighted(const Eigen::VectorXd &x) const override { return 0.5 * k_al_ * x.squaredNorm(); }
+		void first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const override { gradv = k_al_ * x; }
+		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override
+		{
+			hessian.resize(x.size(), x.size());
+			hessian.setIdentity();
+			hessian *= k_al_;
+		}
+	};
+} // namespace
+
+TEST_CASE("NLProblem reuses the Hessian until the problem changes", "[form][nl_problem]")
+{
+	const int n = 10;
+	auto form = std::make_shared<CountingForm>();
+	auto penalty = std::make_shared<PenaltyWeightForm>();
+	NLProblem problem(n, std::vector<std::shared_ptr<Form>>{form, penalty}, {penalty});
+	problem.set_hessian_reuse(/*enabled=*/true, /*max_rate=*/0.5, /*max_reuses=*/10, /*across_solves=*/true);
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(n);
+	StiffnessMatrix hessian;
+
+	// a Newton iteration converging fast enough for the Hessian to be kept
+	double grad_norm = 1;
+	const auto newton_iteration = [&]() {
+		problem.hessian(x, hessian);
+		grad_norm /= 10;
+		problem.post_step(polysolve::nonlinear::PostStepData(1, json(), x, Eigen::VectorXd::Constant(n, grad_norm)));
+	};
+
+	problem.init(x);
+	newton_iteration();
+	newton_iteration();
+	REQUIRE(form->n_hess == 1);
+	REQUIRE(problem.n_reused_assemblies() == 1);
+	REQUIRE(problem.hessian_revision() == 1);
+
+	SECTION("Unchanged problem")
+	{
+		newton_iteration();
+		CHECK(form->n_hess == 1);
+		CHECK(problem.hessian_revision() == 1);
+	}
+	SECTION("No descent direction")
+	{
+		problem.invalidate_reused_hessian();
+		newton_iteration();
+		CHECK(form->n_hess == 2);
+		CHECK(problem.hessian_revision() == 2);
+	}
+	SECTION("Form weight (e.g., barrier stiffness)")
+	{
+		form->set_weight(2);
+		newton_iteration();
+		CHECK(form->n_hess == 2);
+	}
+	SECTION("AL penalty weight")
+	{
+		penalty->update_lagrangian(x, 10);
+		problem.init(x);
+		newton_iteration();
+		CHECK(form->n_hess == 2);
+	}
+	SECTION("Lagging")
+	{
+		problem.update_lagging(x, 1);
+		newton_iteration();
+		CHECK(form->n_hess == 2);
+	}
+	SECTION("Time step")
+	{
+		problem.update_quantities(1, x);
+		problem.init(x);
+		newton_iteration();
+		CHECK(form->n_hess == 1);
+
+		problem.set_hessian_reuse(/*enabled=*/true, /*max_rate=*/0.5, /*max_reuses=*/10, /*across_solves=*/false);
+		problem.init(x);
+		newton_iteration();
+		problem.update_quantities(2, x);
+		problem.init(x);
+		newton_iteration();
+		CHECK(form->n_hess == 3);
+	}
+	SECTION("Next solve")
+	{
+		problem.init(x);
+		newton_iteration();
+		CHECK(form->n_hess == 1);
+	}
+
+	// the Hessian handed out is always the one of the current problem
+	const Eigen::MatrixXd expected = (form->weight() + penalty->penalty_weight()) * Eigen::MatrixXd::Identity(n, n);
+	CHECK((Eigen::MatrixXd(hessian) - expected).norm() == Catch::Approx(0).margin(1e-12));
+}
+
+TEST_CASE("modified Newton reuses the factorization", "[form][nl_problem]")
+{
+	const int n = 10;
+	auto form = std::make_shared<CountingForm>();
+	auto penalty = std::make_shared<PenaltyWeightForm>();
+	NLProblem problem(n, std::vector<std::shared_ptr<Form>>{form, penalty}, {penalty});
+	problem.set_hessian_reuse(/*enabled=*/true, /*max_rate=*/0.5, /*max_reuses=*/10, /*across_solves=*/true);
+
+	ModifiedNewton strategy(
+		R"({"line_search": {"method": "Backtracking"}})"_json, R"({"solver": "Eigen::SimplicialLDLT"})"_json, 1, logger());
+	strategy.reset_times();
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(n);
+	Eigen::VectorXd grad, direction;
+
+	double grad_norm = 1;
+	const auto newton_iteration = [&]() {
+		problem.gradient(x, grad);
+		REQUIRE(strategy.compute_update_direction(problem, x, grad, direction));
+		// the Hessian is (1 + k_al) I
+		CHECK((direction + grad / (1 + penalty->penalty_weight())).norm() == Catch::Approx(0).margin(1e-12));
+		grad_norm /= 10;
+		problem.post_step(polysolve::nonlinear::PostStepData(1, json(), x, Eigen::VectorXd::Constant(n, grad_norm)));
+	};
+
+	problem.init(x);
+	for (int i = 0; i < 3; ++i)
+		newton_iteration();
+	CHECK(form->n_hess == 1);
+	CHECK(strategy.n_factorizations() == 1);
+	CHECK(strategy.n_saved_factorizations() == 2);
+
+	// a new Hessian is refactorized
+	penalty->update_lagrangian(x, 10);
+	problem.init(x);
+	newton_iteration();
+	CHECK(form->n_hess == 2);
+	CHECK(strategy.n_factorizations() == 2);
+
+	json info;
+	strategy.update_solver_info(info, 1);
+	CHECK(info["saved_factorizations"] == 2);
+}
+
+TEST_CASE("matrix-free Newton direction", "[form][nl_problem]")
+{
+	const int dim = GENERATE(2, 3);
+	const std::string method = GENERATE(std::string("CG"), std::string("GMRES"));
+
+	const auto state_ptr = get_state(dim);
+	const int ndof = state_ptr->n_bases * dim;
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases,
+		state_ptr->bases,
+		state_ptr->geom_bases(),
+		*state_ptr->assembler,
+		state_ptr->ass_vals_cache,
+		0,
+		state_ptr->args["time"]["dt"],
+		state_ptr->mesh->is_volume());
+
+	ImplicitEuler time_integrator;
+	time_integrator.init(
+		Eigen::VectorXd::Zero(ndof), Eigen::VectorXd::Zero(ndof), Eigen::VectorXd::Zero(ndof),
+		state_ptr->args["time"]["dt"]);
+	auto inertia_form = std::make_shared<InertiaForm>(state_ptr->mass, time_integrator);
+
+	auto bc_form = std::make_shared<BCLagrangianForm>(
+		ndof, state_ptr->boundary_nodes, state_ptr->mass, state_ptr->obstacle.ndof(), Eigen::MatrixXd::Zero(ndof, 1));
+
+	NLProblem problem(ndof, nullptr, 0, {elastic_form, inertia_form, bc_form}, {bc_form});
+
+	const Eigen::VectorXd x = problem.full_to_reduced(Eigen::VectorXd::Random(ndof) / 100);
+	problem.init(x);
+	problem.solution_changed(x);
+
+	Eigen::VectorXd grad;
+	problem.gradient(x, grad);
+	StiffnessMatrix hessian;
+	problem.hessian(x, hessian);
+
+	// the product in reduced coordinates matches the assembled reduced Hessian
+	const Eigen::VectorXd v = Eigen::VectorXd::Random(x.size());
+	Eigen::VectorXd Hv;
+	problem.hessian_vector_product(x, v, Hv);
+	const Eigen::VectorXd expected_Hv = hessian * v;
+	REQUIRE(Hv.size() == expected_Hv.size());
+	CHECK((Hv - expected_Hv).norm() <= 1e-10 * std::max(1.0, expected_Hv.norm()));
+
+	// the Krylov direction matches a direct solve with the assembled Hessian
+	Eigen::SimplicialLDLT<StiffnessMatrix> solver(hessian);
+	REQUIRE(solver.info() == Eigen::Success);
+	const Eigen::VectorXd expected_direction = solver.solve(-grad);
+
+	const json krylov_params = {
+		{"solver", method},
+		{"max_iterations", 10 * x.size()},
+		{"restart", 50},
+		{"max_forcing", 1e-10}};
+	MatrixFreeNewton strategy(json::object(), krylov_params, 1, logger());
+	strategy.reset(x.size());
+
+	Eigen::VectorXd direction;
+	REQUIRE(strategy.compute_update_direction(problem, x, grad, direction));
+	CHECK((direction - expected_direction).norm() <= 1e-6 * expected_direction.norm());
+	CHECK(direction.dot(grad) < 0);
+
+	problem.finish();
+}
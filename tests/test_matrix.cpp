@@ -247,3 +247,27 @@ TEST_CASE("cache", "[matrix]")
 	REQUIRE(tmp2.coeff(9, 4) == 6);
 	REQUIRE(tmp2.coeff(9, 9) == 4);
 }
+
+TEST_CASE("add_to_sparse_pattern", "[matrix]")
+{
+	std::vector<Eigen::Triplet<double>> entries = {{0, 0, 1}, {1, 1, 2}, {2, 1, 3}, {2, 2, 4}};
+	StiffnessMatrix dst(3, 3);
+	dst.setFromTriplets(entries.begin(), entries.end());
+
+	StiffnessMatrix src(3, 3);
+	entries = {{1, 1, 1}, {2, 2, 1}};
+	src.setFromTriplets(entries.begin(), entries.end());
+
+	REQUIRE(add_to_sparse_pattern(src, 2, dst));
+	REQUIRE(dst.nonZeros() == 4);
+	REQUIRE(dst.coeff(1, 1) == 4);
+	REQUIRE(dst.coeff(2, 2) == 6);
+	REQUIRE(dst.coeff(2, 1) == 3);
+
+	// an entry outside of the pattern leaves dst untouched
+	entries = {{1, 1, 1}, {0, 2, 1}};
+	src.setFromTriplets(entries.begin(), entries.end());
+
+	REQUIRE(!add_to_sparse_pattern(src, 1, dst));
+	REQUIRE(dst.coeff(1, 1) == 4);
+}
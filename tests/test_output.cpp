@@ -1,13 +1,24 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <catch2/catch_approx.hpp>
 
 #include <polyfem/State.hpp>
 #include <polyfem/Common.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
+#include <polyfem/io/Checkpoint.hpp>
+#include <polyfem/io/OutputQueue.hpp>
+#include <polyfem/io/Evaluator.hpp>
+#include <polyfem/utils/RefElementSampler.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace polyfem;
@@ -82,3 +93,269 @@ TEST_CASE("full sim", "[.][full_sim]")
 
 	std::filesystem::remove_all(outdir);
 }
+
+TEST_CASE("output queue", "[output]")
+{
+	const int n_threads = GENERATE(1, 3);
+	std::atomic<int> done = 0;
+
+	{
+		io::OutputQueue queue(n_threads, 2);
+		CHECK(queue.n_threads() == n_threads);
+
+		for (int i = 0; i < 100; ++i)
+			queue.push([&done]() { ++done; });
+		queue.flush();
+		CHECK(done == 100);
+
+		queue.push([]() { throw std::runtime_error("failed write"); });
+		CHECK_THROWS_AS(queue.flush(), std::runtime_error);
+		// the error is reported only once
+		CHECK_NOTHROW(queue.flush());
+
+		for (int i = 0; i < 10; ++i)
+			queue.push([&done]() { ++done; });
+		// the destructor waits for the pending jobs
+	}
+
+	CHECK(done == 110);
+
+	// a failed write is also reported by the next push, which does not queue its job
+	{
+		io::OutputQueue queue(1, 2);
+		std::atomic<bool> next_started = false;
+		queue.push([]() { throw std::runtime_error("failed write"); });
+		// with one worker the failure is recorded before the next job starts
+		queue.push([&next_started]() { next_started = true; });
+		while (!next_started)
+			std::this_thread::yield();
+
+		CHECK_THROWS_AS(queue.push([&done]() { ++done; }), std::runtime_error);
+		CHECK_NOTHROW(queue.flush());
+	}
+
+	CHECK(done == 110);
+}
+
+TEST_CASE("vis interpolation matrix", "[output]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["space"] = {};
+	in_args["space"]["discr_order"] = GENERATE(1, 2);
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	const mesh::Mesh &mesh = *state.mesh;
+	const int dim = mesh.dimension();
+
+	utils::RefElementSampler sampler;
+	sampler.init(mesh.is_volume(), mesh.n_elements(), 0.01);
+	const int n_points = mesh.n_elements() * sampler.simplex_points().rows();
+
+	StiffnessMatrix interpolation;
+	io::Evaluator::interpolation_matrix(
+		mesh, state.bases, state.disc_orders, state.polys, state.polys_3d,
+		sampler, n_points, state.n_bases, interpolation, /*use_sampler=*/true, /*boundary_only=*/false);
+	CHECK(interpolation.rows() == n_points);
+	CHECK(interpolation.cols() == state.n_bases);
+
+	const Eigen::MatrixXd sol = Eigen::VectorXd::Random(state.n_bases * dim);
+
+	Eigen::MatrixXd expected;
+	io::Evaluator::interpolate_function(
+		mesh, dim, state.bases, state.disc_orders, state.polys, state.polys_3d,
+		sampler, n_points, sol, expected, /*use_sampler=*/true, /*boundary_only=*/false);
+
+	const Eigen::MatrixXd actual = interpolation * utils::unflatten(sol, dim);
+	CHECK((actual - expected).norm() == Catch::Approx(0).margin(1e-10));
+}
+
+TEST_CASE("parallel evaluator", "[output]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["space"] = {};
+	in_args["space"]["discr_order"] = GENERATE(1, 2);
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	const mesh::Mesh &mesh = *state.mesh;
+	const int dim = mesh.dimension();
+
+	utils::RefElementSampler sampler;
+	sampler.init(mesh.is_volume(), mesh.n_elements(), 0.01);
+	const int n_points = mesh.n_elements() * sampler.simplex_points().rows();
+
+	const Eigen::MatrixXd sol = Eigen::VectorXd::Random(state.n_bases * dim);
+
+	struct Outputs
+	{
+		Eigen::MatrixXd interpolated;
+		std::vector<assembler::Assembler::NamedMatrix> scalar, tensor, avg_scalar, avg_tensor;
+		Eigen::MatrixXd stress;
+		Eigen::VectorXd von_mises;
+	};
+
+	const auto evaluate = [&](const int n_threads) {
+		state.set_max_threads(n_threads);
+
+		Outputs out;
+		io::Evaluator::interpolate_function(
+			mesh, dim, state.bases, state.disc_orders, state.polys, state.polys_3d,
+			sampler, n_points, sol, out.interpolated, /*use_sampler=*/true, /*boundary_only=*/false);
+		io::Evaluator::compute_scalar_value(
+			mesh, /*is_problem_scalar=*/false, state.bases, state.geom_bases(), state.disc_orders, state.polys, state.polys_3d,
+			*state.assembler, sampler, n_points, sol, /*t=*/0, out.scalar, /*use_sampler=*/true, /*boundary_only=*/false);
+		io::Evaluator::compute_tensor_value(
+			mesh, /*is_problem_scalar=*/false, state.bases, state.geom_bases(), state.disc_orders, state.polys, state.polys_3d,
+			*state.assembler, sampler, n_points, sol, /*t=*/0, out.tensor, /*use_sampler=*/true, /*boundary_only=*/false);
+		// the per-vertex averages are accumulated across elements
+		io::Evaluator::average_grad_based_function(
+			mesh, /*is_problem_scalar=*/false, state.n_bases, state.bases, state.geom_bases(), state.disc_orders, state.polys, state.polys_3d,
+			*state.assembler, sampler, /*t=*/0, n_points, sol, out.avg_scalar, out.avg_tensor, /*use_sampler=*/true, /*boundary_only=*/false);
+		io::Evaluator::compute_stress_at_quadrature_points(
+			mesh, /*is_problem_scalar=*/false, state.bases, state.geom_bases(), state.disc_orders,
+			*state.assembler, sol, /*t=*/0, out.stress, out.von_mises);
+		return out;
+	};
+
+	const auto check_identical = [](const std::vector<assembler::Assembler::NamedMatrix> &a, const std::vector<assembler::Assembler::NamedMatrix> &b) {
+		REQUIRE(a.size() == b.size());
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			CAPTURE(a[i].first);
+			CHECK(a[i].first == b[i].first);
+			CHECK(a[i].second == b[i].second);
+		}
+	};
+
+	const Outputs serial = evaluate(1);
+	const Outputs parallel = evaluate(std::max(2u, std::thread::hardware_concurrency()));
+	state.set_max_threads(1);
+
+	// bitwise identical, not only up to round-off
+	CHECK(serial.interpolated.rows() == n_points);
+	CHECK(parallel.interpolated == serial.interpolated);
+	check_identical(parallel.scalar, serial.scalar);
+	check_identical(parallel.tensor, serial.tensor);
+	CHECK(!serial.avg_scalar.empty());
+	check_identical(parallel.avg_scalar, serial.avg_scalar);
+	check_identical(parallel.avg_tensor, serial.avg_tensor);
+	CHECK(parallel.stress == serial.stress);
+	CHECK(parallel.von_mises == serial.von_mises);
+}
+
+TEST_CASE("checkpoint", "[output]")
+{
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "polyfem_checkpoint_test";
+	std::filesystem::create_directories(dir);
+	const std::string path0 = (dir / "state_0.ckpt").string();
+	const std::string path1 = (dir / "state_1.ckpt").string();
+	const std::string path2 = (dir / "state_2.ckpt").string();
+
+	// time integrator history: every step shifts the columns by one
+	Eigen::MatrixXd u0 = Eigen::MatrixXd::Random(100, 3);
+	Eigen::MatrixXd u1(100, 3), u2(100, 3);
+	u1 << Eigen::VectorXd::Random(100), u0.leftCols(2);
+	u2 << Eigen::VectorXd::Random(100), u1.leftCols(2);
+	const Eigen::MatrixXi F = Eigen::MatrixXi::Random(10, 3);
+
+	io::Checkpoint c0, c1, c2;
+	c0.set_columns("u", u0);
+	c0.set("F", F);
+	c0.set("k", 1.0);
+	c0.save(path0);
+	CHECK(c0.saved_bytes() == 8 * (u0.size() + 1) + 4 * (F.size() + 2));
+
+	c1.set_columns("u", u1);
+	c1.set("F", F);
+	c1.set("k", 2.0);
+	c1.save(path1, &c0, path0);
+	// only the new column and the changed scalar are written
+	CHECK(c1.saved_bytes() == 8 * (u1.rows() + 1));
+
+	c2.set_columns("u", u2);
+	c2.set("F", F);
+	c2.set("k", 2.0);
+	c2.save(path2, &c1, path1);
+	CHECK(c2.saved_bytes() == 8 * u2.rows());
+
+	CHECK(io::Checkpoint::has_checkpoint_extension(path2));
+	CHECK(io::Checkpoint::is_checkpoint(path2));
+	CHECK(!io::Checkpoint::is_checkpoint(std::string(POLYFEM_DATA_DIR) + "/plane_hole.obj"));
+
+	{
+		io::Checkpoint loaded;
+		loaded.load(path2);
+		CHECK(loaded.has("F"));
+		CHECK(!loaded.has("v"));
+
+		Eigen::MatrixXd u;
+		Eigen::MatrixXi f;
+		double k;
+		REQUIRE(loaded.get_columns("u", u));
+		REQUIRE(loaded.get("F", f));
+		REQUIRE(loaded.get("k", k));
+		CHECK(u == u2);
+		CHECK(f == F);
+		CHECK(k == 2.0);
+		// wrong type
+		CHECK(!loaded.get("k", f));
+	}
+
+	// corrupt the first column of the first checkpoint, referenced by the last one through the second
+	{
+		std::fstream file(path0, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekg(-8 * u0.size(), std::ios::end);
+		const char byte = file.get();
+		file.seekp(-8 * u0.size(), std::ios::end);
+		file.put(~byte);
+	}
+	{
+		io::Checkpoint loaded;
+		loaded.load(path2);
+		Eigen::MatrixXd u;
+		CHECK_THROWS(loaded.get_columns("u", u));
+	}
+
+	// a corrupted string size in the header is rejected before anything is allocated
+	{
+		std::fstream file(path1, std::ios::in | std::ios::out | std::ios::binary);
+		const uint32_t size = 0xfffffff0;
+		file.seekp(sizeof(uint64_t) + sizeof(uint32_t)); // magic and version, then the base path
+		file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+	}
+	{
+		io::Checkpoint loaded;
+		CHECK_THROWS(loaded.load(path1));
+	}
+
+	std::filesystem::remove_all(dir);
+}
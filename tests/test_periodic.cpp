@@ -10,6 +10,8 @@
 #include <polyfem/io/Evaluator.hpp>
 
 #include <polyfem/solver/AdjointNLProblem.hpp>
+#include <polyfem/solver/NLProblem.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
 
 #include <polyfem/solver/forms/adjoint_forms/SpatialIntegralForms.hpp>
 #include <polyfem/solver/forms/adjoint_forms/SumCompositeForm.hpp>
@@ -139,8 +141,112 @@ namespace
 		std::cout << std::setprecision(12) << "relative error: " << abs((finite_difference - derivative) / derivative) << "\n";
 		REQUIRE(derivative == Catch::Approx(finite_difference).epsilon(tol));
 	}
+
+	/// fixes the given (periodic) dofs to zero
+	class FixedDofsForm : public AugmentedLagrangianForm
+	{
+	public:
+		FixedDofsForm(const std::vector<int> &constraint_nodes) : AugmentedLagrangianForm(constraint_nodes) {}
+
+		std::string name() const override { return "fixed-dofs"; }
+		void update_lagrangian(const Eigen::VectorXd &x, const double k_al) override {}
+		double compute_error(const Eigen::VectorXd &x) const override { return 0; }
+
+	protected:
+		double value_unweighted(const Eigen::VectorXd &x) const override { return 0; }
+		void first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const override { gradv.setZero(x.size()); }
+		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override { hessian.resize(x.size(), x.size()); }
+	};
+
+	/// compares the precomputed reduction maps of NLProblem with the generic periodic/Dirichlet path they replaced
+	void check_reduction(const int full_size, const std::shared_ptr<utils::PeriodicBoundary> &periodic_bc)
+	{
+		const int mid_size = periodic_bc ? periodic_bc->n_periodic_dof() : full_size;
+
+		std::vector<int> constraint_nodes;
+		for (int i = 0; i < mid_size; i += 7)
+			constraint_nodes.push_back(i);
+		const int reduced_size = mid_size - constraint_nodes.size();
+
+		NLProblem problem(full_size, periodic_bc, 0, {}, {std::make_shared<FixedDofsForm>(constraint_nodes)});
+		REQUIRE(problem.reduced_size() == reduced_size);
+
+		const auto drop_constrained = [&](const Eigen::MatrixXd &mid) {
+			Eigen::VectorXd reduced(reduced_size);
+			for (int i = 0, j = 0, k = 0; i < mid.rows(); ++i)
+			{
+				if (k < constraint_nodes.size() && constraint_nodes[k] == i)
+					++k;
+				else
+					reduced(j++) = mid(i);
+			}
+			return reduced;
+		};
+
+		// gather and scatter
+		const Eigen::VectorXd full = Eigen::VectorXd::Random(full_size);
+		const Eigen::VectorXd reduced = problem.full_to_reduced(full);
+		CHECK(reduced == drop_constrained(periodic_bc ? periodic_bc->full_to_periodic(full, false) : Eigen::MatrixXd(full)));
+		CHECK(problem.full_to_reduced_grad(full) == drop_constrained(periodic_bc ? periodic_bc->full_to_periodic(full, true) : Eigen::MatrixXd(full)));
+
+		Eigen::MatrixXd mid = Eigen::MatrixXd::Zero(mid_size, 1);
+		for (int i = 0, j = 0, k = 0; i < mid_size; ++i)
+		{
+			if (k < constraint_nodes.size() && constraint_nodes[k] == i)
+				++k;
+			else
+				mid(i) = reduced(j++);
+		}
+		CHECK(problem.reduced_to_full(reduced) == (periodic_bc ? periodic_bc->periodic_to_full(full_size, mid) : mid));
+
+		// Hessians of the full shape and of an extended one (e.g., macro strain), reduced alternately
+		for (int iter = 0; iter < 2; ++iter)
+		{
+			for (const int n_extra : {0, 4})
+			{
+				const int n = full_size + n_extra;
+				std::vector<Eigen::Triplet<double>> entries;
+				for (int i = 0; i < n; ++i)
+				{
+					entries.emplace_back(i, i, 1 + iter);
+					const int j = std::rand() % n;
+					entries.emplace_back(i, j, 0.5);
+					entries.emplace_back(j, i, 0.5);
+				}
+				StiffnessMatrix full_hessian(n, n);
+				full_hessian.setFromTriplets(entries.begin(), entries.end());
+				full_hessian.makeCompressed();
+
+				StiffnessMatrix reduced_hessian;
+				problem.full_hessian_to_reduced_hessian(full_hessian, reduced_hessian);
+
+				StiffnessMatrix mid_hessian = full_hessian, expected;
+				if (periodic_bc)
+					periodic_bc->full_to_periodic(mid_hessian);
+				utils::full_to_reduced_matrix(mid_hessian.rows(), mid_hessian.rows() - constraint_nodes.size(), constraint_nodes, mid_hessian, expected);
+
+				REQUIRE(reduced_hessian.rows() == expected.rows());
+				CHECK((Eigen::MatrixXd(reduced_hessian) - Eigen::MatrixXd(expected)).norm() == Catch::Approx(0).margin(1e-12));
+			}
+		}
+	}
 } // namespace
 
+TEST_CASE("nl-problem-reduction-maps", "[periodic]")
+{
+	const std::string path = POLYFEM_DATA_DIR + std::string("/differentiable/input/");
+	json in_args;
+	load_json(path + "homogenize-stress-periodic.json", in_args);
+	auto state_ptr = AdjointOptUtils::create_state(in_args, solver::CacheLevel::Derivatives, -1);
+	const State &state = *state_ptr;
+	REQUIRE(state.periodic_bc);
+
+	const int full_size = state.n_bases * state.mesh->dimension();
+
+	SECTION("dirichlet") { check_reduction(full_size, nullptr); }
+	SECTION("periodic") { check_reduction(full_size, state.periodic_bc); }
+}
+
 
 TEST_CASE("homogenize-stress-periodic", "[test_adjoint]")
 {
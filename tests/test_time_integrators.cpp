@@ -1,10 +1,13 @@
 #include <polyfem/time_integrator/ImplicitEuler.hpp>
 #include <polyfem/time_integrator/ImplicitNewmark.hpp>
 #include <polyfem/time_integrator/BDF.hpp>
+#include <polyfem/time_integrator/CentralDifference.hpp>
+#include <polyfem/State.hpp>
 
 #include <finitediff.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
 #include <iostream>
@@ -13,6 +16,10 @@
 using namespace polyfem;
 using namespace polyfem::time_integrator;
 
+// defined in test_restart.cpp
+json load_sim_json(const std::string filename, const int time_steps);
+Eigen::MatrixXd run_sim(State &state, const json &args);
+
 TEST_CASE("time integrator", "[time_integrator]")
 {
 	const double dt = GENERATE(0.1, 0.01, 0.001);
@@ -44,6 +51,11 @@ TEST_CASE("time integrator", "[time_integrator]")
 	        "steps": 2
 	    })"_json;
 	}
+	SECTION("Central Difference")
+	{
+		time_integrator = std::make_shared<CentralDifference>();
+		params = R"({})"_json;
+	}
 
 	time_integrator->init(x_prev, v_prev, a_prev, dt);
 
@@ -100,4 +112,121 @@ TEST_CASE("time integrator", "[time_integrator]")
 		x.setRandom();
 		x /= 100;
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("central difference", "[time_integrator]")
+{
+	// Undamped oscillator m ẍ = -k x
+	const double m = 2, k = 50;
+	Eigen::VectorXd lumped_mass(1);
+	lumped_mass << m;
+	StiffnessMatrix stiffness(1, 1);
+	stiffness.insert(0, 0) = k;
+
+	const double critical_dt = CentralDifference::critical_time_step(lumped_mass, stiffness);
+	CHECK(critical_dt == Catch::Approx(2 / std::sqrt(k / m)));
+
+	const double dt = GENERATE(0.5, 0.1);
+
+	CentralDifference time_integrator;
+	Eigen::VectorXd x0(1), v0(1), a0(1);
+	x0 << 1;
+	v0 << 0;
+	a0 << -k / m * x0[0];
+	time_integrator.init(x0, v0, a0, dt);
+
+	const int n_substeps = time_integrator.n_substeps(dt, critical_dt);
+	CHECK(dt / n_substeps <= time_integrator.cfl() * critical_dt);
+
+	time_integrator.init(x0, v0, a0, dt / n_substeps);
+	for (int i = 0; i < 100 * n_substeps; ++i)
+	{
+		const Eigen::VectorXd x = time_integrator.x_tilde();
+		time_integrator.update_quantities(x, -k / m * x);
+	}
+
+	// The sub-stepped scheme is stable: the energy stays bounded by the initial one
+	const double energy = 0.5 * m * time_integrator.v_prev().squaredNorm() + 0.5 * k * time_integrator.x_prev().squaredNorm();
+	CHECK(energy <= 0.5 * k * (1 + 1e-8));
+	CHECK(energy >= 0.25 * k);
+
+	// Too many sub-steps is an error, not a silently unstable step
+	json params;
+	params["max_substeps"] = 2;
+	time_integrator.set_parameters(params);
+	CHECK_THROWS(time_integrator.n_substeps(100 * critical_dt, critical_dt));
+}
+
+TEST_CASE("central difference lumped mass", "[time_integrator]")
+{
+	// Consistent mass of a P2 triangle of unit area, the vertex rows sum to zero
+	Eigen::MatrixXd element_mass(6, 6);
+	element_mass << 6, -1, -1, 0, -4, 0,
+		-1, 6, -1, 0, 0, -4,
+		-1, -1, 6, -4, 0, 0,
+		0, 0, -4, 32, 16, 16,
+		-4, 0, 0, 16, 32, 16,
+		0, -4, 0, 16, 16, 32;
+	element_mass /= 180;
+
+	const int dim = GENERATE(1, 2);
+	Eigen::MatrixXd dense_mass = Eigen::MatrixXd::Zero(6 * dim, 6 * dim);
+	for (int d = 0; d < dim; ++d)
+		for (int i = 0; i < 6; ++i)
+			for (int j = 0; j < 6; ++j)
+				dense_mass(i * dim + d, j * dim + d) = element_mass(i, j);
+	const StiffnessMatrix mass = dense_mass.sparseView();
+
+	CHECK((dense_mass.rowwise().sum().array() <= 1e-12).any());
+
+	const Eigen::VectorXd lumped_mass = CentralDifference::lumped_mass(mass, dim);
+	CHECK((lumped_mass.array() > 0).all());
+	for (int d = 0; d < dim; ++d)
+	{
+		double total = 0;
+		for (int i = d; i < lumped_mass.size(); i += dim)
+			total += lumped_mass[i];
+		CHECK(total == Catch::Approx(1));
+	}
+
+	// A mass matrix with an empty row cannot be integrated explicitly
+	StiffnessMatrix singular_mass(2, 2);
+	singular_mass.insert(0, 0) = 1;
+	CHECK_THROWS(CentralDifference::lumped_mass(singular_mass, 1));
+}
+
+#ifdef NDEBUG
+TEST_CASE("time step predictor", "[time_integrator][predictor]")
+#else
+TEST_CASE("time step predictor", "[.][time_integrator][predictor]")
+#endif
+{
+	const std::string scene_file = POLYFEM_DATA_DIR "/contact/examples/3D/unit-tests/2-cubes.json";
+	const std::string predictor = GENERATE("linear", "quadratic", "x_tilde");
+
+	const auto total_iterations = [](const State &state) {
+		int iterations = 0;
+		for (const json &solve : state.stats.solver_info)
+		{
+			if (solve["info"].is_object())
+				iterations += solve["info"].value("iterations", 0);
+		}
+		return iterations;
+	};
+
+	json args = load_sim_json(scene_file, 10);
+
+	State state;
+	args["/time/predictor"_json_pointer] = "previous";
+	const Eigen::MatrixXd previous_sol = run_sim(state, args);
+	const int previous_iterations = total_iterations(state);
+
+	args["/time/predictor"_json_pointer] = predictor;
+	const Eigen::MatrixXd predicted_sol = run_sim(state, args);
+	const int predicted_iterations = total_iterations(state);
+
+	// same trajectory, reached with fewer Newton iterations
+	CAPTURE(predictor, previous_iterations, predicted_iterations);
+	CHECK(predicted_sol.isApprox(previous_sol, 1e-3));
+	CHECK(predicted_iterations <= previous_iterations);
+}
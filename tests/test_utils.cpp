@@ -4,13 +4,18 @@
 #include <polyfem/utils/Bessel.hpp>
 #include <polyfem/utils/ExpressionValue.hpp>
 #include <polyfem/io/MshReader.hpp>
+#include <polyfem/io/MshWriter.hpp>
 #include <polyfem/mesh/Mesh.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <wmtk/TriMesh.h>
 
 #include <Eigen/Dense>
 
+#include <filesystem>
+#include <fstream>
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 ////////////////////////////////////////////////////////////////////////////////
@@ -107,6 +112,50 @@ TEST_CASE("expression", "[utils]")
 	REQUIRE(val(2, 3, 4) == Catch::Approx(1).margin(1e-16));
 }
 
+TEST_CASE("expression_evaluate", "[utils]")
+{
+	utils::ExpressionValue expr;
+	expr.init(json("x^2+y*t-sin(z)"));
+	expr.set_unit_type("");
+
+	utils::ExpressionValue scaled;
+	scaled.init(json({{"value", "x*t+y"}, {"unit", "mm"}}));
+	scaled.set_unit_type("m");
+
+	utils::ExpressionValue val;
+	val.init(json(2.5));
+	val.set_unit_type("");
+
+	const double t = 0.3;
+	const Eigen::MatrixXd pts = Eigen::MatrixXd::Random(100, 3);
+	Eigen::VectorXd out;
+
+	expr.evaluate(pts, t, out);
+	REQUIRE(out.size() == pts.rows());
+	for (int i = 0; i < pts.rows(); ++i)
+		REQUIRE(out(i) == Catch::Approx(expr(pts(i, 0), pts(i, 1), pts(i, 2), t)).margin(1e-14));
+
+	scaled.evaluate(pts, t, out);
+	for (int i = 0; i < pts.rows(); ++i)
+	{
+		REQUIRE(out(i) == Catch::Approx(scaled(pts(i, 0), pts(i, 1), pts(i, 2), t)).margin(1e-14));
+		REQUIRE(out(i) == Catch::Approx((pts(i, 0) * t + pts(i, 1)) * 1e-3).margin(1e-14));
+	}
+
+	val.evaluate(pts.leftCols(2), t, out);
+	REQUIRE(out.size() == pts.rows());
+	REQUIRE((out.array() == 2.5).all());
+
+	// copies and concurrent evaluations share the compiled expression
+	const utils::ExpressionValue copy = expr;
+	Eigen::VectorXd parallel(pts.rows());
+	utils::maybe_parallel_for(pts.rows(), [&](int i) {
+		parallel(i) = copy(pts(i, 0), pts(i, 1), pts(i, 2), t);
+	});
+	expr.evaluate(pts, t, out);
+	REQUIRE((parallel - out).norm() == Catch::Approx(0).margin(1e-14));
+}
+
 TEST_CASE("mshreader", "[utils]")
 {
 	const std::string path = POLYFEM_DATA_DIR;
@@ -116,6 +165,194 @@ TEST_CASE("mshreader", "[utils]")
 	REQUIRE(mesh);
 }
 
+TEST_CASE("mshreader_binary", "[utils]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	Eigen::MatrixXd vertices;
+	Eigen::MatrixXi cells;
+	std::vector<std::vector<int>> elements;
+	std::vector<std::vector<double>> weights;
+	std::vector<int> body_ids;
+	REQUIRE(MshReader::load(path + "/circle2.msh", vertices, cells, elements, weights, body_ids));
+
+	// the binary file is streamed directly into the arrays, the ASCII one is loaded through mshio
+	const std::filesystem::path binary_path = std::filesystem::current_path() / "DELETE_ME_binary.msh";
+	const std::filesystem::path ascii_path = std::filesystem::current_path() / "DELETE_ME_ascii.msh";
+	MshWriter::write(binary_path.string(), vertices, cells, body_ids, /*is_volume=*/false, /*binary=*/true);
+	MshWriter::write(ascii_path.string(), vertices, cells, body_ids, /*is_volume=*/false, /*binary=*/false);
+
+	Eigen::MatrixXd binary_vertices, ascii_vertices;
+	Eigen::MatrixXi binary_cells, ascii_cells;
+	std::vector<std::vector<int>> binary_elements, ascii_elements;
+	std::vector<int> binary_body_ids, ascii_body_ids;
+	REQUIRE(MshReader::load(binary_path.string(), binary_vertices, binary_cells, binary_elements, weights, binary_body_ids));
+	REQUIRE(MshReader::load(ascii_path.string(), ascii_vertices, ascii_cells, ascii_elements, weights, ascii_body_ids));
+
+	CHECK(binary_vertices == ascii_vertices);
+	CHECK(binary_cells == ascii_cells);
+	CHECK(binary_elements == ascii_elements);
+	CHECK(binary_body_ids == ascii_body_ids);
+
+	CHECK(binary_vertices == vertices);
+	CHECK(binary_cells == cells);
+
+	// make sure the binary file did not go through the mshio fallback
+	CHECK(MshReader::load_binary_msh41(binary_path.string(), false, binary_vertices, binary_cells, binary_elements, weights, binary_body_ids));
+	CHECK(binary_vertices == vertices);
+	CHECK(!MshReader::load_binary_msh41(ascii_path.string(), false, ascii_vertices, ascii_cells, ascii_elements, weights, ascii_body_ids));
+	CHECK(ascii_vertices.size() == 0);
+
+	std::filesystem::remove(binary_path);
+	std::filesystem::remove(ascii_path);
+}
+
+namespace
+{
+	template <typename T>
+	void write_binary(std::ostream &out, const T &value)
+	{
+		out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	void write_binary(std::ostream &out, const std::vector<T> &values)
+	{
+		for (const T &value : values)
+			write_binary(out, value);
+	}
+
+	/// two tets with different physical groups, sparse node tags, and a parametric node block
+	/// @param n_physical_tags number of physical tags written for the volumes (the file has one)
+	void write_binary_tets(const std::filesystem::path &path, const size_t n_physical_tags = 1)
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << "$MeshFormat\n4.1 1 8\n";
+		write_binary(out, int(1));
+		out << "\n$EndMeshFormat\n";
+
+		out << "$PhysicalNames\n2\n3 11 \"left\"\n3 22 \"right\"\n$EndPhysicalNames\n";
+
+		// no points nor curves, one surface, two volumes
+		out << "$Entities\n";
+		write_binary(out, std::vector<size_t>{0, 0, 1, 2});
+		write_binary(out, int(1));
+		write_binary(out, std::vector<double>{0, 0, 0, 1, 1, 0});
+		write_binary(out, size_t(0));
+		write_binary(out, size_t(0));
+		for (const int tag : {1, 2})
+		{
+			write_binary(out, tag);
+			write_binary(out, std::vector<double>{0, 0, 0, 1, 1, 1});
+			write_binary(out, n_physical_tags);
+			write_binary(out, tag == 1 ? int(11) : int(22));
+			write_binary(out, size_t(1));
+			write_binary(out, int(1));
+		}
+		out << "\n$EndEntities\n";
+
+		// nodes A, B, C on the surface (with u, v) and D, E in the volume, tags 2 4 7 9 12
+		out << "$Nodes\n";
+		write_binary(out, std::vector<size_t>{2, 5, 2, 12});
+		write_binary(out, std::vector<int>{2, 1, 1});
+		write_binary(out, size_t(3));
+		write_binary(out, std::vector<size_t>{2, 4, 7});
+		write_binary(out, std::vector<double>{0, 0, 0, 0.1, 0.2, 1, 0, 0, 0.3, 0.4, 0, 1, 0, 0.5, 0.6});
+		write_binary(out, std::vector<int>{3, 1, 0});
+		write_binary(out, size_t(2));
+		write_binary(out, std::vector<size_t>{9, 12});
+		write_binary(out, std::vector<double>{0, 0, 1, 1, 1, 1});
+		out << "\n$EndNodes\n";
+
+		// a boundary triangle (ignored) and one tet per volume
+		out << "$Elements\n";
+		write_binary(out, std::vector<size_t>{3, 3, 1, 3});
+		write_binary(out, std::vector<int>{2, 1, 2});
+		write_binary(out, size_t(1));
+		write_binary(out, std::vector<size_t>{1, 2, 4, 7});
+		write_binary(out, std::vector<int>{3, 1, 4});
+		write_binary(out, size_t(1));
+		write_binary(out, std::vector<size_t>{2, 2, 4, 7, 9});
+		write_binary(out, std::vector<int>{3, 2, 4});
+		write_binary(out, size_t(1));
+		write_binary(out, std::vector<size_t>{3, 4, 7, 9, 12});
+		out << "\n$EndElements\n";
+	}
+} // namespace
+
+TEST_CASE("mshreader_binary_tets", "[utils]")
+{
+	const std::filesystem::path path = std::filesystem::current_path() / "DELETE_ME_binary_tets.msh";
+	write_binary_tets(path);
+
+	Eigen::MatrixXd vertices;
+	Eigen::MatrixXi cells;
+	std::vector<std::vector<int>> elements;
+	std::vector<std::vector<double>> weights;
+	std::vector<int> body_ids;
+	REQUIRE(MshReader::load_binary_msh41(path.string(), false, vertices, cells, elements, weights, body_ids));
+
+	Eigen::MatrixXd expected_vertices(5, 3);
+	expected_vertices << 0, 0, 0,
+		1, 0, 0,
+		0, 1, 0,
+		0, 0, 1,
+		1, 1, 1;
+	Eigen::MatrixXi expected_cells(2, 4);
+	expected_cells << 0, 1, 2, 3,
+		1, 2, 3, 4;
+
+	CHECK(vertices == expected_vertices);
+	CHECK(cells == expected_cells);
+	CHECK(elements == std::vector<std::vector<int>>{{0, 1, 2, 3}, {1, 2, 3, 4}});
+	CHECK(body_ids == std::vector<int>{11, 22});
+
+	// the same result through the public entry point
+	Eigen::MatrixXd loaded_vertices;
+	Eigen::MatrixXi loaded_cells;
+	REQUIRE(MshReader::load(path.string(), loaded_vertices, loaded_cells, elements, weights, body_ids));
+	CHECK(loaded_vertices == expected_vertices);
+	CHECK(loaded_cells == expected_cells);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("mshreader_binary_corrupt", "[utils]")
+{
+	const std::filesystem::path path = std::filesystem::current_path() / "DELETE_ME_binary_corrupt.msh";
+
+	Eigen::MatrixXd vertices;
+	Eigen::MatrixXi cells;
+	std::vector<std::vector<int>> elements;
+	std::vector<std::vector<double>> weights;
+	std::vector<int> body_ids;
+
+	SECTION("Corrupt count")
+	{
+		// the count is read before the data, it must not be used to size a buffer
+		write_binary_tets(path, size_t(1) << 60);
+		bool loaded = true;
+		CHECK_NOTHROW(loaded = MshReader::load_binary_msh41(path.string(), false, vertices, cells, elements, weights, body_ids));
+		CHECK(!loaded);
+	}
+
+	SECTION("Truncated")
+	{
+		write_binary_tets(path);
+		// the reader stops after the element data, the end marker of the last section is not needed
+		const uintmax_t size = std::filesystem::file_size(path) - std::string("\n$EndElements\n").size();
+		for (uintmax_t truncated_size = size; truncated_size-- > 0;)
+		{
+			std::filesystem::resize_file(path, truncated_size);
+			bool loaded = true;
+			CAPTURE(truncated_size);
+			CHECK_NOTHROW(loaded = MshReader::load_binary_msh41(path.string(), false, vertices, cells, elements, weights, body_ids));
+			CHECK(!loaded);
+		}
+	}
+
+	std::filesystem::remove(path);
+}
+
 TEST_CASE("inverse", "[utils]")
 {
 	Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3> mat = Eigen::MatrixXd::Random(1, 1);